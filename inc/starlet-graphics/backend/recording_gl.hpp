@@ -0,0 +1,92 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <initializer_list>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace Starlet::Graphics {
+	struct GLCommand {
+		std::string name;
+		std::vector<int64_t> args;  // Enums, names, sizes and offsets in call order
+		std::vector<float> values;  // Float arguments and uniform payloads
+
+		std::string toString() const;
+	};
+
+	struct FrameBenchResult {
+		uint32_t frames{ 0 };
+		double meanMs{ 0.0 }, minMs{ 0.0 }, maxMs{ 0.0 };
+		double callsPerFrame{ 0.0 };
+		double drawsPerFrame{ 0.0 };
+	};
+
+	// Replaces the glad entry points used by the library with recorders so renderers run without a context.
+	// Generated names are sequential, status queries succeed and mapped buffers are backed by host memory.
+	// With recording off it acts as a null backend that only counts calls and allocates nothing per call.
+	class RecordingGL {
+	public:
+		RecordingGL() = default;
+		~RecordingGL() { uninstall(); }
+
+		RecordingGL(const RecordingGL&) = delete;
+		RecordingGL& operator=(const RecordingGL&) = delete;
+
+		bool install();
+		void uninstall();
+		bool isInstalled() const { return active == this; }
+
+		void setRecording(const bool enabled) { recording = enabled; }
+		bool isRecording() const { return recording; }
+		// Without values only names and integer arguments are kept, for goldens that must not depend on float math
+		void setCaptureValues(const bool enabled) { captureValues = enabled; }
+
+		// Results returned by the fake queries
+		void setInteger(const unsigned int pname, const int value) { integers[pname] = value; }
+		void setBuildStatus(const bool compiled, const bool linked, const bool completed = true);
+		// Reported through GL_NUM_EXTENSIONS and glGetStringi
+		void addExtension(const std::string& name);
+
+		void clear();
+		const std::vector<GLCommand>& getCommands() const { return commands; }
+		size_t getCallCount() const { return totalCalls; }
+		size_t getCallCount(const std::string& name) const;
+		size_t getDrawCount() const { return drawCalls; }
+
+		// One command per line, stable across runs for golden comparisons
+		std::string dump() const;
+		bool matchesGolden(const std::string& path, const bool update = false) const;
+
+		FrameBenchResult benchmark(const std::function<void()>& frame, const uint32_t frames);
+
+	private:
+		friend struct RecordingGLHooks;
+
+		void push(const char* name, std::initializer_list<int64_t> args, const float* values = nullptr, const size_t valueCount = 0);
+		void push(const char* name, std::initializer_list<int64_t> args, std::initializer_list<float> values) { push(name, args, values.begin(), values.size()); }
+		unsigned int nextName() { return ++lastName; }
+
+		static RecordingGL* active;
+
+		bool recording{ true };
+		bool captureValues{ true };
+		std::vector<GLCommand> commands;
+		std::map<std::string, size_t> callCounts;
+		size_t totalCalls{ 0 };
+		size_t drawCalls{ 0 };
+
+		unsigned int lastName{ 0 };
+		std::map<unsigned int, int> integers;
+		std::map<std::string, int> uniformLocations;
+		std::vector<std::string> extensions;
+		std::map<unsigned int, unsigned int> boundBuffers;
+		std::map<unsigned int, std::vector<unsigned char>> bufferStorage;
+		bool compileStatus{ true }, linkStatus{ true }, completionStatus{ true };
+
+		struct SavedEntryPoints;
+		SavedEntryPoints* saved{ nullptr };
+	};
+}
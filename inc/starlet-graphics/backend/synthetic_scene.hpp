@@ -0,0 +1,23 @@
+#pragma once
+
+#include <cstdint>
+
+namespace Starlet::Graphics {
+	class ResourceManager;
+	struct RenderWorld;
+
+	struct SyntheticSceneSettings {
+		uint32_t models{ 1000 };
+		uint32_t lights{ 32 };
+		uint32_t textures{ 16 };
+		uint32_t textureSize{ 64 };     // Side of each generated RGBA checker texture
+		float transparentFraction{ 0.1f };
+		float spacing{ 3.0f };          // Between neighbouring models on the grid
+		uint32_t seed{ 1 };
+	};
+
+	// Fills a RenderWorld for benchmarks and headless tests without any asset files: a grid of generated cubes in front
+	// of a camera at the origin looking down -z, point lights scattered through the grid and checker textures spread
+	// over the models. The same settings always build the same world.
+	bool buildSyntheticScene(ResourceManager& resources, const SyntheticSceneSettings& settings, RenderWorld& world);
+}
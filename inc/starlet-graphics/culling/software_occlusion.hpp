@@ -0,0 +1,85 @@
+#pragma once
+
+#include "starlet-graphics/renderer/camera_view.hpp"
+
+#include "starlet-math/vec3.hpp"
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace Starlet {
+	namespace Math {
+		struct Mat4;
+	}
+
+	namespace Graphics {
+		class JobSystem;
+
+		struct OcclusionStats {
+			uint32_t occluders{ 0 };
+			uint32_t occluderTriangles{ 0 }; // After near clipping, before the screen rejects
+		};
+
+		// CPU depth buffer for occlusion culling, no GL involved.
+		// Occluder meshes are registered once with simplified geometry (walls, floors, large props), each frame their
+		// instances are near-clipped, binned into TILE_SIZE tiles and rasterised a tile per job into a small buffer of 1/z.
+		// Occluders are rasterised conservatively: across silhouette edges only pixels they fully cover are written, edges
+		// shared inside a mesh (and fan diagonals from clipping) keep centre sampling so a quad has no seam, and every pixel
+		// stores the farthest depth of the plane within it.
+		// isVisible() then tests a model-space box: hidden only when every pixel it touches has an occluder in front of its
+		// nearest corner. Rows are written for auto-vectorisation rather than with intrinsics so it builds on every target.
+		class SoftwareOcclusion {
+		public:
+			static constexpr uint32_t TILE_SIZE{ 32 };
+
+			void setResolution(const uint32_t width, const uint32_t height);
+			uint32_t getWidth() const { return width; }
+			uint32_t getHeight() const { return height; }
+
+			void setOccluderMesh(const uint32_t meshId, const std::vector<Math::Vec3<float>>& positions, const std::vector<uint32_t>& indices);
+			bool hasOccluderMesh(const uint32_t meshId) const { return occluderMeshes.find(meshId) != occluderMeshes.end(); }
+			void removeOccluderMesh(const uint32_t meshId) { occluderMeshes.erase(meshId); }
+
+			void beginFrame(const ViewFrustum& frustum);
+			void addOccluder(const uint32_t meshId, const Math::Mat4& model);
+			void rasterize(JobSystem* jobs);
+
+			// Thread safe once rasterize() returned
+			bool isVisible(const Math::Vec3<float>& boundsMin, const Math::Vec3<float>& boundsMax, const Math::Mat4& model) const;
+
+			// Row major from the bottom row, 0 where nothing was drawn
+			const std::vector<float>& getDepth() const { return depth; }
+			const OcclusionStats& getStats() const { return stats; }
+
+		private:
+			struct OccluderMesh {
+				std::vector<Math::Vec3<float>> positions;
+				std::vector<uint32_t> indices;
+				std::vector<uint8_t> silhouette; // Per triangle, bit i set when the edge opposite corner i is not shared
+			};
+			struct ScreenTriangle {
+				float x[3], y[3];
+				float invZ[3];
+				uint8_t silhouette;
+			};
+
+			void project(const Math::Vec3<float>& view, float& x, float& y) const;
+			void addTriangle(const Math::Vec3<float>& a, const Math::Vec3<float>& b, const Math::Vec3<float>& c, const uint8_t silhouette);
+			void binTriangle(const ScreenTriangle& triangle);
+			void rasterizeTile(const uint32_t tile);
+
+			uint32_t width{ 256 }, height{ 128 };
+			uint32_t tilesX{ 8 }, tilesY{ 4 };
+
+			std::unordered_map<uint32_t, OccluderMesh> occluderMeshes;
+			ViewFrustum frustum;
+			std::vector<Math::Vec3<float>> viewPositions; // Scratch for addOccluder, kept so steady frames do not allocate
+			std::vector<ScreenTriangle> triangles;
+			std::vector<std::vector<uint32_t>> tileTriangles;
+			std::vector<float> depth;
+
+			OcclusionStats stats;
+		};
+	}
+}
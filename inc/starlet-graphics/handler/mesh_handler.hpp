@@ -1,13 +1,38 @@
 #pragma once
 
 #include "starlet-graphics/handler/resource_handler.hpp"
+#include "starlet-graphics/streaming/staging_ring.hpp"
 
 namespace Starlet::Graphics {
 	struct MeshCPU;
 	struct MeshGPU;
+	class StagingUploader;
 
 	struct MeshHandler : public ResourceHandler<MeshCPU, MeshGPU> {
+		// Geometry copied into the staging ring ahead of upload, invalid allocations did not fit
+		struct StagedMesh {
+			StagingAllocation vertices, indices;
+		};
+
 		bool upload(MeshCPU& cpu, MeshGPU& gpu) override;
+		bool upload(MeshCPU& cpu, MeshGPU& gpu, StagingUploader& staging);
+		// Creates the buffers on the GL thread for geometry staged beforehand, anything not staged is copied from cpu
+		bool upload(MeshCPU& cpu, MeshGPU& gpu, StagingUploader& staging, const StagedMesh& staged);
+		// Makes no GL calls so loader threads can copy geometry into the ring while the GL thread keeps rendering
+		static void stage(const MeshCPU& cpu, StagingUploader& staging, StagedMesh& out);
+		// Buffers and VAOs sized for layout's counts with no data, filled afterwards a chunk at a time
+		bool allocate(const MeshCPU& layout, MeshGPU& gpu);
 		void unload(MeshGPU& gpu) override;
+
+		// Uploads clear the CPU geometry unless it is kept for the caller
+		void setKeepGeometry(const bool keep) { keepGeometry = keep; }
+
+	private:
+		bool createBuffers(MeshCPU& cpu, MeshGPU& gpu, StagingUploader* staging, const StagedMesh& staged);
+		static void cancel(StagingUploader* staging, const StagedMesh& staged);
+		static void setVertexAttributes();
+		static void createDepthArray(MeshGPU& gpu);
+
+		bool keepGeometry{ false };
 	};
 }
\ No newline at end of file
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+namespace Starlet::Graphics {
+	struct ShaderCPU;
+
+	struct ProgramCacheStats {
+		uint32_t hits{ 0 };
+		uint32_t misses{ 0 };
+		uint32_t rejected{ 0 }; // Misses where a binary existed but was malformed or refused by the driver
+		uint32_t stored{ 0 };
+	};
+
+	// On-disk cache of linked program binaries keyed by shader sources, defines and the driver identity.
+	class ProgramCache {
+	public:
+		void setDirectory(const std::string& path);
+		const std::string& getDirectory() const { return directory; }
+		bool isEnabled() const { return !directory.empty() && supported; }
+
+		uint64_t makeKey(const ShaderCPU& cpu);
+		bool load(const uint64_t key, unsigned int& programOut);
+		bool store(const uint64_t key, const unsigned int program);
+
+		const ProgramCacheStats& getStats() const { return stats; }
+
+	private:
+		std::string pathFor(const uint64_t key) const;
+		const std::string& getDriverID();
+
+		std::string directory;
+		std::string driverID;
+		bool supported{ true };
+		ProgramCacheStats stats;
+	};
+}
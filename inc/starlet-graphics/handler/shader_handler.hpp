@@ -7,13 +7,30 @@
 namespace Starlet::Graphics {
 	struct ShaderCPU;
 	struct ShaderGPU;
+	class ProgramCache;
 
 	struct ShaderHandler : public ResourceHandler<ShaderCPU, ShaderGPU> {
 		bool upload(ShaderCPU& cpu, ShaderGPU& gpu) override;
 		void unload(ShaderGPU& shader) override;
 
+		void setProgramCache(ProgramCache* cache) { programCache = cache; }
+
+		// Two phase path: submit() queues compile + link without querying status, finish() collects it.
+		// With KHR_parallel_shader_compile isComplete() polls without blocking, otherwise it always reports done.
+		bool detectParallelCompile();
+		bool hasParallelCompile() const { return parallelCompile; }
+
+		bool submit(ShaderCPU& cpu, ShaderGPU& gpu);
+		bool isComplete(const ShaderGPU& gpu) const;
+		bool finish(ShaderCPU& cpu, ShaderGPU& gpu);
+
 	private:
 		bool linkProgram(unsigned int& outProgramID, unsigned int vertID, unsigned int fragID);
 		bool compileShader(unsigned int& outShaderID, int glShaderType, const std::string& source);
+		bool checkShader(unsigned int& shaderID, int glShaderType);
+		bool checkProgram(unsigned int& programID);
+
+		ProgramCache* programCache{ nullptr };
+		bool parallelCompile{ false };
 	};
 }
\ No newline at end of file
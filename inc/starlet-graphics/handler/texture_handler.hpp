@@ -1,14 +1,30 @@
 #pragma once
 
 #include "starlet-graphics/handler/resource_handler.hpp"
+#include "starlet-graphics/streaming/staging_ring.hpp"
+
+#include <cstdint>
 
 namespace Starlet::Graphics {
 	struct TextureCPU;
 	struct TextureGPU;
+	class StagingUploader;
 
 	struct TextureHandler : public ResourceHandler<TextureCPU, TextureGPU> {
+		// Pixels copied into the staging ring ahead of upload
+		struct StagedTexture {
+			StagingAllocation allocation;
+			int width{ 0 }, height{ 0 };
+			uint8_t pixelSize{ 0 };
+		};
+
 		bool upload(TextureCPU& cpu, TextureGPU& gpu) override;
 		bool upload(TextureCPU& cpu, TextureGPU& gpu, bool generateMIPMap);
+		bool upload(TextureCPU& cpu, TextureGPU& gpu, bool generateMIPMap, StagingUploader& staging);
+		// Creates the texture storage on the GL thread and queues the copy of pixels staged beforehand
+		bool upload(const StagedTexture& staged, TextureGPU& gpu, bool generateMIPMap, StagingUploader& staging);
+		// Makes no GL calls so loader threads can stage decoded pixels, frees them on success and is false when the ring is full
+		static bool stage(TextureCPU& cpu, StagingUploader& staging, StagedTexture& out);
 
 		bool upload(TextureCPU(&faces)[6], TextureGPU& cubeOut);
 		bool upload(TextureCPU(&faces)[6], TextureGPU& cubeOut, bool generateMIPMap);
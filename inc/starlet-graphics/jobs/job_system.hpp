@@ -0,0 +1,104 @@
+#pragma once
+
+#include "starlet-graphics/jobs/mpmc_queue.hpp"
+#include "starlet-graphics/jobs/work_stealing_deque.hpp"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Starlet::Graphics {
+	struct Job;
+	using JobFunction = void(*)(const Job& job);
+
+	struct Job {
+		JobFunction function{ nullptr };
+		const void* data{ nullptr };
+		uint32_t begin{ 0 }, end{ 0 };
+		struct JobCounter* counter{ nullptr };
+	};
+
+	// Jobs still outstanding against a counter, waiting on it is how dependencies are expressed
+	struct JobCounter {
+		std::atomic<uint32_t> pending{ 0 };
+		bool isDone() const { return pending.load(std::memory_order_acquire) == 0; }
+	};
+
+	struct JobBenchResult {
+		unsigned int workers{ 0 };
+		uint32_t jobs{ 0 }, iterations{ 0 };
+		double serialMs{ 0.0 }, parallelMs{ 0.0 }; // Best of the iterations
+		double speedup{ 0.0 };
+		double jobsPerSecond{ 0.0 };
+	};
+
+	// Work-stealing scheduler: one Chase-Lev deque of jobs by value per worker, idle workers steal from the others.
+	// The thread calling init() becomes worker 0 and only runs jobs while it waits. Threads that are not
+	// workers submit through a bounded lock-free queue. Without init() every job runs inline on the submitting thread,
+	// as does a job submitted while its queue is full.
+	class JobSystem {
+	public:
+		static constexpr size_t MAX_JOBS_PER_WORKER{ 4096 };
+		static constexpr size_t MAX_INJECTED_JOBS{ 4096 };
+
+		JobSystem() = default;
+		~JobSystem() { shutdown(); }
+
+		JobSystem(const JobSystem&) = delete;
+		JobSystem& operator=(const JobSystem&) = delete;
+
+		bool init(unsigned int workerCount = 0);
+		void shutdown();
+		bool isRunning() const { return !workers.empty(); }
+		unsigned int getWorkerCount() const { return isRunning() ? static_cast<unsigned int>(workers.size()) : 1u; }
+
+		void run(const JobFunction function, const void* data, const uint32_t begin, const uint32_t end, JobCounter& counter);
+		void wait(JobCounter& counter);
+
+		// Splits [0, count) into ranges of at most grain and calls fn(begin, end) for each, returns when all are done
+		template <typename Function>
+		void parallelFor(const uint32_t count, const uint32_t grain, const Function& fn) {
+			if (count == 0) return;
+
+			const uint32_t step = grain ? grain : 1;
+			if (!isRunning() || count <= step) {
+				fn(0u, count);
+				return;
+			}
+
+			JobCounter counter;
+			for (uint32_t begin = 0; begin < count; begin += step) {
+				const uint32_t end = (count - begin > step) ? begin + step : count;
+				run([](const Job& job) { (*static_cast<const Function*>(job.data))(job.begin, job.end); }, &fn, begin, end, counter);
+			}
+			wait(counter);
+		}
+
+		// Runs jobCount jobs of fixed busy work inline and then through parallelFor, keeping the best time of each
+		JobBenchResult benchmark(const uint32_t jobCount, const uint32_t iterations);
+
+	private:
+		struct Worker {
+			WorkStealingDeque<Job, MAX_JOBS_PER_WORKER> deque;
+			std::thread thread;
+		};
+
+		int currentWorker() const;
+		bool tryRunOne(const int self);
+		void workerLoop(const int index);
+		static void execute(const Job job);
+
+		std::vector<std::unique_ptr<Worker>> workers;
+		std::atomic<bool> stopping{ false };
+
+		BoundedMpmcQueue<Job, MAX_INJECTED_JOBS> injected;
+
+		std::mutex sleepMutex;
+		std::condition_variable wake;
+		std::atomic<uint32_t> sleeping{ 0 };
+	};
+}
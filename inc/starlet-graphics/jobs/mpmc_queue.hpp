@@ -0,0 +1,71 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace Starlet::Graphics {
+	// Fixed capacity multi-producer multi-consumer ring (Vyukov). Each cell carries a sequence number that tells a
+	// producer the cell is free for its ticket and a consumer that the item for its ticket has been written.
+	// Capacity must be a power of two, push fails when full rather than growing or blocking.
+	template <typename T, size_t Capacity>
+	class BoundedMpmcQueue {
+		static_assert((Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+	public:
+		BoundedMpmcQueue() {
+			for (size_t i = 0; i < Capacity; ++i) cells[i].sequence.store(i, std::memory_order_relaxed);
+		}
+
+		BoundedMpmcQueue(const BoundedMpmcQueue&) = delete;
+		BoundedMpmcQueue& operator=(const BoundedMpmcQueue&) = delete;
+
+		bool push(const T& item) {
+			size_t position = tail.load(std::memory_order_relaxed);
+			for (;;) {
+				Cell& cell = cells[position & MASK];
+				const size_t sequence = cell.sequence.load(std::memory_order_acquire);
+				const intptr_t diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position);
+				if (diff == 0) {
+					if (tail.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+						cell.item = item;
+						cell.sequence.store(position + 1, std::memory_order_release);
+						return true;
+					}
+				}
+				else if (diff < 0) return false;
+				else position = tail.load(std::memory_order_relaxed);
+			}
+		}
+
+		bool pop(T& out) {
+			size_t position = head.load(std::memory_order_relaxed);
+			for (;;) {
+				Cell& cell = cells[position & MASK];
+				const size_t sequence = cell.sequence.load(std::memory_order_acquire);
+				const intptr_t diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position + 1);
+				if (diff == 0) {
+					if (head.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+						out = cell.item;
+						cell.sequence.store(position + Capacity, std::memory_order_release);
+						return true;
+					}
+				}
+				else if (diff < 0) return false;
+				else position = head.load(std::memory_order_relaxed);
+			}
+		}
+
+	private:
+		static constexpr size_t MASK{ Capacity - 1 };
+
+		struct Cell {
+			std::atomic<size_t> sequence{ 0 };
+			T item{};
+		};
+
+		alignas(64) std::atomic<size_t> tail{ 0 };
+		alignas(64) std::atomic<size_t> head{ 0 };
+		Cell cells[Capacity];
+	};
+}
@@ -0,0 +1,90 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+namespace Starlet::Graphics {
+	// Fixed capacity Chase-Lev deque. The owning thread pushes and pops at the bottom, any thread steals from the top.
+	// Capacity must be a power of two, push fails when full rather than growing.
+	// Items are stored by value as relaxed atomic words: a thief may read a slot the owner is refilling, but then its
+	// claim on top fails and the torn copy is dropped, so nothing outside the deque is ever shared with a thief.
+	template <typename T, size_t Capacity>
+	class WorkStealingDeque {
+		static_assert((Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+		static_assert(std::is_trivially_copyable_v<T>, "Items are copied word by word");
+
+	public:
+		bool push(const T& item) {
+			const int64_t b = bottom.load(std::memory_order_relaxed);
+			const int64_t t = top.load(std::memory_order_acquire);
+			if (b - t >= static_cast<int64_t>(Capacity)) return false;
+
+			store(static_cast<size_t>(b) & MASK, item);
+			bottom.store(b + 1, std::memory_order_release);
+			return true;
+		}
+
+		bool pop(T& out) {
+			const int64_t b = bottom.load(std::memory_order_relaxed) - 1;
+			bottom.store(b, std::memory_order_seq_cst);
+			int64_t t = top.load(std::memory_order_seq_cst);
+
+			if (t > b) {
+				bottom.store(b + 1, std::memory_order_relaxed);
+				return false;
+			}
+
+			out = load(static_cast<size_t>(b) & MASK);
+			if (t != b) return true;
+
+			// Last item, race any thief for it
+			const bool won = top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+			bottom.store(b + 1, std::memory_order_relaxed);
+			return won;
+		}
+
+		bool steal(T& out) {
+			int64_t t = top.load(std::memory_order_seq_cst);
+			const int64_t b = bottom.load(std::memory_order_seq_cst);
+			if (t >= b) return false;
+
+			out = load(static_cast<size_t>(t) & MASK);
+			return top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+		}
+
+		size_t size() const {
+			const int64_t b = bottom.load(std::memory_order_relaxed);
+			const int64_t t = top.load(std::memory_order_relaxed);
+			return b > t ? static_cast<size_t>(b - t) : 0;
+		}
+
+	private:
+		static constexpr size_t MASK{ Capacity - 1 };
+		static constexpr size_t WORDS{ (sizeof(T) + sizeof(uint64_t) - 1) / sizeof(uint64_t) };
+
+		struct Slot {
+			std::atomic<uint64_t> words[WORDS]{};
+		};
+
+		void store(const size_t index, const T& item) {
+			uint64_t words[WORDS]{};
+			std::memcpy(words, &item, sizeof(T));
+			for (size_t i = 0; i < WORDS; ++i) items[index].words[i].store(words[i], std::memory_order_relaxed);
+		}
+
+		T load(const size_t index) const {
+			uint64_t words[WORDS];
+			for (size_t i = 0; i < WORDS; ++i) words[i] = items[index].words[i].load(std::memory_order_relaxed);
+			T item;
+			std::memcpy(&item, words, sizeof(T));
+			return item;
+		}
+
+		alignas(64) std::atomic<int64_t> top{ 0 };
+		alignas(64) std::atomic<int64_t> bottom{ 0 };
+		Slot items[Capacity]{};
+	};
+}
@@ -0,0 +1,32 @@
+#pragma once
+
+#include "starlet-math/vertex.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Starlet::Graphics {
+	struct MeshCPU;
+
+	struct MeshLodSettings {
+		uint32_t maxLods{ 0 };       // Levels generated below the full mesh, 0 turns generation off
+		float reduction{ 0.5f };     // Target triangle ratio between consecutive levels
+		uint32_t minTriangles{ 64 }; // No level is generated below this many triangles
+		float maxError{ 0.05f };     // Relative to the bounding radius, costlier collapses are rejected
+	};
+
+	// Quadric error metric simplification by half-edge collapse: a vertex merges into a neighbour, so every level
+	// indexes the original vertex array and the chain shares one vertex buffer. Mesh borders and attribute seams
+	// (vertices sharing a position) are locked, collapses that would flip a triangle are rejected.
+	class MeshSimplifier {
+	public:
+		// Writes a triangle list of at most targetIndices indices to out, fewer collapses are made if maxError is hit first.
+		// Returns the largest accepted error relative to radius.
+		static float simplify(const std::vector<Math::Vertex>& vertices, const std::vector<unsigned int>& indices,
+			const size_t targetIndices, const float maxError, const float radius, std::vector<unsigned int>& out);
+
+		// Appends coarser levels to mesh.indices and records every level in mesh.lods, must run before upload
+		static bool buildLodChain(MeshCPU& mesh, const MeshLodSettings& settings);
+	};
+}
@@ -1,18 +1,77 @@
 #pragma once
 
+#include <cstdint>
+
 namespace Starlet::Graphics {
+	struct GLStateStats {
+		uint32_t issued{ 0 };
+		uint32_t skipped{ 0 };
+		uint32_t textureBinds{ 0 };     // Issued glBindTexture calls
+		uint32_t vertexArrayBinds{ 0 }; // Issued glBindVertexArray calls
+	};
+
+	// Shadow copy of the GL state the renderers touch, calls matching the shadow are skipped.
+	// Anything that changes GL state behind its back must call invalidate() before it is used again.
 	class GLStateManager {
 	public:
-		GLStateManager() = default;
+		static constexpr unsigned int MAX_TEXTURE_UNITS{ 32 };
+		static constexpr unsigned int MAX_BUFFER_BINDINGS{ 16 };
+
+		GLStateManager() { invalidate(); }
 
 		bool setProgram(const unsigned int id);
 		unsigned int getProgram() const { return program; }
 
+		void setDepthTest(const bool enabled);
+		void setDepthMask(const bool write);
+		void setDepthFunc(const unsigned int func);
+		void setColourMask(const bool write);
+
+		void setBlend(const bool enabled);
+		void setBlendFunc(const unsigned int src, const unsigned int dst);
+
+		void setCulling(const bool enabled);
+		void setCullFace(const unsigned int face);
+
+		void bindVertexArray(const unsigned int vao);
+		void bindBuffer(const unsigned int target, const unsigned int buffer);
+		// Uniform and shader storage binding points, also updates the target's generic binding like glBindBufferBase does
+		void bindBufferBase(const unsigned int target, const unsigned int index, const unsigned int buffer);
+		void setActiveTexture(const unsigned int unit);
+		void bindTexture(const unsigned int unit, const unsigned int target, const unsigned int texture);
+
 		void toggleWireframe();
 		void setGLStateDefault();
 
+		void invalidate();
+
+		void resetStats() { stats = {}; }
+		const GLStateStats& getStats() const { return stats; }
+
 	private:
+		static constexpr unsigned int UNKNOWN{ 0xFFFFFFFFu };
+		static constexpr unsigned int TEXTURE_TARGETS{ 4 };
+		static constexpr unsigned int BUFFER_TARGETS{ 8 };
+		static constexpr unsigned int INDEXED_BUFFER_TARGETS{ 2 }; // Uniform and shader storage, the first two buffer targets
+
+		bool changed(unsigned int& shadow, const unsigned int value);
+		static int textureTargetIndex(const unsigned int target);
+		static int bufferTargetIndex(const unsigned int target);
+
 		unsigned int program{ 0 };
 		bool wireframe{ false };
+
+		unsigned int depthTest{ UNKNOWN }, depthMask{ UNKNOWN }, depthFunc{ UNKNOWN };
+		unsigned int colourMask{ UNKNOWN };
+		unsigned int blend{ UNKNOWN }, blendSrc{ UNKNOWN }, blendDst{ UNKNOWN };
+		unsigned int culling{ UNKNOWN }, cullFace{ UNKNOWN };
+
+		unsigned int vertexArray{ UNKNOWN };
+		unsigned int activeTexture{ UNKNOWN };
+		unsigned int textures[MAX_TEXTURE_UNITS][TEXTURE_TARGETS];
+		unsigned int buffers[BUFFER_TARGETS];
+		unsigned int indexedBuffers[INDEXED_BUFFER_TARGETS][MAX_BUFFER_BINDINGS];
+
+		GLStateStats stats;
 	};
 }
\ No newline at end of file
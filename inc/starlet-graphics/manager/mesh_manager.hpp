@@ -4,33 +4,101 @@
 #include "starlet-graphics/handler/mesh_handler.hpp"
 #include "starlet-graphics/resource/mesh_cpu.hpp"
 #include "starlet-graphics/resource/mesh_gpu.hpp"
+#include "starlet-graphics/resource/mesh_info.hpp"
+#include "starlet-graphics/lod/mesh_simplifier.hpp"
+#include "starlet-graphics/parser/ply_parser.hpp"
+#include "starlet-graphics/streaming/mesh_stream_uploader.hpp"
+#include "starlet-graphics/picking/mesh_bvh.hpp"
 
 #include "starlet-serializer/parser/mesh_parser.hpp"
 
+#include <cstdint>
 #include <map>
+#include <vector>
 
 namespace Starlet::Graphics {
+	class StagingUploader;
+	class JobSystem;
+
+	// Uploaded meshes live in dense slots, a MeshInfo beside each MeshGPU, and slots are never reused.
+	// Pointers into them stay valid until the next mesh is added.
 	class MeshManager : public Manager {
 	public:
+		static constexpr uint32_t INVALID_SLOT{ UINT32_MAX };
+
 		~MeshManager();
 
-		bool exists(const std::string& name) const override {
-			return pathToCPUMeshes.find(name) != pathToCPUMeshes.end()
-				|| pathToGPUMeshes.find(name) != pathToGPUMeshes.end();
-		}
+		bool exists(const std::string& name) const override { return pathToSlot.find(name) != pathToSlot.end(); }
 
 		bool loadAndAddMesh(const std::string& path);
+		// Parsed, simplified and staged on the load jobs when set so this thread only creates buffers and queues copies
+		bool loadAndAddMeshes(const std::vector<std::string>& paths);
 		bool addMesh(const std::string& path, MeshCPU& mesh);
 
-		MeshCPU* getMeshCPU(const std::string& path);
-		const MeshCPU* getMeshCPU(const std::string& path) const;
+		void setStagingUploader(StagingUploader* uploader) { staging = uploader; }
+		void setLoadJobs(JobSystem* jobs) { loadJobs = jobs; }
+
+		// Meshes added afterwards get a level of detail chain before upload
+		void setLodSettings(const MeshLodSettings& settings) { lodSettings = settings; }
+		const MeshLodSettings& getLodSettings() const { return lodSettings; }
+
+		// .ply files are read by PlyParser, on jobs when given, and fall back to the serializer if it cannot read them
+		void setFastPlyParsing(const bool enabled, JobSystem* jobs = nullptr) { fastPly = enabled; plyJobs = jobs; }
+		const PlyParseStats& getLastPlyStats() const { return plyParser.getLastStats(); }
+
+		// .ply files are streamed into GPU buffers chunkBytes at a time and only their counts and bounds stay on the CPU,
+		// so they get no level of detail chain. Files the stream cannot read load normally.
+		void setStreamingUploads(const bool enabled, const size_t chunkBytes = MeshStreamUploader::DEFAULT_CHUNK_BYTES) { streamUploads = enabled; streamChunkBytes = chunkBytes; }
+		const MeshStreamStats& getLastStreamStats() const { return lastStreamStats; }
+
+		// Meshes added afterwards keep their vertices and indices on the CPU for picking or physics, they are not streamed
+		void setRetainGeometry(const bool enabled) { retainGeometry = enabled; }
+		bool isRetainingGeometry() const { return retainGeometry; }
+
+		// Meshes added afterwards get a triangle BVH for ray picking, built on jobs when given. Streamed meshes get none.
+		void setBuildBvh(const bool enabled, JobSystem* jobs = nullptr, const BvhSettings& settings = {}) { buildBvh = enabled; bvhJobs = jobs; bvhSettings = settings; }
+
+		uint32_t getSlot(const std::string& path) const;
+		size_t getMeshCount() const { return infos.size(); }
+		const MeshInfo* getMeshInfo(const uint32_t slot) const { return slot < infos.size() ? &infos[slot] : nullptr; }
+		const MeshGPU* getMeshGPU(const uint32_t slot) const { return slot < gpuMeshes.size() ? &gpuMeshes[slot] : nullptr; }
+		// Null when the mesh was added without a BVH
+		const MeshBvh* getMeshBvh(const uint32_t slot) const { return slot < bvhs.size() && bvhs[slot].isBuilt() ? &bvhs[slot] : nullptr; }
+
+		const MeshInfo* getMeshInfo(const std::string& path) const;
 		MeshGPU* getMeshGPU(const std::string& path);
 		const MeshGPU* getMeshGPU(const std::string& path) const;
+		// Null unless the mesh was added while retaining geometry
+		MeshCPU* getMeshCPU(const std::string& path);
+		const MeshCPU* getMeshCPU(const std::string& path) const;
 
 	private:
+		bool parseMesh(const std::string& path, MeshCPU& mesh, Serializer::MeshParser& meshParser, PlyParser& ply, JobSystem* jobs) const;
+		bool streamMesh(const std::string& path);
+		bool uploadAndStore(const std::string& path, MeshCPU& mesh);
+		bool uploadAndStore(const std::string& path, MeshCPU& mesh, MeshBvh&& bvh, const MeshHandler::StagedMesh& staged);
+		void store(const std::string& path, MeshCPU& mesh, MeshGPU& gpu, MeshBvh&& bvh = {});
+
 		Serializer::MeshParser parser;
+		PlyParser plyParser;
+		JobSystem* plyJobs{ nullptr };
+		bool fastPly{ false };
+		bool streamUploads{ false };
+		size_t streamChunkBytes{ MeshStreamUploader::DEFAULT_CHUNK_BYTES };
+		MeshStreamStats lastStreamStats;
 		MeshHandler handler;
-		std::map<std::string, MeshCPU> pathToCPUMeshes;
-		std::map<std::string, MeshGPU> pathToGPUMeshes;
+		StagingUploader* staging{ nullptr };
+		JobSystem* loadJobs{ nullptr };
+		MeshLodSettings lodSettings;
+		bool retainGeometry{ false };
+		bool buildBvh{ false };
+		JobSystem* bvhJobs{ nullptr };
+		BvhSettings bvhSettings;
+
+		std::map<std::string, uint32_t> pathToSlot;
+		std::vector<MeshInfo> infos;
+		std::vector<MeshGPU> gpuMeshes;
+		std::vector<MeshBvh> bvhs;
+		std::map<std::string, MeshCPU> retainedMeshes;
 	};
 }
\ No newline at end of file
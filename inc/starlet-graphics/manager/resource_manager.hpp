@@ -5,8 +5,10 @@
 #include "starlet-graphics/manager/texture_manager.hpp"
 
 #include "starlet-graphics/resource/resource_handle.hpp"
+#include "starlet-graphics/streaming/staging_uploader.hpp"
 
 #include <unordered_map>
+#include <vector>
 #include <cstdint>
 #include <string>
 
@@ -14,6 +16,9 @@ namespace Starlet {
 	namespace Scene {
 		struct Model;
 		struct TextureData;
+		struct Primitive;
+		struct TransformComponent;
+		struct ColourComponent;
 
 		struct MeshGPU;
 		struct MeshCPU;
@@ -23,6 +28,10 @@ namespace Starlet {
 	}
 
 	namespace Graphics {
+		class JobSystem;
+		class GLStateManager;
+		struct TextureCPU;
+
 		class ResourceManager {
 		public:
 			ResourceManager();
@@ -31,19 +40,45 @@ namespace Starlet {
 			void setBasePath(const std::string& path);
 
 			ResourceHandle addMesh(const std::string& path);
+			// Generates the primitive's mesh under primitive.name, sized by the transform and tinted by the colour
+			ResourceHandle addPrimitiveMesh(const Scene::Primitive& primitive, const Scene::TransformComponent& transform, const Scene::ColourComponent& colour);
 			bool hasMesh(const std::string& path) const;
 			bool hasMesh(ResourceHandle handle) const;
 			ResourceHandle getMeshHandle(const std::string& path) const;
 
 			ResourceHandle addTexture(const std::string& name, unsigned int textureID);
+			// Uploads pixels that are already in memory and registers them under name
+			ResourceHandle addTexture(const std::string& name, TextureCPU& cpu);
 			bool hasTexture(const std::string& name) const;
 			bool hasTexture(ResourceHandle handle) const;
 			ResourceHandle getTextureHandle(const std::string& name) const;
 
+			void setTextureStreaming(const bool enabled, const StreamingBudget& budget = {});
+			const StreamingStats& getTextureStreamingStats() const { return textureManager.getStreamingStats(); }
+			void markTextureUsed(const unsigned int textureID) { textureManager.markTextureUsed(textureID); }
+			void updateTextureStreaming(GLStateManager& state) { textureManager.updateStreaming(state); }
+
+			void setMeshLodSettings(const MeshLodSettings& settings) { meshManager.setLodSettings(settings); }
+			void setFastPlyParsing(const bool enabled, JobSystem* jobs = nullptr) { meshManager.setFastPlyParsing(enabled, jobs); }
+			const PlyParseStats& getLastPlyStats() const { return meshManager.getLastPlyStats(); }
+			void setStreamingMeshUploads(const bool enabled, const size_t chunkBytes = MeshStreamUploader::DEFAULT_CHUNK_BYTES) { meshManager.setStreamingUploads(enabled, chunkBytes); }
+			const MeshStreamStats& getLastMeshStreamStats() const { return meshManager.getLastStreamStats(); }
+			void setRetainMeshGeometry(const bool enabled) { meshManager.setRetainGeometry(enabled); }
+			void setMeshBvhBuild(const bool enabled, JobSystem* jobs = nullptr, const BvhSettings& settings = {}) { meshManager.setBuildBvh(enabled, jobs, settings); }
+
+			bool enableStagedUploads(const uint64_t capacity);
+			void flushUploads() { staging.flush(); }
+			// loadMeshes and loadTextures decode and stage on these jobs, leaving GL object creation and copies to this thread
+			void setLoadJobs(JobSystem* jobs) { meshManager.setLoadJobs(jobs); textureManager.setLoadJobs(jobs); }
 
 
+			// Indexed through the handle's slot, no string lookups once the mesh is loaded
+			const MeshInfo* getMeshInfo(ResourceHandle handle) const;
 			const MeshGPU* getMeshGPU(ResourceHandle handle) const;
+			// Null unless the mesh was loaded with setRetainMeshGeometry on
 			const MeshCPU* getMeshCPU(ResourceHandle handle) const;
+			// Null unless the mesh was loaded with setMeshBvhBuild on
+			const MeshBvh* getMeshBvh(ResourceHandle handle) const;
 
 			unsigned int getTextureID(ResourceHandle handle) const;
 
@@ -58,6 +93,7 @@ namespace Starlet {
 			uint32_t nextMeshId = 1;
 			std::unordered_map<uint32_t, std::string> meshHandleToPath;
 			std::unordered_map<std::string, ResourceHandle> meshPathToHandle;
+			std::vector<uint32_t> meshSlots; // MeshManager slot per handle id, INVALID_SLOT until the mesh is loaded
 
 			uint32_t nextTextureId = 1;
 			std::unordered_map<uint32_t, std::string> textureHandleToName;
@@ -68,6 +104,7 @@ namespace Starlet {
 			MeshManager meshManager;
 			MeshFactory meshFactory;
 			TextureManager textureManager;
+			StagingUploader staging;
 		};
 	}
 }
\ No newline at end of file
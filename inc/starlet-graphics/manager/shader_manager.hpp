@@ -3,11 +3,30 @@
 #include "starlet-graphics/manager/manager.hpp"
 
 #include "starlet-graphics/resource/shader_gpu.hpp"
+#include "starlet-graphics/resource/shader_cpu.hpp"
 #include "starlet-graphics/handler/shader_handler.hpp"
+#include "starlet-graphics/handler/program_cache.hpp"
 #include "starlet-serializer/parser/parser.hpp"
 #include <map>
+#include <set>
+#include <unordered_map>
+#include <vector>
 
 namespace Starlet::Graphics {
+	// One field of a variant mask. Single bit fields inject "#define NAME" when set,
+	// wider fields always inject "#define NAME <value>".
+	struct VariantDefine {
+		std::string name;
+		uint32_t bitCount{ 1 };
+	};
+
+	enum class ProgramState {
+		Missing,
+		Pending,
+		Ready,
+		Failed
+	};
+
 	class ShaderManager : public Manager {
 	public:
 		~ShaderManager();
@@ -17,14 +36,67 @@ namespace Starlet::Graphics {
 		}
 
 		bool createProgramFromPaths(const std::string& name, const std::string& vertPath, const std::string& fragPath);
+		bool createProgramFromSources(const std::string& name, const std::string& vertSource, const std::string& fragSource);
+
+		// Batch compilation: submit every program first, then poll or finish them so the driver can overlap the work.
+		// A pending program reports id 0 until it becomes Ready.
+		bool enableParallelCompile() { return handler.detectParallelCompile(); }
+		bool submitProgramFromPaths(const std::string& name, const std::string& vertPath, const std::string& fragPath);
+		ProgramState pollProgram(const std::string& name);
+		size_t pollPendingPrograms();
+		bool finishPendingPrograms();
+		size_t getPendingCount() const { return nameToPending.size(); }
+
+		bool createVariantProgram(const std::string& name, const std::string& vertPath, const std::string& fragPath, const std::vector<VariantDefine>& defines);
+		bool hasVariantProgram(const std::string& name) const { return nameToVariants.find(name) != nameToVariants.end(); }
+		unsigned int getVariantProgramID(const std::string& name, const uint32_t mask);
+		size_t getVariantCount(const std::string& name) const;
+
+		static std::string buildDefines(const std::vector<VariantDefine>& defines, const uint32_t mask);
+		static std::string injectDefines(const std::string& source, const std::string& defines);
+
+		// Vertex shaders built from now on get "invariant gl_Position;" after #version unless they already declare it,
+		// so a depth pre-pass and the shaded pass compute bit-identical depth. Renderer::enableDepthPrepass turns it on.
+		void setInvariantPosition(const bool enable) { invariantPosition = enable; }
+		bool isInvariantPosition() const { return invariantPosition; }
+		// Whether a program, or every variant of a variant program now and later, declares gl_Position invariant
+		bool hasInvariantPosition(const unsigned int programID) const;
+		bool hasInvariantVariants(const std::string& name) const;
+		static bool declaresInvariantPosition(const std::string& vertexSource);
 
 		bool getShader(const std::string& name, ShaderGPU*& dataOut);
 		bool getShader(const std::string& name, const ShaderGPU*& dataOut) const;
 		unsigned int getProgramID(const std::string& name) const;
 
+		void setProgramCacheDirectory(const std::string& path);
+		const ProgramCacheStats& getProgramCacheStats() const { return programCache.getStats(); }
+		void logProgramCacheStats() const;
+
 	private:
+		struct VariantProgram {
+			std::string vertexSource, fragmentSource;
+			std::string vertexPath, fragmentPath;
+			std::vector<VariantDefine> defines;
+			std::unordered_map<uint32_t, ShaderGPU> compiled;
+			std::unordered_map<uint32_t, bool> failed;
+		};
+
+		struct PendingProgram {
+			ShaderCPU cpu;
+			ShaderGPU gpu;
+		};
+		bool loadSources(ShaderCPU& cpu, const std::string& vertPath, const std::string& fragPath);
+		void release(const std::string& name);
+		ProgramState complete(std::map<std::string, PendingProgram>::iterator it);
+		void applyInvariantPosition(ShaderCPU& cpu) const;
+
 		Serializer::Parser parser;
 		ShaderHandler handler;
+		ProgramCache programCache;
 		std::map<std::string, ShaderGPU> nameToShaders;
+		std::map<std::string, PendingProgram> nameToPending;
+		std::set<std::string> failedPrograms;
+		std::map<std::string, VariantProgram> nameToVariants;
+		bool invariantPosition{ false };
 	};
 }
\ No newline at end of file
@@ -5,10 +5,19 @@
 
 #include "starlet-serializer/parser/image_parser.hpp"
 #include "starlet-graphics/handler/texture_handler.hpp"
+#include "starlet-graphics/streaming/texture_streamer.hpp"
 
 #include <map>
+#include <string>
+#include <utility>
+#include <vector>
 
 namespace Starlet::Graphics {
+	class StagingUploader;
+	class GLStateManager;
+	class JobSystem;
+	struct TextureCPU;
+
 	class TextureManager : public Manager {
 	public:
 		~TextureManager();
@@ -18,13 +27,36 @@ namespace Starlet::Graphics {
 		}
 
 		bool addTexture(const std::string& name, const std::string& filePath);
+		// Pixels already in memory, generated or decoded elsewhere. Streamed ones keep every level on the CPU as there is no file to reload
+		bool addTexture(const std::string& name, TextureCPU& cpu);
+		// Name and path pairs, decoded and staged on the load jobs when set so this thread only creates textures and queues copies
+		bool addTextures(const std::vector<std::pair<std::string, std::string>>& namesAndPaths);
 		bool addTextureCube(const std::string& name, const std::string(&facePaths)[6]);
 
 		unsigned int getTextureID(const std::string& name) const;
 
+		void setStagingUploader(StagingUploader* uploader) { staging = uploader; }
+		// Also decode streamed textures' evicted levels when they are needed again
+		void setLoadJobs(JobSystem* jobs) { loadJobs = jobs; streamer.setLoadJobs(jobs); }
+
+		void setStreaming(const bool enabled) { streaming = enabled; }
+		bool isStreaming() const { return streaming; }
+		void setStreamingBudget(const StreamingBudget& budget) { streamer.setBudget(budget); }
+		const StreamingStats& getStreamingStats() const { return streamer.getStats(); }
+
+		void markTextureUsed(const unsigned int textureID) { if (streaming) streamer.markUsed(textureID); }
+		void updateStreaming(GLStateManager& state) { if (streaming) streamer.update(state); }
+
 	private:
+		bool loadImage(const std::string& fullPath, TextureCPU& out) { return loadImage(parser, fullPath, out); }
+		static bool loadImage(Serializer::ImageParser& imageParser, const std::string& fullPath, TextureCPU& out);
+
 		Serializer::ImageParser parser;
 		TextureHandler handler;
+		TextureStreamer streamer;
+		StagingUploader* staging{ nullptr };
+		JobSystem* loadJobs{ nullptr };
+		bool streaming{ false };
 		std::map<std::string, TextureGPU> nameToGPUTextures;
 	};
 }
\ No newline at end of file
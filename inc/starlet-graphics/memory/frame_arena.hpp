@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+
+namespace Starlet::Graphics {
+	// Linear allocator for one frame's temporaries, usable by std::pmr containers. Allocation bumps an offset,
+	// deallocation is a no-op and reset() rewinds everything at once. A frame that outgrows the block falls back to
+	// upstream allocations, counted in getOverflowCount(), and the next reset() grows the block to fit that frame.
+	// Single threaded: only the render thread allocates from it.
+	class FrameArena : public std::pmr::memory_resource {
+	public:
+		static constexpr size_t DEFAULT_CAPACITY{ 1u << 20 };
+
+		explicit FrameArena(const size_t capacity = DEFAULT_CAPACITY, std::pmr::memory_resource* upstream = std::pmr::get_default_resource());
+		~FrameArena() override;
+
+		FrameArena(const FrameArena&) = delete;
+		FrameArena& operator=(const FrameArena&) = delete;
+
+		// Everything allocated since the last reset is released, containers using the arena must be gone by then
+		void reset();
+
+		size_t getCapacity() const { return capacity; }
+		size_t getUsed() const { return used + overflowBytes; }
+		size_t getHighWater() const { return highWater; }
+		uint32_t getOverflowCount() const { return overflowCount; }
+
+	protected:
+		void* do_allocate(const size_t bytes, const size_t alignment) override;
+		void do_deallocate(void* p, const size_t bytes, const size_t alignment) override;
+		bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+
+	private:
+		struct Overflow {
+			Overflow* next;
+			size_t bytes, alignment;
+		};
+
+		void releaseOverflow();
+
+		std::pmr::memory_resource* upstream;
+		std::byte* block{ nullptr };
+		size_t capacity{ 0 };
+		size_t used{ 0 };
+		size_t highWater{ 0 };
+
+		Overflow* overflow{ nullptr };
+		size_t overflowBytes{ 0 };
+		uint32_t overflowCount{ 0 };
+	};
+}
@@ -0,0 +1,11 @@
+#pragma once
+
+#include <cstdint>
+
+namespace Starlet::Graphics {
+	// Process-wide count of global heap allocations. The library never replaces operator new, an application or test
+	// that does calls recordHeapAllocation() from its replacement, after which Renderer reports the allocations made
+	// during each renderFrame in FrameStats::heapAllocations (every thread counts, not only the render thread).
+	void recordHeapAllocation();
+	uint64_t getHeapAllocationCount();
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace Starlet::Graphics {
+	struct MeshCPU;
+	class JobSystem;
+	class MeshStreamSink;
+
+	struct PlyParseStats {
+		uint64_t bytes{ 0 };
+		uint32_t vertices{ 0 }, faces{ 0 }, chunks{ 0 };
+		double milliseconds{ 0.0 };
+		bool binary{ false };
+
+		double megabytesPerSecond() const { return milliseconds > 0.0 ? (bytes / (1024.0 * 1024.0)) / (milliseconds / 1000.0) : 0.0; }
+	};
+
+	struct PlyBenchResult {
+		uint32_t iterations{ 0 };
+		uint64_t bytes{ 0 };
+		double fastMs{ 0.0 }, serializerMs{ 0.0 };  // Best of the iterations
+		double fastMBps{ 0.0 }, serializerMBps{ 0.0 };
+	};
+
+	// Memory-mapped PLY reader that writes straight into MeshCPU. ASCII bodies are split into chunks on line
+	// boundaries, non-blank lines are counted per chunk to give each its first row and the chunks are then parsed as jobs
+	// with std::from_chars. Binary little-endian bodies with fixed-size rows are converted a range of rows per job.
+	// Polygons are fanned into triangles, files it cannot read return false so callers can fall back.
+	class PlyParser {
+	public:
+		static constexpr size_t DEFAULT_CHUNK_BYTES{ 1u << 20 };
+
+		void setChunkBytes(const size_t bytes) { chunkBytes = bytes ? bytes : DEFAULT_CHUNK_BYTES; }
+
+		bool parse(const std::string& path, MeshCPU& mesh, JobSystem* jobs = nullptr);
+		const PlyParseStats& getLastStats() const { return lastStats; }
+
+		// Reads rows in order in chunks of the sink's size and commits each before reading on, consumed pages of the
+		// mapping are dropped as it goes. mesh receives counts, flags and bounds but no geometry. Triangle faces only.
+		bool stream(const std::string& path, MeshStreamSink& sink, MeshCPU& mesh);
+
+		// Parses the file with this parser and with Serializer::MeshParser, keeping the best time of each
+		PlyBenchResult benchmark(const std::string& path, const uint32_t iterations, JobSystem* jobs = nullptr);
+
+	private:
+		size_t chunkBytes{ DEFAULT_CHUNK_BYTES };
+		PlyParseStats lastStats;
+	};
+}
@@ -0,0 +1,80 @@
+#pragma once
+
+#include "starlet-math/vec3.hpp"
+
+#include <cstdint>
+#include <vector>
+
+namespace Starlet::Graphics {
+	struct MeshCPU;
+	class JobSystem;
+
+	struct BvhSettings {
+		uint32_t bins{ 16 };
+		uint32_t maxLeafTriangles{ 4 };
+		uint32_t parallelThreshold{ 16 * 1024 }; // Subtrees at or below this many triangles are built as one job
+	};
+
+	// Model space hit, distance is in units of the ray direction's length
+	struct BvhHit {
+		float distance{ 0.0f };
+		float u{ 0.0f }, v{ 0.0f };
+		uint32_t triangle{ 0 }; // Index into MeshCPU::indices / 3
+		Math::Vec3<float> normal; // Geometric, not normalised
+	};
+
+	// 32 bytes, two per cache line. A node with count 0 has its children adjacent at first and first + 1,
+	// a leaf covers count triangles from first in leaf order
+	struct BvhNode {
+		float min[3];
+		uint32_t first;
+		float max[3];
+		uint32_t count;
+	};
+
+	struct BvhBenchResult {
+		uint32_t rays{ 0 }, hits{ 0 };
+		double milliseconds{ 0.0 };
+		double raysPerSecond{ 0.0 };
+	};
+
+	// Triangle BVH over a mesh's full level of detail, binned SAH split along the widest centroid axis of each node.
+	// The top of the tree is split on the calling thread and the subtrees below parallelThreshold are built as jobs.
+	// Triangles are copied into leaf order as a vertex and two edges, so the mesh's geometry can be freed afterwards.
+	// Ray-box tests use SSE where the target has it and a scalar slab test elsewhere.
+	class MeshBvh {
+	public:
+		bool build(const MeshCPU& mesh, JobSystem* jobs = nullptr, const BvhSettings& settings = {});
+		void clear();
+		bool isBuilt() const { return !nodes.empty(); }
+
+		// Nearest hit with distance in [0, maxDistance]
+		bool intersect(const Math::Vec3<float>& origin, const Math::Vec3<float>& direction, const float maxDistance, BvhHit& hit) const;
+		// Any hit in [0, maxDistance], stops at the first
+		bool occluded(const Math::Vec3<float>& origin, const Math::Vec3<float>& direction, const float maxDistance) const;
+
+		// Queries use the SSE slab test where the target has it, this forces the scalar one so the two can be compared
+		void setScalarSlabs(const bool scalar) { scalarSlabs = scalar; }
+		static bool hasSseSlabs();
+
+		// Casts rays from a sphere around the bounds towards random points inside them
+		BvhBenchResult benchmark(const uint32_t rays, const uint32_t seed = 1) const;
+
+		uint32_t getNodeCount() const { return static_cast<uint32_t>(nodes.size()); }
+		uint32_t getTriangleCount() const { return static_cast<uint32_t>(triangles.size()); }
+		size_t getMemoryBytes() const { return nodes.capacity() * sizeof(BvhNode) + triangles.capacity() * sizeof(Triangle) + triangleIds.capacity() * sizeof(uint32_t); }
+
+	private:
+		struct Triangle {
+			Math::Vec3<float> v0, e1, e2;
+		};
+
+		template <bool AnyHit, bool Sse>
+		bool traverse(const Math::Vec3<float>& origin, const Math::Vec3<float>& direction, float maxDistance, BvhHit* hit) const;
+
+		std::vector<BvhNode> nodes;
+		std::vector<Triangle> triangles;
+		std::vector<uint32_t> triangleIds;
+		bool scalarSlabs{ false };
+	};
+}
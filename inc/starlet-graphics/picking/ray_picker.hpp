@@ -0,0 +1,47 @@
+#pragma once
+
+#include "starlet-graphics/picking/mesh_bvh.hpp"
+
+#include "starlet-scene/scene.hpp"
+#include "starlet-math/vec3.hpp"
+
+#include <cstdint>
+#include <limits>
+
+namespace Starlet::Graphics {
+	class ResourceManager;
+	struct RenderWorld;
+	struct ViewFrustum;
+
+	struct RayHit {
+		float distance{ 0.0f };
+		Math::Vec3<float> position;
+		Math::Vec3<float> normal; // World space, unit length and facing the ray
+		uint32_t row{ 0 };        // Row in RenderWorld::models
+		Scene::Entity entity{};
+		uint32_t triangle{ 0 };
+	};
+
+	// Scene queries against the visible model rows of a RenderWorld. Each row's bounding sphere is tested first,
+	// rows it passes have the ray taken into model space and traced through their mesh's BVH, so instances share one.
+	// Meshes loaded without a BVH are skipped.
+	class RayPicker {
+	public:
+		explicit RayPicker(const ResourceManager& rm) : resourceManager(rm) {}
+
+		// Nearest hit along direction, which need not be normalised, within maxDistance world units
+		bool raycast(const RenderWorld& world, const Math::Vec3<float>& origin, const Math::Vec3<float>& direction, RayHit& hit,
+			const float maxDistance = std::numeric_limits<float>::max()) const;
+		// True when no mesh lies strictly between the two points
+		bool lineOfSight(const RenderWorld& world, const Math::Vec3<float>& from, const Math::Vec3<float>& to) const;
+
+		// Ray from the eye through a point in normalised device coordinates, -1 to 1 with y up
+		static void screenRay(const ViewFrustum& frustum, const float ndcX, const float ndcY, Math::Vec3<float>& origin, Math::Vec3<float>& direction);
+
+	private:
+		template <bool AnyHit>
+		bool trace(const RenderWorld& world, const Math::Vec3<float>& origin, const Math::Vec3<float>& direction, float maxDistance, RayHit* hit) const;
+
+		const ResourceManager& resourceManager;
+	};
+}
@@ -0,0 +1,108 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace Starlet::Graphics {
+	// One closed scope, times are microseconds since the profiler was created. GPU times are -1 when unavailable.
+	// The name is not copied, scopes are named with string literals or strings that outlive the profiler.
+	struct ProfileEvent {
+		const char* name{ "" };
+		uint64_t frame{ 0 };
+		uint32_t depth{ 0 };
+		double cpuBeginUs{ 0.0 }, cpuEndUs{ 0.0 };
+		double gpuBeginUs{ -1.0 }, gpuEndUs{ -1.0 };
+
+		bool hasGpu() const { return gpuBeginUs >= 0.0 && gpuEndUs >= 0.0; }
+	};
+
+	// Nested CPU scopes per frame, optionally bracketed with GL_TIMESTAMP queries and debug groups.
+	// Query results are read FRAME_LATENCY frames later so the readback never waits on the GPU.
+	class Profiler {
+	public:
+		static constexpr uint32_t FRAME_LATENCY{ 3 };
+
+		Profiler();
+		~Profiler() { shutdownGpu(); }
+
+		Profiler(const Profiler&) = delete;
+		Profiler& operator=(const Profiler&) = delete;
+
+		void setEnabled(const bool enable) { enabled = enable; }
+		bool isEnabled() const { return enabled; }
+
+		bool initGpu();
+		void shutdownGpu();
+		bool isGpuEnabled() const { return gpuEnabled; }
+
+		void beginFrame();
+		void endFrame();
+
+		// beginScope returns false when nothing was opened, only a successful begin may be ended
+		bool beginScope(const char* name);
+		void endScope();
+
+		// Resolved events in a ring of setMaxEvents entries (default 4096) allocated up front, the oldest are overwritten.
+		// Index 0 is the oldest event.
+		size_t getEventCount() const { return eventCount; }
+		const ProfileEvent& getEvent(const size_t index) const { return events[(eventHead + index) % events.size()]; }
+		std::vector<ProfileEvent> getEvents() const;
+		void setMaxEvents(const size_t count);
+		void clearEvents() { eventHead = eventCount = 0; }
+
+		// Durations of the named scope in the most recently resolved frame, 0 when absent
+		double getCpuMs(const char* name) const;
+		double getGpuMs(const char* name) const;
+		uint32_t getDroppedGpuFrames() const { return droppedGpuFrames; }
+
+		static std::string toChromeTrace(const std::vector<ProfileEvent>& events);
+		bool writeChromeTrace(const std::string& path) const;
+
+	private:
+		struct FrameSlot {
+			uint64_t frame{ 0 };
+			bool pending{ false };
+			std::vector<ProfileEvent> events;
+			std::vector<unsigned int> queries; // Begin and end timestamp per event
+		};
+
+		double nowUs() const;
+		void resolve(FrameSlot& slot, const bool wait);
+		void publish(std::vector<ProfileEvent>& frameEvents);
+		unsigned int acquireQuery();
+
+		bool enabled{ false };
+		bool gpuEnabled{ false };
+		bool inFrame{ false };
+		bool debugGroups{ false };
+		uint64_t frame{ 0 };
+		uint64_t lastResolvedFrame{ 0 };
+		uint32_t droppedGpuFrames{ 0 };
+
+		std::chrono::steady_clock::time_point epoch;
+		double gpuOffsetUs{ 0.0 }; // Add to GPU timestamp microseconds to land on the CPU timeline
+
+		FrameSlot slots[FRAME_LATENCY];
+		std::vector<size_t> open;
+		std::vector<unsigned int> freeQueries;
+
+		std::vector<ProfileEvent> events;
+		size_t eventHead{ 0 }, eventCount{ 0 };
+	};
+
+	class ProfileScope {
+	public:
+		ProfileScope(Profiler& p, const char* name) : profiler(p), opened(p.beginScope(name)) {}
+		~ProfileScope() { if (opened) profiler.endScope(); }
+
+		ProfileScope(const ProfileScope&) = delete;
+		ProfileScope& operator=(const ProfileScope&) = delete;
+
+	private:
+		Profiler& profiler;
+		const bool opened;
+	};
+}
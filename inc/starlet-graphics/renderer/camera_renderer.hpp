@@ -8,14 +8,16 @@ namespace Starlet {
 
 	namespace Graphics {
 		class UniformCache;
+		struct FrameStats;
 
 		class CameraRenderer {
 		public:
-			CameraRenderer(const UniformCache& uc) : uniforms(uc) {}
+			CameraRenderer(const UniformCache& uc, FrameStats& fs) : uniforms(uc), stats(fs) {}
 
 			void updateCameraUniforms(const Math::Vec3<float>& eye, const Math::Mat4& view, const Math::Mat4& projection) const;
 		private:
 			const UniformCache& uniforms;
+			FrameStats& stats;
 		};
 	}
 }
\ No newline at end of file
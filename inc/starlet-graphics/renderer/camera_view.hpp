@@ -11,4 +11,17 @@ namespace Starlet::Graphics {
 
 		static CameraView fromTransform(const Math::Vec3<float>& pos, const Math::Vec3<float>& rot, const Math::Vec3<float>& up);
 	};
+
+	// Symmetric perspective frustum in the camera basis, fov is vertical and in degrees as on Scene::Camera
+	struct ViewFrustum {
+		CameraView view;
+		float tanHalfX{ 0.0f }, tanHalfY{ 0.0f };
+		float nearPlane{ 0.0f }, farPlane{ 0.0f };
+
+		static ViewFrustum fromView(const CameraView& view, const float fov, const float aspect, const float nearPlane, const float farPlane);
+
+		// x along right, y along up, z along front
+		Math::Vec3<float> toView(const Math::Vec3<float>& point) const;
+		bool intersectsSphere(const Math::Vec3<float>& centre, const float radius) const;
+	};
 }
\ No newline at end of file
@@ -0,0 +1,44 @@
+#pragma once
+
+#include "starlet-graphics/renderer/draw_packet.hpp"
+
+#include <cstdint>
+#include <memory_resource>
+#include <vector>
+
+namespace Starlet {
+	namespace Math {
+		struct Mat4;
+	}
+
+	namespace Graphics {
+		class ShaderManager;
+		class GLStateManager;
+		struct FrameStats;
+
+		// Lays down depth for the opaque packets with a position-only program and colour writes off, front to back so
+		// early depth rejects as much as it can. The shaded pass then runs with GL_EQUAL and depth writes off, shading
+		// each visible pixel once. Its vertex shader must compute gl_Position as mProj * mView * mModel * vec4(pos, 1.0),
+		// declared invariant (ShaderManager::setInvariantPosition injects it), or the renderer falls back to GL_LEQUAL.
+		class DepthPrepass {
+		public:
+			static constexpr const char* PROGRAM_NAME{ "StarletDepthPrepass" };
+
+			DepthPrepass(GLStateManager& sm, FrameStats& fs, std::pmr::memory_resource& fm) : state(sm), stats(fs), frameMemory(fm) {}
+
+			bool init(ShaderManager& sm);
+			bool isReady() const { return program != 0; }
+			void release() { program = 0; }
+
+			void draw(const std::pmr::vector<DrawPacket>& packets, const Math::Mat4& view, const Math::Mat4& projection);
+
+		private:
+			GLStateManager& state;
+			FrameStats& stats;
+			std::pmr::memory_resource& frameMemory;
+
+			unsigned int program{ 0 };
+			int modelLocation{ -1 }, viewLocation{ -1 }, projLocation{ -1 };
+		};
+	}
+}
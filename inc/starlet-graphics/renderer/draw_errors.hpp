@@ -0,0 +1,52 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+namespace Starlet::Graphics {
+	enum class DrawError : uint8_t {
+		MissingMesh,
+		MissingTexture,
+		MissingVariant,
+		Count
+	};
+
+	// Tally of skipped draws filled on the hot path without allocating, the first offender of each kind is kept by name
+	struct DrawErrorCounts {
+		static constexpr size_t KINDS{ static_cast<size_t>(DrawError::Count) };
+		static constexpr size_t NAME_LENGTH{ 48 };
+
+		uint32_t counts[KINDS]{};
+		char firstName[KINDS][NAME_LENGTH]{};
+
+		void add(const DrawError error, const std::string_view name);
+		void merge(const DrawErrorCounts& other);
+		void clear();
+		uint32_t total() const;
+	};
+
+	// Collects each frame's draw errors and logs one summary at most every interval seconds, so a broken model costs a
+	// counter per draw rather than a formatted log line per draw per frame
+	class DrawErrorReport {
+	public:
+		void setInterval(const double seconds) { interval = seconds; }
+
+		void add(const DrawError error, const std::string_view name) { frame.add(error, name); }
+		void merge(const DrawErrorCounts& counts) { frame.merge(counts); }
+
+		// Moves the frame's tally into the pending report and logs it if the interval elapsed, returns true when it logged
+		bool endFrame();
+		const DrawErrorCounts& getLastFrame() const { return lastFrame; }
+
+	private:
+		using Clock = std::chrono::steady_clock;
+
+		DrawErrorCounts frame, lastFrame, pending;
+		uint32_t pendingFrames{ 0 };
+		double interval{ 1.0 };
+		Clock::time_point lastLog;
+		bool hasLogged{ false };
+	};
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include "starlet-graphics/renderer/draw_errors.hpp"
+
+#include "starlet-math/mat4.hpp"
+#include "starlet-math/vec4.hpp"
+
+#include <cstdint>
+#include <vector>
+
+namespace Starlet {
+	namespace Graphics {
+		constexpr unsigned int DRAW_PACKET_TEXTURES{ 4 };
+
+		// Everything the submit phase needs for one model draw, filled off the GL thread
+		struct DrawPacket {
+			Math::Mat4 model;
+			Math::Mat4 modelInverseTranspose;
+			Math::Vec4<float> colour, specular;
+			float texMixRatios[DRAW_PACKET_TEXTURES]{};
+			float seed[3]{};
+			float yMin{ 0.0f }, yMax{ 0.0f };
+			float distanceSq{ 0.0f };
+
+			unsigned int vao{ 0 };
+			unsigned int depthVao{ 0 }; // Position only, 0 falls back to vao
+			unsigned int firstIndex{ 0 }, numIndices{ 0 }, numVertices{ 0 };
+			unsigned int textures[DRAW_PACKET_TEXTURES]{};
+
+			uint32_t row{ 0 };         // RenderModels row, for error reports
+			uint32_t variantMask{ 0 };
+			int colourMode{ 0 };
+			bool hasVertexColour{ false };
+			bool useTextures{ false };
+			bool isLit{ false };
+			bool valid{ true }; // Cleared when a resource failed to resolve, submit and the depth pre-pass skip it
+		};
+
+		// Output of one prepare worker, kept between frames so steady state does not allocate
+		struct DrawPacketBuffer {
+			std::vector<DrawPacket> opaque;
+			std::vector<DrawPacket> transparent;
+			uint32_t culled{ 0 };
+			uint32_t occluded{ 0 };
+			uint32_t lodTrianglesSaved{ 0 };
+			DrawErrorCounts errors; // Missing meshes and textures, merged and reported on the GL thread
+
+			void clear() {
+				opaque.clear();
+				transparent.clear();
+				culled = 0;
+				occluded = 0;
+				lodTrianglesSaved = 0;
+				errors.clear();
+			}
+		};
+	}
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Starlet::Graphics {
+	// What the last Renderer::renderFrame submitted, pass times are CPU milliseconds
+	struct FrameStats {
+		uint32_t drawCalls{ 0 };
+		uint32_t triangles{ 0 };
+		uint32_t prepassDrawCalls{ 0 }; // Depth pre-pass share of drawCalls / triangles
+		uint32_t prepassTriangles{ 0 };
+		uint32_t vertices{ 0 };
+		uint32_t uniformUploads{ 0 };
+		uint32_t lightsUploaded{ 0 }; // Light slots re-sent because their data changed, summed over programs
+		uint32_t activeLights{ 0 };   // lightCount sent to the shaders
+		uint32_t culledLights{ 0 };   // Disabled or outside the frustum, with light culling on
+		uint32_t textureBinds{ 0 };
+		uint32_t vaoBinds{ 0 };
+		uint32_t culledModels{ 0 };      // Hidden, or bounding sphere outside the view frustum
+		uint32_t invalidDraws{ 0 };      // Skipped for a missing mesh, texture or program variant, see DrawErrorReport
+		uint32_t occludedModels{ 0 };    // Hidden behind software occluders
+		uint32_t occluderTriangles{ 0 };
+		uint32_t lodTrianglesSaved{ 0 }; // Full mesh triangles minus those drawn at the selected levels of detail
+		uint32_t frameArenaBytes{ 0 };
+		uint32_t frameArenaOverflows{ 0 }; // Arena allocations that fell back to the heap, the block grows to fit next frame
+		uint32_t heapAllocations{ 0 };     // Global operator new calls during renderFrame, 0 unless the application counts them
+
+		double lightUpdateMs{ 0.0 };
+		double prepareMs{ 0.0 };
+		double prepassMs{ 0.0 };
+		double opaqueMs{ 0.0 };
+		double skyboxMs{ 0.0 };
+		double transparentMs{ 0.0 };
+		double frameMs{ 0.0 };
+
+		using Clock = std::chrono::steady_clock;
+		static double msSince(const Clock::time_point start) {
+			return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+		}
+	};
+
+	// Rolling window of frame times for percentile reporting, a capacity of 0 keeps nothing
+	class FrameStatsHistory {
+	public:
+		void setCapacity(const size_t frames);
+		size_t getCapacity() const { return frameMs.size(); }
+		size_t size() const { return count; }
+
+		void push(const FrameStats& stats);
+		void clear();
+
+		// p in [0, 100], nearest rank over the frames currently held
+		double percentile(const double p) const;
+		double p50() const { return percentile(50.0); }
+		double p95() const { return percentile(95.0); }
+		double p99() const { return percentile(99.0); }
+
+	private:
+		std::vector<double> frameMs;
+		mutable std::vector<double> sorted; // Scratch for percentile, reserved with the window so a per-frame p95 does not allocate
+		size_t next{ 0 };
+		size_t count{ 0 };
+	};
+}
@@ -0,0 +1,100 @@
+#pragma once
+
+#include "starlet-graphics/renderer/light_renderer.hpp"
+
+#include "starlet-math/vec3.hpp"
+#include "starlet-math/vec4.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Starlet::Graphics {
+	class GLStateManager;
+	class JobSystem;
+	struct RenderWorld;
+	struct CameraView;
+
+	// RenderLights::param1.x of a Scene::LightType::Directional light
+	constexpr float DIRECTIONAL_LIGHT_TYPE{ 2.0f };
+
+	// Distance at which 1 / (x + y*d + z*d^2) falls to cutoff, negative when the attenuation never does
+	float lightInfluenceRange(const Math::Vec4<float>& attenuation, const float cutoff);
+
+	struct ClusterBounds {
+		Math::Vec3<float> min, max; // View space, +z along the camera front
+	};
+
+	struct ClusterProjection {
+		float fov{ 0.0f }; // Vertical, degrees as on Scene::Camera
+		float aspect{ 0.0f };
+		float nearPlane{ 0.0f }, farPlane{ 0.0f };
+	};
+
+	// Splits the view frustum into screen tiles x exponential depth slices and lists, per cluster, the lights whose
+	// influence sphere touches it. Assignment is pure CPU and runs one depth slice per job, upload() sends the
+	// compact lists to three shader storage buffers at bindingBase, +1, +2:
+	//   LightClusterLights { Light lights[]; }                                    LightStd140 entries
+	//   LightClusterGrid   { uvec4 dims; vec4 depth; uvec2 clusters[]; }          dims.w = light count, depth = near, far,
+	//                                                                              slice scale, slice bias; clusters = offset, count
+	//   LightClusterIndices { uint indices[]; }
+	// The slice of a fragment at view depth z is floor(log(z) * scale - bias). Directional lights and lights with
+	// unbounded attenuation are listed in every cluster.
+	class LightClusters {
+	public:
+		LightClusters() = default;
+		~LightClusters() { disableUpload(); }
+
+		LightClusters(const LightClusters&) = delete;
+		LightClusters& operator=(const LightClusters&) = delete;
+
+		void setGrid(const uint32_t x, const uint32_t y, const uint32_t z);
+		void setCutoff(const float intensity) { cutoff = intensity; }
+		float getCutoff() const { return cutoff; }
+
+		void build(const RenderWorld& world, const CameraView& view, const ClusterProjection& projection, JobSystem* jobs);
+
+		bool enableUpload(GLStateManager& state, const unsigned int bindingBase);
+		void disableUpload();
+		void upload();
+
+		uint32_t getDimX() const { return dimX; }
+		uint32_t getDimY() const { return dimY; }
+		uint32_t getDimZ() const { return dimZ; }
+		size_t getClusterCount() const { return bounds.size(); }
+		uint32_t getClusterIndex(const uint32_t x, const uint32_t y, const uint32_t z) const { return (z * dimY + y) * dimX + x; }
+
+		const ClusterBounds& getClusterBounds(const size_t cluster) const { return bounds[cluster]; }
+		const uint32_t* getClusterLights(const size_t cluster, uint32_t& count) const;
+
+		// Compacted active lights the index lists refer to, with their view-space spheres
+		const std::vector<LightStd140>& getLights() const { return lights; }
+		const std::vector<Math::Vec4<float>>& getLightSpheres() const { return spheres; }
+		size_t getIndexCount() const { return indices.size(); }
+
+		static bool sphereIntersects(const ClusterBounds& bounds, const Math::Vec3<float>& centre, const float radius);
+
+	private:
+		void buildBounds(const ClusterProjection& projection);
+		void assignSlice(const uint32_t slice);
+
+		uint32_t dimX{ 16 }, dimY{ 9 }, dimZ{ 24 };
+		float cutoff{ 0.01f };
+
+		ClusterProjection boundsProjection;
+		float sliceScale{ 0.0f }, sliceBias{ 0.0f };
+		std::vector<ClusterBounds> bounds;
+
+		std::vector<LightStd140> lights;
+		std::vector<Math::Vec4<float>> spheres; // xyz view position, w radius, negative for lights in every cluster
+		std::vector<uint32_t> globalLights;
+
+		std::vector<std::vector<uint32_t>> clusterLists;
+		std::vector<uint32_t> ranges; // offset, count per cluster
+		std::vector<uint32_t> indices;
+
+		GLStateManager* state{ nullptr };
+		unsigned int bindingBase{ 0 };
+		unsigned int buffers[3]{ 0, 0, 0 };
+	};
+}
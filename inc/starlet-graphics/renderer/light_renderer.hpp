@@ -1,21 +1,87 @@
 #pragma once
 
-namespace Starlet {
-	namespace Scene {
-		class Scene;
-	}
+#include "starlet-math/vec4.hpp"
 
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace Starlet {
 	namespace Graphics {
 		class UniformCache;
+		class GLStateManager;
+		struct FrameStats;
+		struct RenderWorld;
+		struct ViewFrustum;
 
+		// One theLights[] entry in std140 layout, also the element of the optional LightBlock uniform buffer
+		struct LightStd140 {
+			Math::Vec4<float> position;
+			Math::Vec4<float> diffuse;
+			Math::Vec4<float> attenuation;
+			Math::Vec4<float> direction;
+			Math::Vec4<float> param1; // type, param1.x, param1.y, 0
+			Math::Vec4<float> param2; // x is 1 when the light is on
+		};
+		static_assert(sizeof(LightStd140) == 6 * 4 * sizeof(float), "LightStd140 must match the std140 array stride");
+
+		// Packs lights into a std140 array and uploads only the slots whose RenderWorld version moved.
+		// With culling on, only enabled lights whose influence sphere (attenuation falling to the cutoff) touches the
+		// frustum are packed, so lightCount shrinks to the visible set.
+		// Each program remembers what it was last sent, so variant programs are brought up to date independently.
+		// With a uniform buffer enabled, programs declaring `uniform LightBlock { Light theLights[N]; }` read the
+		// shared buffer instead and changed slots are written as contiguous ranges once per frame.
 		class LightRenderer {
 		public:
-			LightRenderer(const UniformCache& uc) : uniforms(uc) {}
+			LightRenderer(const UniformCache& uc, FrameStats& fs, GLStateManager& sm) : uniforms(uc), stats(fs), state(sm) {}
+			~LightRenderer() { disableUniformBuffer(); }
+
+			LightRenderer(const LightRenderer&) = delete;
+			LightRenderer& operator=(const LightRenderer&) = delete;
+
+			bool enableUniformBuffer(const unsigned int binding);
+			void disableUniformBuffer();
+			bool hasUniformBuffer() const { return ubo != 0; }
+
+			void setCulling(const bool enabled) { culling = enabled; }
+			bool isCulling() const { return culling; }
+			void setInfluenceCutoff(const float intensity) { cutoff = intensity; }
+			float getInfluenceCutoff() const { return cutoff; }
+
+			// Once per frame before any update, frustum may be null to keep every light
+			void prepareLights(const RenderWorld& world, const ViewFrustum* frustum);
+			void updateLightUniforms(const unsigned int program, const RenderWorld& world);
+
+			// Forget what every program was sent, the next update re-uploads everything
+			void invalidate();
 
-			void updateLightUniforms(const unsigned int program, const Scene::Scene& scene) const;
-			void updateLightCount(const int count) const;
 		private:
+			struct ProgramLights {
+				std::vector<uint64_t> versions;
+				int count{ -1 };
+				Math::Vec4<float> ambient;
+				bool hasAmbient{ false };
+				bool blockBound{ false };
+			};
+
+			void pack(const RenderWorld& world, const size_t slot, const size_t row);
+			void uploadUniforms(ProgramLights& uploaded, const size_t count);
+			void uploadBuffer(const size_t count);
+
 			const UniformCache& uniforms;
+			FrameStats& stats;
+			GLStateManager& state;
+
+			bool culling{ false };
+			float cutoff{ 0.01f };
+
+			std::vector<LightStd140> packed;
+			std::vector<uint64_t> packedVersions;
+			std::unordered_map<unsigned int, ProgramLights> programs;
+
+			unsigned int ubo{ 0 };
+			unsigned int uboBinding{ 0 };
+			std::vector<uint64_t> uboVersions;
 		};
 	}
 }
@@ -1,41 +1,80 @@
 #pragma once
 
-namespace Starlet {
-	namespace Math {
-		template <typename T> struct Vec3;
-	}
+#include "starlet-graphics/renderer/draw_packet.hpp"
+#include "starlet-graphics/resource/mesh_lod.hpp"
+#include "starlet-graphics/renderer/draw_errors.hpp"
 
-	namespace Scene {
-		class Scene;
-
-		struct Model;
-
-		struct TransformComponent;
-		struct ColourComponent;
-	}
+#include <cstdint>
+#include <memory_resource>
+#include <string_view>
+#include <vector>
 
+namespace Starlet {
 	namespace Graphics {
 		class UniformCache;
 		class ResourceManager;
-
-		struct MeshCPU;
+		class ProgramVariants;
+		class GLStateManager;
+		class JobSystem;
+		struct RenderWorld;
+		struct RenderModels;
+		struct FrameStats;
+		struct ViewFrustum;
+		class SoftwareOcclusion;
 
 		class ModelRenderer {
 		public:
-			ModelRenderer(const Graphics::UniformCache& uc, const Graphics::ResourceManager& rm) : uniforms(uc), resourceManager(rm) {}
-			void updateModelUniforms(const Scene::Model& instance, const MeshCPU& data, const Scene::TransformComponent& transform, const Scene::ColourComponent& colour) const;
+			// Queues and sort keys live in frameMemory, see releaseFrame(). Skipped draws are counted in the DrawErrorReport instead of logged
+			ModelRenderer(const Graphics::UniformCache& uc, Graphics::ResourceManager& rm, Graphics::ProgramVariants& pv, Graphics::GLStateManager& sm, Graphics::FrameStats& fs, std::pmr::memory_resource& fm, Graphics::DrawErrorReport& de)
+				: uniforms(uc), resourceManager(rm), variants(pv), state(sm), stats(fs), frameMemory(fm), errors(de),
+				opaqueQueue(&fm), transparentQueue(&fm), opaqueOrder(&fm), transparentOrder(&fm) {}
 
-			void bindSkyboxTexture(const unsigned int texture) const;
-			void setModelIsSkybox(const bool isSkybox) const;
+			static uint32_t variantMask(const bool isLit, const bool useTextures, const bool hasVertexColour, const int colourMode);
 
-			bool drawModel(const Scene::Model& instance, const Scene::TransformComponent& transform, const Scene::ColourComponent& colour) const;
-			bool drawOpaqueModels(const Scene::Scene& scene, const Math::Vec3<float>& eye) const;
-			bool drawTransparentModels(const Scene::Scene& scene, const Math::Vec3<float>& eye) const;
-			bool drawSkybox(const Scene::Model& skybox, const Math::Vec3<float>& skyboxSize, const Math::Vec3<float>& cameraPos) const;
+			// Prepare walks disjoint slices of the models as jobs (inline without a job system) and writes draw packets,
+			// submit replays them on the GL thread. Opaque packets keep scene order, transparent ones are sorted back to front.
+			static constexpr uint32_t PREPARE_GRAIN{ 512 };
+			void prepareModels(const RenderWorld& world, const ViewFrustum& frustum, JobSystem* jobs);
+			// After a depth pre-pass the opaque packets are drawn without writing depth, the caller sets GL_EQUAL
+			bool submitOpaque(const bool depthPrepassed = false);
+			bool submitTransparent();
+			const std::pmr::vector<DrawPacket>& getOpaqueQueue() const { return opaqueQueue; }
+
+			// Drops the queues before the frame arena is reset, the next prepareModels rebuilds them
+			void releaseFrame();
+
+			// Picks the coarsest level of detail whose error covers at most threshold of the screen height,
+			// moving to a coarser level needs (1 - hysteresis) of it and a finer one (1 + hysteresis)
+			void setLodSelection(const bool enabled, const float threshold = 0.001f, const float hysteresis = 0.25f);
+
+			// Models whose mesh bounds are hidden in the occlusion buffer are skipped during prepare, null turns it off
+			void setOcclusion(const SoftwareOcclusion* culler) { occlusion = culler; }
 
 		private:
+			void prepareModel(const RenderModels& models, const size_t row, const ViewFrustum& frustum, DrawPacketBuffer& out);
+			uint8_t selectLod(const std::vector<MeshLod>& lods, const float screenScale, const uint8_t current) const;
+			bool submitPacket(const DrawPacket& packet, const bool writeDepth);
+			bool skipDraw(const DrawError error, const std::string_view name) const;
+
 			const UniformCache& uniforms;
-			const ResourceManager& resourceManager;
+			ResourceManager& resourceManager;
+			ProgramVariants& variants;
+			GLStateManager& state;
+			FrameStats& stats;
+			std::pmr::memory_resource& frameMemory;
+			DrawErrorReport& errors;
+			const RenderModels* frameModels{ nullptr }; // World of the last prepareModels, names skipped draws
+
+			// Prepare jobs write the per-slice buffers concurrently, so those stay on the heap and are reused
+			std::vector<DrawPacketBuffer> buffers;
+			std::pmr::vector<DrawPacket> opaqueQueue, transparentQueue;
+			std::pmr::vector<uint64_t> opaqueOrder, transparentOrder; // sortKey() per packet, in submit order
+
+			const SoftwareOcclusion* occlusion{ nullptr };
+
+			bool lodEnabled{ false };
+			float lodThreshold{ 0.001f }, lodHysteresis{ 0.25f };
+			std::vector<uint8_t> lodLevels; // Per model row, written only by the job preparing that row
 		};
 	}
 }
\ No newline at end of file
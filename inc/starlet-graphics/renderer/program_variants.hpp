@@ -0,0 +1,62 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace Starlet::Graphics {
+	class ShaderManager;
+	class UniformCache;
+	class GLStateManager;
+	struct VariantDefine;
+
+	enum ModelVariantFlags : uint32_t {
+		MODEL_VARIANT_LIT = 1u << 0,
+		MODEL_VARIANT_TEXTURED = 1u << 1,
+		MODEL_VARIANT_VERTEX_COLOUR = 1u << 2,
+	};
+	constexpr uint32_t MODEL_VARIANT_COLOUR_MODE_SHIFT{ 3 };
+	constexpr uint32_t MODEL_VARIANT_COLOUR_MODE_BITS{ 3 };
+
+	// Selects the specialised model program for a draw-state mask, compiling it on first use.
+	// The prepare callback uploads per-frame uniforms (camera, lights) the first time a program is bound each frame.
+	class ProgramVariants {
+	public:
+		using PrepareProgram = std::function<void(unsigned int program)>;
+
+		ProgramVariants(UniformCache& uc, GLStateManager& sm) : uniforms(uc), state(sm) {}
+
+		// Defines matching the ModelVariantFlags layout: IS_LIT, USE_TEXTURES, HAS_VERTEX_COLOUR, COLOUR_MODE
+		static const std::vector<VariantDefine>& getModelDefines();
+
+		void enable(ShaderManager& sm, const std::string& programName, PrepareProgram prepareProgram);
+		void disable();
+		bool isEnabled() const { return shaderManager != nullptr; }
+		const std::string& getProgramName() const { return name; }
+
+		void beginFrame();
+		bool select(const uint32_t mask);
+
+		// Another program was bound in between, the next select() binds its variant again without re-preparing it
+		void resetCurrent() { currentProgram = 0; }
+
+		unsigned int getCurrentProgram() const { return currentProgram; }
+		uint32_t getSwitchCount() const { return switches; }
+
+	private:
+		UniformCache& uniforms;
+		GLStateManager& state;
+		ShaderManager* shaderManager{ nullptr };
+		std::string name;
+		PrepareProgram prepare;
+
+		unsigned int currentProgram{ 0 };
+		uint64_t frame{ 0 };
+		uint32_t switches{ 0 };
+
+		std::unordered_map<uint32_t, unsigned int> maskToProgram;
+		std::unordered_map<unsigned int, uint64_t> preparedFrame;
+	};
+}
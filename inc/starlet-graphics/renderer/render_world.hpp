@@ -0,0 +1,122 @@
+#pragma once
+
+#include "starlet-graphics/resource/resource_handle.hpp"
+#include "starlet-graphics/renderer/draw_packet.hpp"
+
+#include "starlet-scene/scene.hpp"
+#include "starlet-scene/component/model.hpp"
+
+#include "starlet-math/vec3.hpp"
+#include "starlet-math/vec4.hpp"
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace Starlet::Graphics {
+	enum RenderModelFlags : uint8_t {
+		RENDER_MODEL_VISIBLE = 1u << 0,
+		RENDER_MODEL_LIT = 1u << 1,
+		RENDER_MODEL_TEXTURED = 1u << 2,
+	};
+
+	// Renderable models as parallel arrays, one row per model entity with a transform.
+	// version[i] changes whenever row i is rewritten, copies compare it to skip unchanged rows.
+	// Names are cold data for error reports, versioned apart so copying a moved row does not copy its string.
+	struct RenderModels {
+		std::vector<Scene::Entity> entity;
+		std::vector<Math::Vec3<float>> position, rotation, scale;
+		std::vector<Math::Vec4<float>> colour, specular;
+		std::vector<ResourceHandle> mesh;
+		std::vector<std::array<ResourceHandle, DRAW_PACKET_TEXTURES>> textures;
+		std::vector<std::array<float, DRAW_PACKET_TEXTURES>> textureMix;
+		std::vector<std::array<float, 3>> seed;
+		std::vector<uint8_t> flags;
+		std::vector<uint8_t> colourMode;
+		std::vector<uint64_t> version;
+
+		std::vector<std::string> name;
+		std::vector<uint64_t> nameVersion;
+
+		size_t size() const { return entity.size(); }
+		void resize(const size_t count);
+		void copyRow(const RenderModels& other, const size_t row);
+	};
+
+	struct RenderLights {
+		std::vector<Math::Vec4<float>> position, direction, diffuse, attenuation;
+		std::vector<Math::Vec4<float>> param1; // type, param1.x, param1.y, 0
+		std::vector<uint8_t> active;           // Enabled and has a transform
+		std::vector<uint64_t> version;
+
+		size_t size() const { return active.size(); }
+		void resize(const size_t count);
+		void copyRow(const RenderLights& other, const size_t row);
+	};
+
+	struct RenderCamera {
+		bool valid{ false };
+		Math::Vec3<float> position, rotation;
+		float fov{ 0.0f }, nearPlane{ 0.0f }, farPlane{ 0.0f };
+	};
+
+	// Only the cube map is needed, the skybox is drawn with SkyboxRenderer's own cube whatever mesh the model names
+	struct RenderSkybox {
+		bool valid{ false };
+		ResourceHandle texture;
+	};
+
+	// Everything one frame renders, read without touching the scene
+	struct RenderWorld {
+		uint64_t frame{ 0 };
+		RenderModels models;
+		RenderLights lights;
+		RenderCamera camera;
+		Math::Vec4<float> ambient;
+
+		RenderSkybox skybox;
+	};
+
+	// Keeps the latest extracted rows and copies only rows whose version moved into the target world.
+	// Per frame only plain values are compared. A row's name is compared when the row gets a new entity, and
+	// otherwise NAME_CHECKS_PER_FRAME rows at a time round-robin, so a rename shows up within size / 32 frames.
+	class RenderWorldExtractor {
+	public:
+		static constexpr size_t NAME_CHECKS_PER_FRAME{ 32 };
+
+		void extract(const Scene::Scene& scene, RenderWorld& out);
+		uint32_t getChangedRows() const { return changedRows; }
+
+	private:
+		bool extractModel(const size_t row, const Scene::Entity entity, const Scene::Model& model, const Scene::Scene& scene, const bool checkName);
+		bool extractLight(const size_t row, const Scene::Entity entity, const Scene::Scene& scene);
+
+		RenderWorld latest;
+		uint64_t version{ 0 };
+		uint32_t changedRows{ 0 };
+		size_t nameCursor{ 0 };
+	};
+
+	// Triple-buffered snapshots: the simulation thread extracts frame N+1 while the render thread reads frame N.
+	// One producer and one consumer, acquire() returns the newest published world, valid until the next acquire().
+	class RenderWorldBuffer {
+	public:
+		void extract(const Scene::Scene& scene);
+		const RenderWorld* acquire();
+
+		uint32_t getChangedRows() const { return extractor.getChangedRows(); }
+
+	private:
+		static constexpr uint32_t FRESH{ 4 };
+
+		RenderWorldExtractor extractor;
+		RenderWorld worlds[3];
+		uint64_t frame{ 0 };
+
+		uint32_t writeIndex{ 0 };
+		std::atomic<uint32_t> ready{ 1 }; // Index of the last published world, FRESH when not yet acquired
+		uint32_t readIndex{ 2 };
+	};
+}
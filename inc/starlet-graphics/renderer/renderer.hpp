@@ -4,6 +4,20 @@
 #include "starlet-graphics/renderer/light_renderer.hpp"
 #include "starlet-graphics/renderer/model_renderer.hpp"
 #include "starlet-graphics/renderer/camera_renderer.hpp"
+#include "starlet-graphics/renderer/program_variants.hpp"
+#include "starlet-graphics/renderer/render_world.hpp"
+#include "starlet-graphics/renderer/light_clusters.hpp"
+#include "starlet-graphics/renderer/depth_prepass.hpp"
+#include "starlet-graphics/renderer/skybox_renderer.hpp"
+#include "starlet-graphics/culling/software_occlusion.hpp"
+#include "starlet-graphics/manager/gl_state_manager.hpp"
+#include "starlet-graphics/renderer/frame_stats.hpp"
+#include "starlet-graphics/profiler/profiler.hpp"
+#include "starlet-graphics/memory/frame_arena.hpp"
+
+#include "starlet-math/mat4.hpp"
+
+#include <string>
 
 namespace Starlet {
 	namespace Scene {
@@ -11,18 +25,111 @@ namespace Starlet {
 	}
 
 	namespace Graphics {
+		class JobSystem;
+
 		class Renderer {
 		public:
-			Renderer(ResourceManager& rm) : lightRenderer(uniforms), cameraRenderer(uniforms), modelRenderer(uniforms, rm) {}
+			Renderer(ResourceManager& rm) : resourceManager(rm), variants(uniforms, state), lightRenderer(uniforms, stats, state), modelRenderer(uniforms, rm, variants, state, stats, frameArena, drawErrors), cameraRenderer(uniforms, stats), skyboxRenderer(rm, state, stats), depthPrepass(state, stats, frameArena) {}
 
 			bool init(const unsigned int program);
-			void renderFrame(const unsigned int program, const Scene::Scene& scene, const float aspect) const;
+			bool initVariants(ShaderManager& sm, const std::string& programName);
+			void disableVariants() { variants.disable(); }
+
+			// Extracts the scene into the renderer's own world first, use the RenderWorld overload with a RenderWorldBuffer
+			// to extract on another thread
+			void renderFrame(const unsigned int program, const Scene::Scene& scene, const float aspect);
+			void renderFrame(const unsigned int program, const RenderWorld& world, const float aspect);
+
+			uint32_t getProgramSwitches() const { return variants.getSwitchCount(); }
+
+			// Shares light data through a uniform buffer with programs that declare LightBlock
+			bool enableLightBuffer(const unsigned int binding) { return lightRenderer.enableUniformBuffer(binding); }
+			void disableLightBuffer() { lightRenderer.disableUniformBuffer(); }
+
+			// Meshes carrying levels of detail (ResourceManager::setMeshLodSettings) are drawn at one chosen per instance
+			void setLodSelection(const bool enabled, const float threshold = 0.001f, const float hysteresis = 0.25f) { modelRenderer.setLodSelection(enabled, threshold, hysteresis); }
+
+			// Draws opaque depth first with a position-only program, then shades with GL_EQUAL so hidden pixels are not shaded.
+			// Pays off with heavy fragment work and overlapping geometry, FrameStats::prepass* report its cost.
+			// Turns on ShaderManager::setInvariantPosition, model programs built before this call are shaded with GL_LEQUAL
+			// instead since their depth may differ in the last bits.
+			bool enableDepthPrepass(ShaderManager& sm);
+			void disableDepthPrepass() { depthPrepassEnabled = false; }
+			bool isDepthPrepassEnabled() const { return depthPrepassEnabled; }
+
+			// Rasterises the instances of registered occluder meshes on the CPU each frame and skips models hidden behind them
+			void enableOcclusionCulling(const uint32_t width = 256, const uint32_t height = 128);
+			void disableOcclusionCulling();
+			SoftwareOcclusion& getOcclusion() { return occlusion; }
+
+			// Drops lights whose influence sphere misses the frustum, cutoff is the intensity where a light's range ends
+			void setLightCulling(const bool enabled) { lightRenderer.setCulling(enabled); }
+			void setLightCutoff(const float intensity) { lightRenderer.setInfluenceCutoff(intensity); clusters.setCutoff(intensity); }
+
+			// Assigns lights to view clusters each frame and binds the lists as storage buffers at bindingBase..+2
+			bool enableLightClusters(const unsigned int bindingBase);
+			void disableLightClusters();
+			LightClusters& getLightClusters() { return clusters; }
+
+			// Draw packets are prepared as jobs when set, otherwise inline on the GL thread
+			void setJobSystem(JobSystem* js) { jobs = js; }
+
+			// State the renderer draws with, issued vs skipped counters cover the last renderFrame
+			GLStateManager& getGLState() { return state; }
+			const GLStateStats& getGLStateStats() const { return state.getStats(); }
+
+			// Draws skipped for missing resources are summarised in one log line at most every interval seconds
+			void setErrorReportInterval(const double seconds) { drawErrors.setInterval(seconds); }
+			const DrawErrorCounts& getDrawErrors() const { return drawErrors.getLastFrame(); }
+
+			const FrameStats& getFrameStats() const { return stats; }
+			void setStatsHistory(const size_t frames) { history.setCapacity(frames); }
+			const FrameStatsHistory& getStatsHistory() const { return history; }
+
+			// The opaque and transparent packet queues, their sort keys and the pre-pass order come from the arena, reset at the start of every renderFrame.
+			// FrameStats::heapAllocations only counts once the application hooks operator new, see heap_counter.hpp
+			FrameArena& getFrameArena() { return frameArena; }
+			void setAllocationCheck(const bool enabled) { allocationCheck = enabled; }
+
+			// Scopes each pass, GPU timers resolve a few frames late, see Profiler::FRAME_LATENCY
+			bool enableProfiling(const bool gpuTimers);
+			void disableProfiling() { profiler.setEnabled(false); }
+			Profiler& getProfiler() { return profiler; }
 
 		private:
+			void drawPasses(const unsigned int program, const RenderWorld& world, const float aspect);
+
+			ResourceManager& resourceManager;
 			UniformCache uniforms;
+			FrameArena frameArena;
+			bool allocationCheck{ false };
+			GLStateManager state;
+			FrameStats stats;
+			FrameStatsHistory history;
+			DrawErrorReport drawErrors;
+			Profiler profiler;
+			JobSystem* jobs{ nullptr };
+			SoftwareOcclusion occlusion;
+			bool occlusionEnabled{ false };
+			LightClusters clusters;
+			bool clustersEnabled{ false };
+			RenderWorldExtractor extractor;
+			RenderWorld sceneWorld;
+			ProgramVariants variants;
 			LightRenderer lightRenderer;
 			ModelRenderer modelRenderer;
 			CameraRenderer cameraRenderer;
+			SkyboxRenderer skyboxRenderer;
+			DepthPrepass depthPrepass;
+			bool depthPrepassEnabled{ false };
+			const ShaderManager* prepassShaders{ nullptr };
+
+			// Per-frame values re-uploaded to each specialised program on its first bind
+			struct FrameContext {
+				const RenderWorld* world{ nullptr };
+				Math::Vec3<float> eye;
+				Math::Mat4 view, projection;
+			} frame;
 		};
 	}
 }
\ No newline at end of file
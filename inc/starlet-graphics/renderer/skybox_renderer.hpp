@@ -0,0 +1,46 @@
+#pragma once
+
+#include "starlet-graphics/resource/shader_gpu.hpp"
+#include "starlet-graphics/handler/shader_handler.hpp"
+
+namespace Starlet {
+	namespace Math {
+		struct Mat4;
+	}
+
+	namespace Graphics {
+		class ResourceManager;
+		class GLStateManager;
+		struct FrameStats;
+		struct RenderSkybox;
+
+		// Draws the cube map behind everything with a built-in unit cube and program, no scene mesh or model uniforms.
+		// The vertex shader drops the view translation and writes depth at the far plane, so drawn after the opaque pass
+		// with GL_LEQUAL every pixel already covered is rejected before shading.
+		class SkyboxRenderer {
+		public:
+			SkyboxRenderer(ResourceManager& rm, GLStateManager& sm, FrameStats& fs) : resourceManager(rm), state(sm), stats(fs) {}
+			~SkyboxRenderer() { shutdown(); }
+
+			SkyboxRenderer(const SkyboxRenderer&) = delete;
+			SkyboxRenderer& operator=(const SkyboxRenderer&) = delete;
+
+			bool init();
+			void shutdown();
+			bool isReady() const { return program.programID != 0 && vao != 0; }
+
+			// False without logging when not initialised or the cube map is missing
+			bool draw(const RenderSkybox& skybox, const Math::Mat4& view, const Math::Mat4& projection);
+
+		private:
+			ResourceManager& resourceManager;
+			GLStateManager& state;
+			FrameStats& stats;
+
+			ShaderHandler handler;
+			ShaderGPU program;
+			int viewLocation{ -1 }, projLocation{ -1 };
+			unsigned int vao{ 0 }, vertexBuffer{ 0 }, indexBuffer{ 0 };
+		};
+	}
+}
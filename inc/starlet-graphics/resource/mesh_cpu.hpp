@@ -1,8 +1,11 @@
 #pragma once
 
 #include "starlet-graphics/resource/resource_cpu.hpp"
+#include "starlet-graphics/resource/mesh_lod.hpp"
 
 #include "starlet-math/vertex.hpp"
+#include <algorithm>
+#include <cmath>
 #include <vector>
 
 namespace Starlet::Graphics {
@@ -14,6 +17,35 @@ namespace Starlet::Graphics {
     bool hasNormals{ false }, hasColours{ false }, hasTexCoords{ false };
     float minY{ 0.0f }, maxY{ 0.0 };
 
+    // Filled by MeshSimplifier::buildLodChain, lods[0] is the full mesh and coarser levels follow it in indices
+    std::vector<MeshLod> lods;
+
+    // Model space, kept after upload clears the geometry
+    Math::Vec3<float> boundsMin, boundsMax;
+    float boundingRadius{ 0.0f };
+    bool hasBounds{ false };
+
+    void computeBounds() {
+      if (vertices.empty()) return;
+      boundsMin = boundsMax = vertices[0].pos;
+      float radiusSq = 0.0f;
+      for (const Math::Vertex& vertex : vertices) {
+        boundsMin = { std::min(boundsMin.x, vertex.pos.x), std::min(boundsMin.y, vertex.pos.y), std::min(boundsMin.z, vertex.pos.z) };
+        boundsMax = { std::max(boundsMax.x, vertex.pos.x), std::max(boundsMax.y, vertex.pos.y), std::max(boundsMax.z, vertex.pos.z) };
+        radiusSq = std::max(radiusSq, vertex.pos.dot(vertex.pos));
+      }
+      boundingRadius = std::sqrt(radiusSq);
+      hasBounds = true;
+    }
+
+    MeshCPU() = default;
+    // Spelled out so the members are not moved a second time, from the emptied source, after move()
+    MeshCPU(MeshCPU&& other) noexcept { move(std::move(other)); }
+    MeshCPU& operator=(MeshCPU&& other) noexcept {
+      if (this != &other) move(std::move(other));
+      return *this;
+    }
+
     bool empty() const { return vertices.empty() || indices.empty() || numVertices == 0 || numIndices == 0; }
     void move(MeshCPU&& other) {
       numVertices = other.numVertices;
@@ -26,6 +58,11 @@ namespace Starlet::Graphics {
       hasTexCoords = other.hasTexCoords;
       minY = other.minY;
       maxY = other.maxY;
+      lods = std::move(other.lods);
+      boundsMin = other.boundsMin;
+      boundsMax = other.boundsMax;
+      boundingRadius = other.boundingRadius;
+      hasBounds = other.hasBounds;
       other.vertices.clear();
       other.indices.clear();
     }
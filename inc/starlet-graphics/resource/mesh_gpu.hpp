@@ -1,13 +1,18 @@
 #pragma once
 
+#include "starlet-graphics/resource/mesh_lod.hpp"
+
 #include <cstdint>
 #include <utility>
+#include <vector>
 
 namespace Starlet::Graphics {
   struct MeshGPU {
     uint32_t VAOID{ 0 }, VertexBufferID{ 0 }, IndexBufferID{ 0 };
+    uint32_t DepthVAOID{ 0 }; // Positions alone from the same vertex and index buffers, for depth-only passes
     uint32_t numVertices{ 0 }, numIndices{ 0 };
     uint32_t VertexBuffer_Start_Index{ 0 }, IndexBuffer_Start_Index{ 0 };
+    std::vector<MeshLod> lods; // Index ranges per level of detail, empty when none were generated
 
     MeshGPU() = default;
     ~MeshGPU() = default;
@@ -21,16 +26,19 @@ namespace Starlet::Graphics {
         VAOID = other.VAOID;
         VertexBufferID = other.VertexBufferID;
         IndexBufferID = other.IndexBufferID;
+        DepthVAOID = other.DepthVAOID;
 
         numVertices = other.numVertices;
         numIndices = other.numIndices;
 
         VertexBuffer_Start_Index = other.VertexBuffer_Start_Index;
         IndexBuffer_Start_Index = other.IndexBuffer_Start_Index;
+        lods = std::move(other.lods);
 
         other.VAOID = 0;
         other.VertexBufferID = 0;
         other.IndexBufferID = 0;
+        other.DepthVAOID = 0;
       }
       return *this;
     }
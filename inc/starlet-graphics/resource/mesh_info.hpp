@@ -0,0 +1,39 @@
+#pragma once
+
+#include "starlet-graphics/resource/mesh_cpu.hpp"
+
+#include "starlet-math/vec3.hpp"
+#include <cstdint>
+
+namespace Starlet::Graphics {
+  // What the draw path needs to know about an uploaded mesh, kept in a dense array beside its MeshGPU
+  struct MeshInfo {
+    uint32_t numVertices{ 0 }, numIndices{ 0 }, numTriangles{ 0 };
+    uint32_t vertexStride{ sizeof(Math::Vertex) };
+
+    bool hasNormals{ false }, hasColours{ false }, hasTexCoords{ false };
+    bool hasBounds{ false };
+    bool retainsGeometry{ false }; // MeshManager::getMeshCPU still returns its vertices and indices
+
+    float minY{ 0.0f }, maxY{ 0.0f };
+    Math::Vec3<float> boundsMin, boundsMax;
+    float boundingRadius{ 0.0f };
+
+    static MeshInfo describe(const MeshCPU& mesh) {
+      MeshInfo info;
+      info.numVertices = mesh.numVertices;
+      info.numIndices = mesh.numIndices;
+      info.numTriangles = mesh.numTriangles;
+      info.hasNormals = mesh.hasNormals;
+      info.hasColours = mesh.hasColours;
+      info.hasTexCoords = mesh.hasTexCoords;
+      info.hasBounds = mesh.hasBounds;
+      info.minY = mesh.minY;
+      info.maxY = mesh.maxY;
+      info.boundsMin = mesh.boundsMin;
+      info.boundsMax = mesh.boundsMax;
+      info.boundingRadius = mesh.boundingRadius;
+      return info;
+    }
+  };
+}
@@ -0,0 +1,11 @@
+#pragma once
+
+#include <cstdint>
+
+namespace Starlet::Graphics {
+  // One level of detail: a range of the mesh index buffer over the shared vertices
+  struct MeshLod {
+    uint32_t firstIndex{ 0 }, numIndices{ 0 };
+    float error{ 0.0f }; // Geometric error relative to MeshCPU::boundingRadius
+  };
+}
@@ -10,6 +10,7 @@ namespace Starlet::Graphics {
     std::string fragmentSource;
     std::string vertexPath;
     std::string fragmentPath;
+    std::string defines;
     bool        valid{ false };
 
     bool empty() const { return vertexSource.empty() || fragmentSource.empty(); }
@@ -18,6 +19,7 @@ namespace Starlet::Graphics {
       fragmentSource = std::move(other.fragmentSource);
       vertexPath = std::move(other.vertexPath);
       fragmentPath = std::move(other.fragmentPath);
+      defines = std::move(other.defines);
 
       valid = other.valid;
       other.valid = false;
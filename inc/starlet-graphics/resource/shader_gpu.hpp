@@ -10,6 +10,7 @@ namespace Starlet::Graphics {
     uint32_t vertexID{ 0 };
     uint32_t fragmentID{ 0 };
     bool     linked{ false };
+    bool     invariantPosition{ false }; // Vertex shader declares "invariant gl_Position;"
 
     bool empty() const { return programID == 0 || !linked; }
 
@@ -26,9 +27,10 @@ namespace Starlet::Graphics {
         vertexID = std::move(other.vertexID);
         fragmentID = std::move(other.fragmentID);
         linked = std::move(other.linked);
+        invariantPosition = std::move(other.invariantPosition);
 
         other.programID = other.vertexID = other.fragmentID = 0;
-        other.linked = false;
+        other.linked = other.invariantPosition = false;
       }
       return *this;
     }
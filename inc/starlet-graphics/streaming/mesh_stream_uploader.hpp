@@ -0,0 +1,72 @@
+#pragma once
+
+#include "starlet-math/vertex.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Starlet::Graphics {
+	struct MeshCPU;
+	struct MeshGPU;
+	struct MeshHandler;
+
+	// Receives a mesh a chunk at a time: the producer writes rows into the memory returned by map*() and hands them
+	// back with commit*(), so nothing larger than one chunk has to exist on the CPU
+	class MeshStreamSink {
+	public:
+		virtual ~MeshStreamSink() = default;
+
+		virtual size_t getChunkBytes() const = 0;
+
+		// layout carries the counts and attribute flags, its vectors are empty
+		virtual bool begin(const MeshCPU& layout) = 0;
+		virtual Math::Vertex* mapVertices(const uint32_t count) = 0;
+		virtual bool commitVertices(const uint32_t first, const uint32_t count) = 0;
+		virtual unsigned int* mapIndices(const uint32_t count) = 0;
+		virtual bool commitIndices(const uint64_t first, const uint32_t count) = 0;
+		virtual bool finish() = 0;
+		virtual void abort() = 0;
+	};
+
+	struct MeshStreamStats {
+		uint32_t chunks{ 0 };
+		uint64_t bytesUploaded{ 0 };
+		uint64_t scratchBytes{ 0 };  // CPU memory held for chunks, the most the upload ever keeps resident
+		double milliseconds{ 0.0 };
+	};
+
+	// Allocates the mesh's buffers once at full size through MeshHandler::allocate and writes each committed chunk
+	// with glBufferSubData
+	class MeshStreamUploader : public MeshStreamSink {
+	public:
+		static constexpr size_t DEFAULT_CHUNK_BYTES{ 4u << 20 };
+
+		MeshStreamUploader(MeshHandler& mh, MeshGPU& mesh, const size_t bytes = DEFAULT_CHUNK_BYTES)
+			: handler(mh), gpu(mesh), chunkBytes(bytes ? bytes : DEFAULT_CHUNK_BYTES) {}
+
+		size_t getChunkBytes() const override { return chunkBytes; }
+
+		bool begin(const MeshCPU& layout) override;
+		Math::Vertex* mapVertices(const uint32_t count) override;
+		bool commitVertices(const uint32_t first, const uint32_t count) override;
+		unsigned int* mapIndices(const uint32_t count) override;
+		bool commitIndices(const uint64_t first, const uint32_t count) override;
+		bool finish() override;
+		void abort() override;
+
+		const MeshStreamStats& getStats() const { return stats; }
+
+	private:
+		void updateScratchBytes();
+
+		MeshHandler& handler;
+		MeshGPU& gpu;
+		size_t chunkBytes;
+
+		std::vector<Math::Vertex> vertexScratch;
+		std::vector<unsigned int> indexScratch;
+
+		MeshStreamStats stats;
+	};
+}
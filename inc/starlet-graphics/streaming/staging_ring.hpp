@@ -0,0 +1,72 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+
+namespace Starlet::Graphics {
+	class FenceSource {
+	public:
+		virtual ~FenceSource() = default;
+
+		virtual uint64_t insert() = 0;
+		virtual bool isSignaled(uint64_t fence) = 0;
+		virtual void wait(uint64_t fence) = 0;
+		virtual void release(uint64_t fence) = 0;
+	};
+
+	struct StagingAllocation {
+		uint64_t offset{ 0 };   // Byte offset into the ring buffer
+		uint64_t size{ 0 };
+		uint64_t sequence{ 0 };
+
+		bool isValid() const { return size != 0; }
+	};
+
+	// Ring allocator over a fixed-size staging buffer. Allocations are handed out in ring order,
+	// fenced in submission order by retire() and recycled once their fence signals.
+	// tryAllocate() and markSubmitted() are thread safe, retire/reclaim/allocate belong to the thread owning the fences.
+	class StagingRing {
+	public:
+		StagingRing(FenceSource& fenceSource) : fences(fenceSource) {}
+
+		void reset(uint64_t newCapacity);
+
+		bool tryAllocate(uint64_t size, uint64_t alignment, StagingAllocation& out);
+		bool allocate(uint64_t size, uint64_t alignment, StagingAllocation& out);
+		void markSubmitted(const StagingAllocation& allocation);
+
+		void retire();
+		void reclaim();
+		void waitIdle();
+
+		uint64_t getCapacity() const { return capacity; }
+		uint64_t getUsed() const;
+		size_t getFencesInFlight() const;
+
+	private:
+		struct Pending {
+			uint64_t end{ 0 };
+			bool submitted{ false };
+		};
+
+		struct Region {
+			uint64_t end{ 0 };
+			uint64_t fence{ 0 };
+		};
+
+		bool allocateLocked(uint64_t size, uint64_t alignment, StagingAllocation& out);
+
+		FenceSource& fences;
+		mutable std::mutex mutex;
+
+		uint64_t capacity{ 0 };
+		uint64_t head{ 0 }, tail{ 0 }; // Monotonic byte counters, ring position is counter % capacity
+		uint64_t retired{ 0 };
+
+		uint64_t frontSequence{ 0 }, nextSequence{ 0 };
+		std::deque<Pending> pending;
+		std::deque<Region> regions;
+	};
+}
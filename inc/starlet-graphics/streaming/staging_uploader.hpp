@@ -0,0 +1,70 @@
+#pragma once
+
+#include "starlet-graphics/streaming/staging_ring.hpp"
+
+#include <cstdint>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace Starlet::Graphics {
+	class GLFenceSource : public FenceSource {
+	public:
+		~GLFenceSource() override;
+
+		uint64_t insert() override;
+		bool isSignaled(uint64_t fence) override;
+		void wait(uint64_t fence) override;
+		void release(uint64_t fence) override;
+
+	private:
+		uint64_t nextFence{ 1 };
+		std::unordered_map<uint64_t, void*> syncs;
+	};
+
+	// Persistently mapped staging buffer fed through a StagingRing.
+	// Any thread may stage() data and enqueue copies, flush() issues the GPU copies and must run on the GL thread.
+	class StagingUploader {
+	public:
+		StagingUploader() : ring(fenceSource) {}
+		~StagingUploader();
+
+		StagingUploader(const StagingUploader&) = delete;
+		StagingUploader& operator=(const StagingUploader&) = delete;
+
+		bool init(const uint64_t capacity);
+		void shutdown();
+		bool isReady() const { return mapped != nullptr; }
+
+		void* stage(const uint64_t size, StagingAllocation& out);
+		void* stage(const void* data, const uint64_t size, StagingAllocation& out);
+		void cancel(const StagingAllocation& allocation) { ring.markSubmitted(allocation); }
+
+		void enqueueTextureCopy(const StagingAllocation& allocation, const unsigned int textureID, const unsigned int target, const int level, const int width, const int height, const unsigned int format, const bool generateMIPMap);
+		void enqueueBufferCopy(const StagingAllocation& allocation, const unsigned int bufferID, const uint64_t dstOffset);
+
+		void flush();
+
+		const StagingRing& getRing() const { return ring; }
+
+	private:
+		struct CopyCommand {
+			StagingAllocation allocation;
+			unsigned int objectID{ 0 };
+			unsigned int target{ 0 }; // Texture target, 0 for buffer copies
+			int level{ 0 }, width{ 0 }, height{ 0 };
+			unsigned int format{ 0 };
+			bool generateMIPMap{ false };
+			uint64_t dstOffset{ 0 };
+		};
+
+		GLFenceSource fenceSource;
+		StagingRing ring;
+
+		unsigned int bufferID{ 0 };
+		uint8_t* mapped{ nullptr };
+
+		std::mutex queueMutex;
+		std::vector<CopyCommand> queue, submitting;
+	};
+}
@@ -0,0 +1,117 @@
+#pragma once
+
+#include "starlet-graphics/jobs/job_system.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+namespace Starlet::Graphics {
+	struct TextureCPU;
+	struct TextureGPU;
+	class GLStateManager;
+
+	struct StreamingBudget {
+		size_t uploadBytesPerFrame{ 4u * 1024u * 1024u };
+		size_t residentBytes{ 256u * 1024u * 1024u };
+		uint32_t evictAfterFrames{ 120 }; // Textures not drawn for longer drop back to their tail
+		uint32_t tailSize{ 64 }; // Mips whose largest side is <= tailSize are uploaded immediately and never evicted
+	};
+
+	struct StreamingStats {
+		size_t residentBytes{ 0 };
+		size_t uploadedBytes{ 0 };
+		uint32_t uploadedLevels{ 0 };
+		uint32_t evictedLevels{ 0 };
+		uint32_t pendingTextures{ 0 };
+		uint32_t reloads{ 0 };  // Source image decodes started this frame to restream evicted levels
+		size_t cpuBytes{ 0 };   // Pixels held on the CPU for levels not yet resident
+	};
+
+	// Decodes a texture's source image again, called when levels it evicted are needed back
+	using TextureReload = std::function<bool(TextureCPU& cpu)>;
+
+	// Each level keeps its CPU pixels only until it is resident. With a reload source they are freed after upload and an
+	// evicted level is rebuilt from the source, without one they stay so evicted levels can stream back.
+	// Reloads decode and rebuild the mip chain on the load jobs when set, update() uploads the levels once they are ready.
+	// add() binds directly and runs at load time, update() runs inside the frame and binds through the state manager.
+	class TextureStreamer {
+	public:
+		TextureStreamer() = default;
+		~TextureStreamer();
+
+		TextureStreamer(const TextureStreamer&) = delete;
+		TextureStreamer& operator=(const TextureStreamer&) = delete;
+
+		// Must outlive the streamer, or be cleared with nullptr first
+		void setLoadJobs(JobSystem* jobs) { loadJobs = jobs; }
+
+		void setBudget(const StreamingBudget& newBudget) { budget = newBudget; }
+		const StreamingBudget& getBudget() const { return budget; }
+
+		bool add(TextureCPU& cpu, TextureGPU& gpu, TextureReload reload = {});
+		void remove(uint32_t textureID);
+
+		void markUsed(uint32_t textureID);
+		void update(GLStateManager& state);
+
+		const StreamingStats& getStats() const { return stats; }
+
+	private:
+		struct MipLevel {
+			int32_t width{ 0 }, height{ 0 };
+			std::vector<uint8_t> pixels;
+		};
+
+		// Owned by the entry and handed to a load job, so it stays put while entries move
+		struct PendingReload {
+			TextureReload reload;
+			int32_t width{ 0 }, height{ 0 };
+			uint8_t pixelSize{ 0 };
+			std::vector<MipLevel> levels;
+			bool ok{ false };
+			JobCounter counter;
+		};
+
+		struct Entry {
+			uint32_t id{ 0 };
+			uint8_t pixelSize{ 0 };
+			std::vector<MipLevel> levels;
+			int tailLevel{ 0 };     // First level of the always resident tail
+			int residentLevel{ 0 }; // Finest level currently resident, levels [residentLevel, levels.size()) are on the GPU
+			uint64_t lastUsedFrame{ 0 };
+			uint32_t usesThisFrame{ 0 };
+			TextureReload reload;
+			std::unique_ptr<PendingReload> reloading; // Decode in flight, levels below residentLevel wait for it
+			bool failed{ false }; // A reload failed, the texture stays at its current level
+		};
+
+		static void buildMipChain(const TextureCPU& cpu, std::vector<MipLevel>& levelsOut);
+		static size_t levelBytes(const Entry& entry, int level);
+
+		// Both expect the texture bound to GL_TEXTURE_2D on the active unit, errors are read once per add() or update()
+		static void uploadLevel(Entry& entry, int level);
+		static void setResidentRange(const Entry& entry);
+
+		static void decodeReload(const Job& job);
+		bool reloadLevels(Entry& entry);
+		void finishReload(Entry& entry);
+		void evictLevel(GLStateManager& state, Entry& entry);
+
+		void evictStale(GLStateManager& state);
+		void evictOverBudget(GLStateManager& state);
+		void streamPending(GLStateManager& state);
+
+		StreamingBudget budget;
+		StreamingStats stats;
+		JobSystem* loadJobs{ nullptr };
+		uint64_t frame{ 0 };
+
+		std::vector<Entry> entries;
+		std::vector<Entry*> queue; // Scratch for streamPending, kept so steady frames do not allocate
+		std::unordered_map<uint32_t, size_t> idToEntry;
+	};
+}
@@ -4,11 +4,13 @@ namespace Starlet::Graphics {
 	class Cache {
 	public:
 		void setProgram(unsigned int programID) { program = programID; }
+		void setSpecialised(bool isSpecialised) { specialised = isSpecialised; }
 		virtual bool cacheLocations() = 0;
 		virtual ~Cache() = default;
 
 	protected:
 		unsigned int program{ 0 };
+		bool specialised{ false }; // Variant programs may compile uniforms out, missing locations are not errors
 		bool getUniformLocation(int& location, const char* name) const;
 	};
 }
\ No newline at end of file
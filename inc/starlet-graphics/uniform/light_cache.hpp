@@ -2,6 +2,9 @@
 
 #include "starlet-graphics/uniform/cache.hpp"
 
+#include <cstddef>
+#include <vector>
+
 namespace Starlet::Graphics {
 	struct LightUL {
 		int position_UL{ -1 };
@@ -14,14 +17,22 @@ namespace Starlet::Graphics {
 
 	class LightCache : public Cache {
 	public:
+		// theLights[] entries are probed until one is missing, up to this many
+		static constexpr unsigned int MAX_LIGHTS{ 64 };
+		static constexpr unsigned int NO_BLOCK{ 0xFFFFFFFF }; // GL_INVALID_INDEX
+
 		bool cacheLocations() override;
 		int getLightCountLocation() const { return lightCountLocation; }
 		int getAmbientLightLocation() const { return ambientLightLocation; }
-		const LightUL& getLightUL() const { return uniform; }
+		unsigned int getLightBlockIndex() const { return lightBlockIndex; }
+
+		size_t getLightSlots() const { return lights.size(); }
+		const LightUL& getLightUL(const size_t index) const { return lights[index]; }
 
 	private:
 		int lightCountLocation{ -1 };
 		int ambientLightLocation{ -1 };
-		LightUL uniform;
+		unsigned int lightBlockIndex{ NO_BLOCK };
+		std::vector<LightUL> lights;
 	};
 }
\ No newline at end of file
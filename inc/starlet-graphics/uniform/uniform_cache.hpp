@@ -4,11 +4,16 @@
 #include "starlet-graphics/uniform/light_cache.hpp"
 #include "starlet-graphics/uniform/camera_cache.hpp"
 
+#include <unordered_map>
+
 namespace Starlet::Graphics {
 	class UniformCache {
 	public:
 		bool setProgram(unsigned int programID);
+		void setSpecialised(bool specialised);
 		bool cacheAllLocations();
+		bool switchProgram(unsigned int programID, bool specialised);
+		unsigned int getProgram() const { return program; }
 
 		const ModelCache& getModelCache() const { return modelCache; }
 		const LightCache& getLightCache() const { return lightCache; }
@@ -19,5 +24,12 @@ namespace Starlet::Graphics {
 		ModelCache modelCache;
 		LightCache lightCache;
 		CameraCache cameraCache;
+
+		struct ProgramLocations {
+			ModelCache model;
+			LightCache light;
+			CameraCache camera;
+		};
+		std::unordered_map<unsigned int, ProgramLocations> programLocations;
 	};
 }
\ No newline at end of file
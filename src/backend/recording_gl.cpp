@@ -0,0 +1,469 @@
+#include "starlet-graphics/backend/recording_gl.hpp"
+#include "starlet-logger/logger.hpp"
+
+#include <glad/glad.h>
+
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
+#ifndef GL_COMPLETION_STATUS_KHR
+#define GL_COMPLETION_STATUS_KHR 0x91B1
+#endif
+
+#define STARLET_RECORDING_GL_ENTRY_POINTS(X) \
+	X(ActiveTexture, PFNGLACTIVETEXTUREPROC) \
+	X(AttachShader, PFNGLATTACHSHADERPROC) \
+	X(BeginQuery, PFNGLBEGINQUERYPROC) \
+	X(BindBuffer, PFNGLBINDBUFFERPROC) \
+	X(BindBufferBase, PFNGLBINDBUFFERBASEPROC) \
+	X(BindTexture, PFNGLBINDTEXTUREPROC) \
+	X(BindVertexArray, PFNGLBINDVERTEXARRAYPROC) \
+	X(BlendFunc, PFNGLBLENDFUNCPROC) \
+	X(BufferData, PFNGLBUFFERDATAPROC) \
+	X(BufferStorage, PFNGLBUFFERSTORAGEPROC) \
+	X(BufferSubData, PFNGLBUFFERSUBDATAPROC) \
+	X(Clear, PFNGLCLEARPROC) \
+	X(ClearColor, PFNGLCLEARCOLORPROC) \
+	X(ClientWaitSync, PFNGLCLIENTWAITSYNCPROC) \
+	X(ColorMask, PFNGLCOLORMASKPROC) \
+	X(CompileShader, PFNGLCOMPILESHADERPROC) \
+	X(CopyBufferSubData, PFNGLCOPYBUFFERSUBDATAPROC) \
+	X(CreateProgram, PFNGLCREATEPROGRAMPROC) \
+	X(CreateShader, PFNGLCREATESHADERPROC) \
+	X(CullFace, PFNGLCULLFACEPROC) \
+	X(DeleteBuffers, PFNGLDELETEBUFFERSPROC) \
+	X(DeleteProgram, PFNGLDELETEPROGRAMPROC) \
+	X(DeleteQueries, PFNGLDELETEQUERIESPROC) \
+	X(DeleteShader, PFNGLDELETESHADERPROC) \
+	X(DeleteSync, PFNGLDELETESYNCPROC) \
+	X(DeleteTextures, PFNGLDELETETEXTURESPROC) \
+	X(DeleteVertexArrays, PFNGLDELETEVERTEXARRAYSPROC) \
+	X(DepthFunc, PFNGLDEPTHFUNCPROC) \
+	X(DepthMask, PFNGLDEPTHMASKPROC) \
+	X(DetachShader, PFNGLDETACHSHADERPROC) \
+	X(Disable, PFNGLDISABLEPROC) \
+	X(DrawElements, PFNGLDRAWELEMENTSPROC) \
+	X(DrawElementsBaseVertex, PFNGLDRAWELEMENTSBASEVERTEXPROC) \
+	X(Enable, PFNGLENABLEPROC) \
+	X(EnableVertexAttribArray, PFNGLENABLEVERTEXATTRIBARRAYPROC) \
+	X(EndQuery, PFNGLENDQUERYPROC) \
+	X(FenceSync, PFNGLFENCESYNCPROC) \
+	X(GenBuffers, PFNGLGENBUFFERSPROC) \
+	X(GenQueries, PFNGLGENQUERIESPROC) \
+	X(GenTextures, PFNGLGENTEXTURESPROC) \
+	X(GenVertexArrays, PFNGLGENVERTEXARRAYSPROC) \
+	X(GenerateMipmap, PFNGLGENERATEMIPMAPPROC) \
+	X(GetAttachedShaders, PFNGLGETATTACHEDSHADERSPROC) \
+	X(GetError, PFNGLGETERRORPROC) \
+	X(GetInteger64v, PFNGLGETINTEGER64VPROC) \
+	X(GetIntegerv, PFNGLGETINTEGERVPROC) \
+	X(GetProgramBinary, PFNGLGETPROGRAMBINARYPROC) \
+	X(GetProgramInfoLog, PFNGLGETPROGRAMINFOLOGPROC) \
+	X(GetProgramiv, PFNGLGETPROGRAMIVPROC) \
+	X(GetQueryObjectiv, PFNGLGETQUERYOBJECTIVPROC) \
+	X(GetQueryObjectui64v, PFNGLGETQUERYOBJECTUI64VPROC) \
+	X(GetShaderInfoLog, PFNGLGETSHADERINFOLOGPROC) \
+	X(GetShaderiv, PFNGLGETSHADERIVPROC) \
+	X(GetString, PFNGLGETSTRINGPROC) \
+	X(GetStringi, PFNGLGETSTRINGIPROC) \
+	X(GetUniformBlockIndex, PFNGLGETUNIFORMBLOCKINDEXPROC) \
+	X(GetUniformLocation, PFNGLGETUNIFORMLOCATIONPROC) \
+	X(IsBuffer, PFNGLISBUFFERPROC) \
+	X(IsProgram, PFNGLISPROGRAMPROC) \
+	X(IsShader, PFNGLISSHADERPROC) \
+	X(IsVertexArray, PFNGLISVERTEXARRAYPROC) \
+	X(LinkProgram, PFNGLLINKPROGRAMPROC) \
+	X(MapBufferRange, PFNGLMAPBUFFERRANGEPROC) \
+	X(PixelStorei, PFNGLPIXELSTOREIPROC) \
+	X(PolygonMode, PFNGLPOLYGONMODEPROC) \
+	X(PopDebugGroup, PFNGLPOPDEBUGGROUPPROC) \
+	X(ProgramBinary, PFNGLPROGRAMBINARYPROC) \
+	X(ProgramParameteri, PFNGLPROGRAMPARAMETERIPROC) \
+	X(PushDebugGroup, PFNGLPUSHDEBUGGROUPPROC) \
+	X(QueryCounter, PFNGLQUERYCOUNTERPROC) \
+	X(ShaderSource, PFNGLSHADERSOURCEPROC) \
+	X(TexImage2D, PFNGLTEXIMAGE2DPROC) \
+	X(TexParameteri, PFNGLTEXPARAMETERIPROC) \
+	X(TexSubImage2D, PFNGLTEXSUBIMAGE2DPROC) \
+	X(Uniform1f, PFNGLUNIFORM1FPROC) \
+	X(Uniform1i, PFNGLUNIFORM1IPROC) \
+	X(Uniform2f, PFNGLUNIFORM2FPROC) \
+	X(Uniform3f, PFNGLUNIFORM3FPROC) \
+	X(Uniform3fv, PFNGLUNIFORM3FVPROC) \
+	X(Uniform4f, PFNGLUNIFORM4FPROC) \
+	X(Uniform4fv, PFNGLUNIFORM4FVPROC) \
+	X(UniformBlockBinding, PFNGLUNIFORMBLOCKBINDINGPROC) \
+	X(UniformMatrix4fv, PFNGLUNIFORMMATRIX4FVPROC) \
+	X(UnmapBuffer, PFNGLUNMAPBUFFERPROC) \
+	X(UseProgram, PFNGLUSEPROGRAMPROC) \
+	X(VertexAttribPointer, PFNGLVERTEXATTRIBPOINTERPROC) \
+	X(Viewport, PFNGLVIEWPORTPROC)
+
+namespace Starlet::Graphics {
+	RecordingGL* RecordingGL::active{ nullptr };
+
+	struct RecordingGL::SavedEntryPoints {
+#define STARLET_SAVED_MEMBER(name, type) type name{ nullptr };
+		STARLET_RECORDING_GL_ENTRY_POINTS(STARLET_SAVED_MEMBER)
+#undef STARLET_SAVED_MEMBER
+	};
+
+	namespace {
+		int64_t ptr(const void* p) { return static_cast<int64_t>(reinterpret_cast<intptr_t>(p)); }
+	}
+
+	struct RecordingGLHooks {
+		static RecordingGL& gl() { return *RecordingGL::active; }
+		static void generate(GLsizei n, GLuint* out) {
+			for (GLsizei i = 0; i < n; ++i) out[i] = gl().nextName();
+		}
+
+		static void APIENTRY ActiveTexture(GLenum texture) { gl().push("glActiveTexture", { texture }); }
+		static void APIENTRY AttachShader(GLuint program, GLuint shader) { gl().push("glAttachShader", { program, shader }); }
+		static void APIENTRY BeginQuery(GLenum target, GLuint id) { gl().push("glBeginQuery", { target, id }); }
+		static void APIENTRY BindBuffer(GLenum target, GLuint buffer) {
+			gl().boundBuffers[target] = buffer;
+			gl().push("glBindBuffer", { target, buffer });
+		}
+		static void APIENTRY BindBufferBase(GLenum target, GLuint index, GLuint buffer) {
+			gl().boundBuffers[target] = buffer;
+			gl().push("glBindBufferBase", { target, index, buffer });
+		}
+		static void APIENTRY BindTexture(GLenum target, GLuint texture) { gl().push("glBindTexture", { target, texture }); }
+		static void APIENTRY BindVertexArray(GLuint array) { gl().push("glBindVertexArray", { array }); }
+		static void APIENTRY BlendFunc(GLenum sfactor, GLenum dfactor) { gl().push("glBlendFunc", { sfactor, dfactor }); }
+		static void APIENTRY BufferData(GLenum target, GLsizeiptr size, const void*, GLenum usage) { gl().push("glBufferData", { target, size, usage }); }
+		static void APIENTRY BufferStorage(GLenum target, GLsizeiptr size, const void*, GLbitfield flags) {
+			gl().bufferStorage[gl().boundBuffers[target]].assign(static_cast<size_t>(size), 0);
+			gl().push("glBufferStorage", { target, size, flags });
+		}
+		static void APIENTRY BufferSubData(GLenum target, GLintptr offset, GLsizeiptr size, const void*) { gl().push("glBufferSubData", { target, offset, size }); }
+		static void APIENTRY Clear(GLbitfield mask) { gl().push("glClear", { mask }); }
+		static void APIENTRY ClearColor(GLfloat r, GLfloat g, GLfloat b, GLfloat a) { gl().push("glClearColor", {}, { r, g, b, a }); }
+		static GLenum APIENTRY ClientWaitSync(GLsync sync, GLbitfield flags, GLuint64 timeout) {
+			gl().push("glClientWaitSync", { ptr(sync), flags, static_cast<int64_t>(timeout) });
+			return GL_ALREADY_SIGNALED;
+		}
+		static void APIENTRY ColorMask(GLboolean r, GLboolean g, GLboolean b, GLboolean a) { gl().push("glColorMask", { r, g, b, a }); }
+		static void APIENTRY CompileShader(GLuint shader) { gl().push("glCompileShader", { shader }); }
+		static void APIENTRY CopyBufferSubData(GLenum readTarget, GLenum writeTarget, GLintptr readOffset, GLintptr writeOffset, GLsizeiptr size) {
+			gl().push("glCopyBufferSubData", { readTarget, writeTarget, readOffset, writeOffset, size });
+		}
+		static GLuint APIENTRY CreateProgram() {
+			const GLuint id = gl().nextName();
+			gl().push("glCreateProgram", { id });
+			return id;
+		}
+		static GLuint APIENTRY CreateShader(GLenum type) {
+			const GLuint id = gl().nextName();
+			gl().push("glCreateShader", { type, id });
+			return id;
+		}
+		static void APIENTRY CullFace(GLenum mode) { gl().push("glCullFace", { mode }); }
+		static void APIENTRY DeleteBuffers(GLsizei n, const GLuint* buffers) {
+			for (GLsizei i = 0; i < n; ++i) gl().bufferStorage.erase(buffers[i]);
+			gl().push("glDeleteBuffers", { n });
+		}
+		static void APIENTRY DeleteProgram(GLuint program) { gl().push("glDeleteProgram", { program }); }
+		static void APIENTRY DeleteQueries(GLsizei n, const GLuint*) { gl().push("glDeleteQueries", { n }); }
+		static void APIENTRY DeleteShader(GLuint shader) { gl().push("glDeleteShader", { shader }); }
+		static void APIENTRY DeleteSync(GLsync sync) { gl().push("glDeleteSync", { ptr(sync) }); }
+		static void APIENTRY DeleteTextures(GLsizei n, const GLuint*) { gl().push("glDeleteTextures", { n }); }
+		static void APIENTRY DeleteVertexArrays(GLsizei n, const GLuint*) { gl().push("glDeleteVertexArrays", { n }); }
+		static void APIENTRY DepthFunc(GLenum func) { gl().push("glDepthFunc", { func }); }
+		static void APIENTRY DepthMask(GLboolean flag) { gl().push("glDepthMask", { flag }); }
+		static void APIENTRY DetachShader(GLuint program, GLuint shader) { gl().push("glDetachShader", { program, shader }); }
+		static void APIENTRY Disable(GLenum cap) { gl().push("glDisable", { cap }); }
+		static void APIENTRY DrawElements(GLenum mode, GLsizei count, GLenum type, const void* indices) {
+			++gl().drawCalls;
+			gl().push("glDrawElements", { mode, count, type, ptr(indices) });
+		}
+		static void APIENTRY DrawElementsBaseVertex(GLenum mode, GLsizei count, GLenum type, const void* indices, GLint baseVertex) {
+			++gl().drawCalls;
+			gl().push("glDrawElementsBaseVertex", { mode, count, type, ptr(indices), baseVertex });
+		}
+		static void APIENTRY Enable(GLenum cap) { gl().push("glEnable", { cap }); }
+		static void APIENTRY EnableVertexAttribArray(GLuint index) { gl().push("glEnableVertexAttribArray", { index }); }
+		static void APIENTRY EndQuery(GLenum target) { gl().push("glEndQuery", { target }); }
+		static GLsync APIENTRY FenceSync(GLenum condition, GLbitfield flags) {
+			GLsync sync = reinterpret_cast<GLsync>(static_cast<intptr_t>(gl().nextName()));
+			gl().push("glFenceSync", { condition, flags, ptr(sync) });
+			return sync;
+		}
+		static void APIENTRY GenBuffers(GLsizei n, GLuint* buffers) {
+			generate(n, buffers);
+			gl().push("glGenBuffers", { n, buffers[0] });
+		}
+		static void APIENTRY GenQueries(GLsizei n, GLuint* ids) {
+			generate(n, ids);
+			gl().push("glGenQueries", { n, ids[0] });
+		}
+		static void APIENTRY GenTextures(GLsizei n, GLuint* textures) {
+			generate(n, textures);
+			gl().push("glGenTextures", { n, textures[0] });
+		}
+		static void APIENTRY GenVertexArrays(GLsizei n, GLuint* arrays) {
+			generate(n, arrays);
+			gl().push("glGenVertexArrays", { n, arrays[0] });
+		}
+		static void APIENTRY GenerateMipmap(GLenum target) { gl().push("glGenerateMipmap", { target }); }
+		static void APIENTRY GetAttachedShaders(GLuint program, GLsizei, GLsizei* count, GLuint*) {
+			if (count) *count = 0;
+			gl().push("glGetAttachedShaders", { program });
+		}
+		static GLenum APIENTRY GetError() { return GL_NO_ERROR; }
+		static void APIENTRY GetInteger64v(GLenum pname, GLint64* data) {
+			std::map<unsigned int, int>::const_iterator it = gl().integers.find(pname);
+			*data = (it == gl().integers.end()) ? 0 : it->second;
+			gl().push("glGetInteger64v", { pname });
+		}
+		static void APIENTRY GetIntegerv(GLenum pname, GLint* data) {
+			std::map<unsigned int, int>::const_iterator it = gl().integers.find(pname);
+			*data = (it == gl().integers.end()) ? 0 : it->second;
+			gl().push("glGetIntegerv", { pname });
+		}
+		static void APIENTRY GetProgramBinary(GLuint program, GLsizei, GLsizei* length, GLenum* format, void*) {
+			if (length) *length = 0;
+			if (format) *format = 0;
+			gl().push("glGetProgramBinary", { program });
+		}
+		static void APIENTRY GetProgramInfoLog(GLuint, GLsizei bufSize, GLsizei* length, GLchar* log) {
+			if (length) *length = 0;
+			if (log && bufSize > 0) log[0] = '\0';
+		}
+		static void APIENTRY GetProgramiv(GLuint program, GLenum pname, GLint* params) {
+			switch (pname) {
+			case GL_LINK_STATUS:           *params = gl().linkStatus ? GL_TRUE : GL_FALSE; break;
+			case GL_COMPLETION_STATUS_KHR: *params = gl().completionStatus ? GL_TRUE : GL_FALSE; break;
+			default:                       *params = 0; break;
+			}
+			gl().push("glGetProgramiv", { program, pname });
+		}
+		static void APIENTRY GetQueryObjectiv(GLuint id, GLenum pname, GLint* params) {
+			*params = (pname == GL_QUERY_RESULT_AVAILABLE) ? GL_TRUE : 0;
+			gl().push("glGetQueryObjectiv", { id, pname });
+		}
+		static void APIENTRY GetQueryObjectui64v(GLuint id, GLenum pname, GLuint64* params) {
+			*params = 0;
+			gl().push("glGetQueryObjectui64v", { id, pname });
+		}
+		static void APIENTRY GetShaderInfoLog(GLuint, GLsizei bufSize, GLsizei* length, GLchar* log) {
+			if (length) *length = 0;
+			if (log && bufSize > 0) log[0] = '\0';
+		}
+		static void APIENTRY GetShaderiv(GLuint shader, GLenum pname, GLint* params) {
+			*params = (pname == GL_COMPILE_STATUS) ? (gl().compileStatus ? GL_TRUE : GL_FALSE) : 0;
+			gl().push("glGetShaderiv", { shader, pname });
+		}
+		static const GLubyte* APIENTRY GetString(GLenum name) {
+			switch (name) {
+			case GL_VENDOR:   return reinterpret_cast<const GLubyte*>("Starlet");
+			case GL_RENDERER: return reinterpret_cast<const GLubyte*>("RecordingGL");
+			case GL_VERSION:  return reinterpret_cast<const GLubyte*>("4.6 RecordingGL");
+			default:          return reinterpret_cast<const GLubyte*>("");
+			}
+		}
+		static const GLubyte* APIENTRY GetStringi(GLenum name, GLuint index) {
+			const std::vector<std::string>& extensions = gl().extensions;
+			if (name != GL_EXTENSIONS || index >= extensions.size()) return reinterpret_cast<const GLubyte*>("");
+			return reinterpret_cast<const GLubyte*>(extensions[index].c_str());
+		}
+		static GLuint APIENTRY GetUniformBlockIndex(GLuint program, const GLchar*) {
+			gl().push("glGetUniformBlockIndex", { program });
+			return GL_INVALID_INDEX;
+		}
+		static GLint APIENTRY GetUniformLocation(GLuint program, const GLchar* name) {
+			const std::string key = std::to_string(program) + ":" + name;
+			std::map<std::string, int>::iterator it = gl().uniformLocations.find(key);
+			if (it == gl().uniformLocations.end())
+				it = gl().uniformLocations.emplace(key, static_cast<int>(gl().uniformLocations.size())).first;
+			gl().push("glGetUniformLocation", { program, it->second });
+			return it->second;
+		}
+		static GLboolean APIENTRY IsBuffer(GLuint buffer) { return buffer ? GL_TRUE : GL_FALSE; }
+		static GLboolean APIENTRY IsProgram(GLuint program) { return program ? GL_TRUE : GL_FALSE; }
+		static GLboolean APIENTRY IsShader(GLuint shader) { return shader ? GL_TRUE : GL_FALSE; }
+		static GLboolean APIENTRY IsVertexArray(GLuint array) { return array ? GL_TRUE : GL_FALSE; }
+		static void APIENTRY LinkProgram(GLuint program) { gl().push("glLinkProgram", { program }); }
+		static void* APIENTRY MapBufferRange(GLenum target, GLintptr offset, GLsizeiptr length, GLbitfield access) {
+			std::vector<unsigned char>& storage = gl().bufferStorage[gl().boundBuffers[target]];
+			if (storage.size() < static_cast<size_t>(offset + length)) storage.resize(static_cast<size_t>(offset + length));
+			gl().push("glMapBufferRange", { target, offset, length, access });
+			return storage.data() + offset;
+		}
+		static void APIENTRY PixelStorei(GLenum pname, GLint param) { gl().push("glPixelStorei", { pname, param }); }
+		static void APIENTRY PolygonMode(GLenum face, GLenum mode) { gl().push("glPolygonMode", { face, mode }); }
+		static void APIENTRY PopDebugGroup() { gl().push("glPopDebugGroup", {}); }
+		static void APIENTRY ProgramBinary(GLuint program, GLenum format, const void*, GLsizei length) { gl().push("glProgramBinary", { program, format, length }); }
+		static void APIENTRY ProgramParameteri(GLuint program, GLenum pname, GLint value) { gl().push("glProgramParameteri", { program, pname, value }); }
+		static void APIENTRY PushDebugGroup(GLenum source, GLuint id, GLsizei, const GLchar*) { gl().push("glPushDebugGroup", { source, id }); }
+		static void APIENTRY QueryCounter(GLuint id, GLenum target) { gl().push("glQueryCounter", { id, target }); }
+		static void APIENTRY ShaderSource(GLuint shader, GLsizei count, const GLchar* const*, const GLint*) { gl().push("glShaderSource", { shader, count }); }
+		static void APIENTRY TexImage2D(GLenum target, GLint level, GLint internalFormat, GLsizei width, GLsizei height, GLint border, GLenum format, GLenum type, const void*) {
+			gl().push("glTexImage2D", { target, level, internalFormat, width, height, border, format, type });
+		}
+		static void APIENTRY TexParameteri(GLenum target, GLenum pname, GLint param) { gl().push("glTexParameteri", { target, pname, param }); }
+		static void APIENTRY TexSubImage2D(GLenum target, GLint level, GLint x, GLint y, GLsizei width, GLsizei height, GLenum format, GLenum type, const void* pixels) {
+			gl().push("glTexSubImage2D", { target, level, x, y, width, height, format, type, ptr(pixels) });
+		}
+		static void APIENTRY Uniform1f(GLint location, GLfloat v0) { gl().push("glUniform1f", { location }, { v0 }); }
+		static void APIENTRY Uniform1i(GLint location, GLint v0) { gl().push("glUniform1i", { location, v0 }); }
+		static void APIENTRY Uniform2f(GLint location, GLfloat v0, GLfloat v1) { gl().push("glUniform2f", { location }, { v0, v1 }); }
+		static void APIENTRY Uniform3f(GLint location, GLfloat v0, GLfloat v1, GLfloat v2) { gl().push("glUniform3f", { location }, { v0, v1, v2 }); }
+		static void APIENTRY Uniform3fv(GLint location, GLsizei count, const GLfloat* value) {
+			gl().push("glUniform3fv", { location, count }, value, 3 * static_cast<size_t>(count));
+		}
+		static void APIENTRY Uniform4f(GLint location, GLfloat v0, GLfloat v1, GLfloat v2, GLfloat v3) { gl().push("glUniform4f", { location }, { v0, v1, v2, v3 }); }
+		static void APIENTRY Uniform4fv(GLint location, GLsizei count, const GLfloat* value) {
+			gl().push("glUniform4fv", { location, count }, value, 4 * static_cast<size_t>(count));
+		}
+		static void APIENTRY UniformBlockBinding(GLuint program, GLuint index, GLuint binding) { gl().push("glUniformBlockBinding", { program, index, binding }); }
+		static void APIENTRY UniformMatrix4fv(GLint location, GLsizei count, GLboolean transpose, const GLfloat* value) {
+			gl().push("glUniformMatrix4fv", { location, count, transpose }, value, 16 * static_cast<size_t>(count));
+		}
+		static GLboolean APIENTRY UnmapBuffer(GLenum target) {
+			gl().push("glUnmapBuffer", { target });
+			return GL_TRUE;
+		}
+		static void APIENTRY UseProgram(GLuint program) { gl().push("glUseProgram", { program }); }
+		static void APIENTRY VertexAttribPointer(GLuint index, GLint size, GLenum type, GLboolean normalized, GLsizei stride, const void* pointer) {
+			gl().push("glVertexAttribPointer", { index, size, type, normalized, stride, ptr(pointer) });
+		}
+		static void APIENTRY Viewport(GLint x, GLint y, GLsizei width, GLsizei height) { gl().push("glViewport", { x, y, width, height }); }
+	};
+
+	std::string GLCommand::toString() const {
+		std::ostringstream out;
+		out << name << '(';
+		for (size_t i = 0; i < args.size(); ++i) out << (i ? ", " : "") << args[i];
+		if (!values.empty()) {
+			out << (args.empty() ? "" : ", ") << '[';
+			for (size_t i = 0; i < values.size(); ++i) {
+				char buffer[32];
+				std::snprintf(buffer, sizeof(buffer), "%.6g", static_cast<double>(values[i]));
+				out << (i ? ", " : "") << buffer;
+			}
+			out << ']';
+		}
+		out << ')';
+		return out.str();
+	}
+
+	bool RecordingGL::install() {
+		if (active == this) return true;
+		if (active) return Logger::error("RecordingGL", "install", "Another RecordingGL is already installed");
+
+		saved = new SavedEntryPoints();
+#define STARLET_INSTALL_HOOK(name, type) saved->name = glad_gl##name; glad_gl##name = &RecordingGLHooks::name;
+		STARLET_RECORDING_GL_ENTRY_POINTS(STARLET_INSTALL_HOOK)
+#undef STARLET_INSTALL_HOOK
+
+		active = this;
+		return true;
+	}
+
+	void RecordingGL::uninstall() {
+		if (active != this) return;
+
+#define STARLET_RESTORE_HOOK(name, type) glad_gl##name = saved->name;
+		STARLET_RECORDING_GL_ENTRY_POINTS(STARLET_RESTORE_HOOK)
+#undef STARLET_RESTORE_HOOK
+
+		delete saved;
+		saved = nullptr;
+		active = nullptr;
+	}
+
+	void RecordingGL::setBuildStatus(const bool compiled, const bool linked, const bool completed) {
+		compileStatus = compiled;
+		linkStatus = linked;
+		completionStatus = completed;
+	}
+
+	void RecordingGL::addExtension(const std::string& name) {
+		extensions.push_back(name);
+		integers[GL_NUM_EXTENSIONS] = static_cast<int>(extensions.size());
+	}
+
+	void RecordingGL::clear() {
+		commands.clear();
+		callCounts.clear();
+		totalCalls = 0;
+		drawCalls = 0;
+	}
+
+	void RecordingGL::push(const char* name, std::initializer_list<int64_t> args, const float* values, const size_t valueCount) {
+		++totalCalls;
+		if (!recording) return;
+
+		++callCounts[name];
+		GLCommand& command = commands.emplace_back();
+		command.name = name;
+		command.args.assign(args.begin(), args.end());
+		if (captureValues && values) command.values.assign(values, values + valueCount);
+	}
+
+	size_t RecordingGL::getCallCount(const std::string& name) const {
+		std::map<std::string, size_t>::const_iterator it = callCounts.find(name);
+		return (it == callCounts.end()) ? 0 : it->second;
+	}
+
+	std::string RecordingGL::dump() const {
+		std::string out;
+		for (const GLCommand& command : commands) {
+			out += command.toString();
+			out += '\n';
+		}
+		return out;
+	}
+
+	bool RecordingGL::matchesGolden(const std::string& path, const bool update) const {
+		const std::string current = dump();
+		if (update) {
+			std::ofstream file(path, std::ios::binary | std::ios::trunc);
+			if (!file) return Logger::error("RecordingGL", "matchesGolden", "Failed to write golden: " + path);
+			file << current;
+			return true;
+		}
+
+		std::ifstream file(path, std::ios::binary);
+		if (!file) return Logger::error("RecordingGL", "matchesGolden", "Missing golden: " + path);
+
+		std::istringstream actual(current);
+		std::string expectedLine, actualLine;
+		size_t line = 1;
+		for (;; ++line) {
+			const bool hasExpected = static_cast<bool>(std::getline(file, expectedLine));
+			const bool hasActual = static_cast<bool>(std::getline(actual, actualLine));
+			if (!hasExpected && !hasActual) return true;
+			if (hasExpected != hasActual || expectedLine != actualLine)
+				return Logger::error("RecordingGL", "matchesGolden", path + ":" + std::to_string(line) + " expected '" + (hasExpected ? expectedLine : "<end>") + "' got '" + (hasActual ? actualLine : "<end>") + "'");
+		}
+	}
+
+	FrameBenchResult RecordingGL::benchmark(const std::function<void()>& frame, const uint32_t frames) {
+		FrameBenchResult result;
+		if (frames == 0 || !frame) return result;
+
+		const size_t callsBefore = totalCalls;
+		const size_t drawsBefore = drawCalls;
+		double totalMs = 0.0;
+		for (uint32_t i = 0; i < frames; ++i) {
+			const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+			frame();
+			const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+			totalMs += ms;
+			result.minMs = (i == 0 || ms < result.minMs) ? ms : result.minMs;
+			result.maxMs = (ms > result.maxMs) ? ms : result.maxMs;
+		}
+
+		result.frames = frames;
+		result.meanMs = totalMs / frames;
+		result.callsPerFrame = static_cast<double>(totalCalls - callsBefore) / frames;
+		result.drawsPerFrame = static_cast<double>(drawCalls - drawsBefore) / frames;
+		return result;
+	}
+}
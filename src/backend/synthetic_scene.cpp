@@ -0,0 +1,142 @@
+#include "starlet-graphics/backend/synthetic_scene.hpp"
+#include "starlet-logger/logger.hpp"
+
+#include "starlet-graphics/manager/resource_manager.hpp"
+#include "starlet-graphics/renderer/render_world.hpp"
+#include "starlet-graphics/resource/texture_cpu.hpp"
+
+#include "starlet-scene/component/primitive.hpp"
+#include "starlet-scene/component/transform.hpp"
+#include "starlet-scene/component/colour.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <string>
+#include <vector>
+
+namespace Starlet::Graphics {
+	namespace {
+		constexpr float FOV{ 60.0f };
+		constexpr float TAN_HALF_FOV{ 0.57735f };
+
+		// Small deterministic generator so a seed always builds the same world on every platform
+		class Random {
+		public:
+			explicit Random(const uint32_t seed) : state(seed ? seed : 1u) {}
+
+			float next() {
+				state ^= state << 13;
+				state ^= state >> 17;
+				state ^= state << 5;
+				return static_cast<float>(state & 0xFFFFFFu) / static_cast<float>(0x1000000u);
+			}
+			float range(const float low, const float high) { return low + (high - low) * next(); }
+
+		private:
+			uint32_t state;
+		};
+
+		void fillChecker(TextureCPU& cpu, const uint32_t size, const uint32_t index) {
+			cpu.width = static_cast<int32_t>(size);
+			cpu.height = static_cast<int32_t>(size);
+			cpu.pixelSize = 4;
+			cpu.pixels.resize(static_cast<size_t>(size) * size * 4);
+			cpu.byteSize = cpu.pixels.size();
+
+			const uint32_t cell = (size >= 8) ? size / 8 : 1;
+			const uint8_t tint = static_cast<uint8_t>(64 + (index * 37) % 192);
+			for (uint32_t y = 0; y < size; ++y) {
+				for (uint32_t x = 0; x < size; ++x) {
+					const bool on = ((x / cell) + (y / cell)) % 2 == 0;
+					uint8_t* pixel = &cpu.pixels[(static_cast<size_t>(y) * size + x) * 4];
+					pixel[0] = on ? tint : 32;
+					pixel[1] = on ? 255 - tint : 32;
+					pixel[2] = on ? 128 : 32;
+					pixel[3] = 255;
+				}
+			}
+		}
+	}
+
+	bool buildSyntheticScene(ResourceManager& resources, const SyntheticSceneSettings& settings, RenderWorld& world) {
+		Scene::Primitive cube;
+		cube.name = "synthetic_cube";
+		cube.type = Scene::PrimitiveType::Cube;
+		const ResourceHandle mesh = resources.hasMesh(cube.name)
+			? resources.getMeshHandle(cube.name)
+			: resources.addPrimitiveMesh(cube, Scene::TransformComponent{}, Scene::ColourComponent{});
+		if (!mesh.isValid()) return Logger::error("SyntheticScene", "build", "Failed to create the cube mesh");
+
+		std::vector<ResourceHandle> textures(settings.textures);
+		for (uint32_t i = 0; i < settings.textures; ++i) {
+			const std::string name = "synthetic_texture_" + std::to_string(i);
+			textures[i] = resources.getTextureHandle(name);
+			if (textures[i].isValid()) continue;
+
+			TextureCPU cpu;
+			fillChecker(cpu, settings.textureSize, i);
+			textures[i] = resources.addTexture(name, cpu);
+			if (!textures[i].isValid()) return Logger::error("SyntheticScene", "build", "Failed to create texture: " + name);
+		}
+
+		// Square grid, one model per cell, filling rows away from the camera
+		const uint32_t side = std::max(1u, static_cast<uint32_t>(std::ceil(std::sqrt(static_cast<float>(settings.models)))));
+		const float halfWidth = 0.5f * settings.spacing * static_cast<float>(side - 1);
+		const float depth = settings.spacing * static_cast<float>(side);
+		// Far enough back that the nearest row fits the vertical field of view, and so any aspect of at least 1
+		const float firstRow = std::max(5.0f, (halfWidth + 1.0f) / TAN_HALF_FOV + 1.0f);
+		Random random(settings.seed);
+
+		world.camera.valid = true;
+		world.camera.position = { 0.0f, 0.0f, 0.0f };
+		world.camera.rotation = { 0.0f, -90.0f, 0.0f };
+		world.camera.fov = FOV;
+		world.camera.nearPlane = 0.1f;
+		world.camera.farPlane = firstRow + depth + settings.spacing;
+		world.ambient = { 0.1f, 0.1f, 0.1f, 1.0f };
+
+		RenderModels& models = world.models;
+		models.resize(settings.models);
+		for (uint32_t i = 0; i < settings.models; ++i) {
+			const float column = static_cast<float>(i % side);
+			const float row = static_cast<float>(i / side);
+			const bool transparent = random.next() < settings.transparentFraction;
+
+			models.entity[i] = static_cast<Scene::Entity>(i);
+			models.name[i] = "synthetic_" + std::to_string(i);
+			models.nameVersion[i] = i + 1;
+			models.position[i] = { column * settings.spacing - halfWidth, random.range(-1.0f, 1.0f), -firstRow - row * settings.spacing };
+			models.rotation[i] = { 0.0f, random.range(0.0f, 360.0f), 0.0f };
+			models.scale[i] = { 1.0f, 1.0f, 1.0f };
+			models.colour[i] = { random.next(), random.next(), random.next(), transparent ? 0.5f : 1.0f };
+			models.specular[i] = { 1.0f, 1.0f, 1.0f, 32.0f };
+			models.mesh[i] = mesh;
+			models.textures[i] = {};
+			models.textureMix[i] = {};
+			models.seed[i] = { random.next(), random.next(), random.next() };
+			models.flags[i] = RENDER_MODEL_VISIBLE | RENDER_MODEL_LIT;
+			models.colourMode[i] = 0;
+			models.version[i] = i + 1;
+
+			if (!textures.empty()) {
+				models.textures[i][0] = textures[i % textures.size()];
+				models.textureMix[i][0] = 1.0f;
+				models.flags[i] |= RENDER_MODEL_TEXTURED;
+			}
+		}
+
+		RenderLights& lights = world.lights;
+		lights.resize(settings.lights);
+		for (uint32_t i = 0; i < settings.lights; ++i) {
+			lights.position[i] = { random.range(-halfWidth, halfWidth), random.range(1.0f, 4.0f), -firstRow - random.range(0.0f, depth), 1.0f };
+			lights.direction[i] = { 0.0f, -1.0f, 0.0f, 0.0f };
+			lights.diffuse[i] = { random.range(0.5f, 1.0f), random.range(0.5f, 1.0f), random.range(0.5f, 1.0f), 1.0f };
+			lights.attenuation[i] = { 1.0f, 0.09f, 0.032f, 0.0f };
+			lights.param1[i] = { 0.0f, 0.0f, 0.0f, 0.0f };
+			lights.active[i] = 1;
+			lights.version[i] = i + 1;
+		}
+
+		return true;
+	}
+}
@@ -0,0 +1,245 @@
+#include "starlet-graphics/culling/software_occlusion.hpp"
+#include "starlet-graphics/jobs/job_system.hpp"
+
+#include "starlet-math/mat4.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <map>
+
+namespace Starlet::Graphics {
+	namespace {
+		// Model matrices are column major, as uploaded with glUniformMatrix4fv(..., GL_FALSE, ...)
+		Math::Vec3<float> transformPoint(const Math::Mat4& matrix, const Math::Vec3<float>& p) {
+			const float* m = matrix.models;
+			return {
+				m[0] * p.x + m[4] * p.y + m[8] * p.z + m[12],
+				m[1] * p.x + m[5] * p.y + m[9] * p.z + m[13],
+				m[2] * p.x + m[6] * p.y + m[10] * p.z + m[14]
+			};
+		}
+
+		Math::Vec3<float> lerp(const Math::Vec3<float>& a, const Math::Vec3<float>& b, const float t) {
+			return { a.x + (b.x - a.x) * t, a.y + (b.y - a.y) * t, a.z + (b.z - a.z) * t };
+		}
+	}
+
+	void SoftwareOcclusion::setResolution(const uint32_t w, const uint32_t h) {
+		width = std::max<uint32_t>(1, w);
+		height = std::max<uint32_t>(1, h);
+		tilesX = (width + TILE_SIZE - 1) / TILE_SIZE;
+		tilesY = (height + TILE_SIZE - 1) / TILE_SIZE;
+	}
+
+	void SoftwareOcclusion::setOccluderMesh(const uint32_t meshId, const std::vector<Math::Vec3<float>>& positions, const std::vector<uint32_t>& indices) {
+		OccluderMesh& mesh = occluderMeshes[meshId];
+		mesh.positions = positions;
+		mesh.indices.assign(indices.begin(), indices.begin() + indices.size() / 3 * 3);
+
+		// Edges are matched by position so split vertices (seams in normals or UVs) still count as shared
+		std::map<std::array<float, 3>, uint32_t> welded;
+		std::vector<uint32_t> canonical(positions.size());
+		for (size_t i = 0; i < positions.size(); ++i)
+			canonical[i] = welded.emplace(std::array<float, 3>{ positions[i].x, positions[i].y, positions[i].z }, static_cast<uint32_t>(i)).first->second;
+
+		const auto edgeKey = [&](const uint32_t a, const uint32_t b) {
+			const uint64_t ca = canonical[a], cb = canonical[b];
+			return ca < cb ? (ca << 32) | cb : (cb << 32) | ca;
+		};
+		std::unordered_map<uint64_t, uint32_t> edgeUses;
+		for (size_t t = 0; t < mesh.indices.size(); t += 3)
+			for (int i = 0; i < 3; ++i) ++edgeUses[edgeKey(mesh.indices[t + (i + 1) % 3], mesh.indices[t + (i + 2) % 3])];
+
+		mesh.silhouette.assign(mesh.indices.size() / 3, 0);
+		for (size_t t = 0; t < mesh.indices.size(); t += 3)
+			for (int i = 0; i < 3; ++i)
+				if (edgeUses[edgeKey(mesh.indices[t + (i + 1) % 3], mesh.indices[t + (i + 2) % 3])] < 2) mesh.silhouette[t / 3] |= 1u << i;
+	}
+
+	void SoftwareOcclusion::beginFrame(const ViewFrustum& view) {
+		frustum = view;
+		stats = {};
+		triangles.clear();
+		tileTriangles.resize(static_cast<size_t>(tilesX) * tilesY);
+		for (std::vector<uint32_t>& tile : tileTriangles) tile.clear();
+		depth.assign(static_cast<size_t>(width) * height, 0.0f);
+	}
+
+	void SoftwareOcclusion::project(const Math::Vec3<float>& view, float& x, float& y) const {
+		x = (view.x / (view.z * frustum.tanHalfX) * 0.5f + 0.5f) * width;
+		y = (view.y / (view.z * frustum.tanHalfY) * 0.5f + 0.5f) * height;
+	}
+
+	void SoftwareOcclusion::addOccluder(const uint32_t meshId, const Math::Mat4& model) {
+		std::unordered_map<uint32_t, OccluderMesh>::const_iterator it = occluderMeshes.find(meshId);
+		if (it == occluderMeshes.end()) return;
+		++stats.occluders;
+
+		const OccluderMesh& mesh = it->second;
+		viewPositions.resize(mesh.positions.size());
+		for (size_t i = 0; i < mesh.positions.size(); ++i) viewPositions[i] = frustum.toView(transformPoint(model, mesh.positions[i]));
+
+		for (size_t i = 0; i < mesh.indices.size(); i += 3)
+			addTriangle(viewPositions[mesh.indices[i]], viewPositions[mesh.indices[i + 1]], viewPositions[mesh.indices[i + 2]], mesh.silhouette[i / 3]);
+	}
+
+	void SoftwareOcclusion::addTriangle(const Math::Vec3<float>& a, const Math::Vec3<float>& b, const Math::Vec3<float>& c, const uint8_t silhouette) {
+		// Clip against the near plane, leaving a polygon of up to four corners.
+		// outline[n] marks the polygon edge from corner n to n + 1 as a silhouette, the cut along the near plane is one.
+		const Math::Vec3<float> input[3]{ a, b, c };
+		Math::Vec3<float> clipped[4];
+		bool outline[4]{};
+		int count = 0;
+		for (int i = 0; i < 3; ++i) {
+			const Math::Vec3<float>& current = input[i];
+			const Math::Vec3<float>& next = input[(i + 1) % 3];
+			const bool currentIn = current.z >= frustum.nearPlane, nextIn = next.z >= frustum.nearPlane;
+			const bool edgeOutline = (silhouette >> ((i + 2) % 3)) & 1u; // Edge i to i + 1 is opposite corner i + 2
+			if (currentIn) {
+				outline[count] = edgeOutline;
+				clipped[count++] = current;
+			}
+			if (currentIn != nextIn) {
+				outline[count] = currentIn || edgeOutline;
+				clipped[count++] = lerp(current, next, (frustum.nearPlane - current.z) / (next.z - current.z));
+			}
+		}
+
+		for (int fan = 1; fan + 1 < count; ++fan) {
+			ScreenTriangle triangle;
+			const Math::Vec3<float>* corners[3]{ &clipped[0], &clipped[fan], &clipped[fan + 1] };
+			for (int i = 0; i < 3; ++i) {
+				project(*corners[i], triangle.x[i], triangle.y[i]);
+				triangle.invZ[i] = 1.0f / corners[i]->z;
+			}
+
+			// Fan diagonals are interior, only edges on the clipped polygon keep their silhouette flag
+			triangle.silhouette = 0;
+			if (outline[fan]) triangle.silhouette |= 1u << 0;
+			if (fan + 2 == count && outline[fan + 1]) triangle.silhouette |= 1u << 1;
+			if (fan == 1 && outline[0]) triangle.silhouette |= 1u << 2;
+			++stats.occluderTriangles;
+			binTriangle(triangle);
+		}
+	}
+
+	void SoftwareOcclusion::binTriangle(const ScreenTriangle& triangle) {
+		const float minX = std::min({ triangle.x[0], triangle.x[1], triangle.x[2] });
+		const float maxX = std::max({ triangle.x[0], triangle.x[1], triangle.x[2] });
+		const float minY = std::min({ triangle.y[0], triangle.y[1], triangle.y[2] });
+		const float maxY = std::max({ triangle.y[0], triangle.y[1], triangle.y[2] });
+		if (maxX < 0.0f || maxY < 0.0f || minX >= static_cast<float>(width) || minY >= static_cast<float>(height)) return;
+
+		const uint32_t index = static_cast<uint32_t>(triangles.size());
+		triangles.push_back(triangle);
+
+		const uint32_t tileX0 = static_cast<uint32_t>(std::max(0.0f, minX)) / TILE_SIZE;
+		const uint32_t tileY0 = static_cast<uint32_t>(std::max(0.0f, minY)) / TILE_SIZE;
+		const uint32_t tileX1 = std::min(tilesX - 1, static_cast<uint32_t>(std::min(maxX, static_cast<float>(width - 1))) / TILE_SIZE);
+		const uint32_t tileY1 = std::min(tilesY - 1, static_cast<uint32_t>(std::min(maxY, static_cast<float>(height - 1))) / TILE_SIZE);
+		for (uint32_t ty = tileY0; ty <= tileY1; ++ty)
+			for (uint32_t tx = tileX0; tx <= tileX1; ++tx) tileTriangles[ty * tilesX + tx].push_back(index);
+	}
+
+	void SoftwareOcclusion::rasterize(JobSystem* jobs) {
+		const uint32_t tiles = static_cast<uint32_t>(tileTriangles.size());
+		if (jobs) jobs->parallelFor(tiles, 1, [this](const uint32_t begin, const uint32_t end) {
+			for (uint32_t tile = begin; tile < end; ++tile) rasterizeTile(tile);
+		});
+		else for (uint32_t tile = 0; tile < tiles; ++tile) rasterizeTile(tile);
+	}
+
+	void SoftwareOcclusion::rasterizeTile(const uint32_t tile) {
+		const uint32_t tileX = (tile % tilesX) * TILE_SIZE, tileY = (tile / tilesX) * TILE_SIZE;
+		const uint32_t tileRight = std::min(width, tileX + TILE_SIZE), tileTop = std::min(height, tileY + TILE_SIZE);
+
+		for (const uint32_t index : tileTriangles[tile]) {
+			const ScreenTriangle& t = triangles[index];
+
+			// Edge i is opposite corner i, E(x, y) = a*x + b*y + c, both windings are drawn
+			float area = (t.x[1] - t.x[0]) * (t.y[2] - t.y[0]) - (t.x[2] - t.x[0]) * (t.y[1] - t.y[0]);
+			if (std::fabs(area) < 1e-8f) continue;
+			const float sign = area > 0.0f ? 1.0f : -1.0f;
+			area *= sign;
+
+			float ea[3], eb[3], ec[3];
+			for (int i = 0; i < 3; ++i) {
+				const int j = (i + 1) % 3, k = (i + 2) % 3;
+				ea[i] = sign * (t.y[j] - t.y[k]);
+				eb[i] = sign * (t.x[k] - t.x[j]);
+				ec[i] = sign * (t.x[j] * t.y[k] - t.x[k] * t.y[j]);
+			}
+
+			// Depth plane in screen space: 1/z is affine across the projected triangle
+			const float invArea = 1.0f / area;
+			const float za = (ea[0] * t.invZ[0] + ea[1] * t.invZ[1] + ea[2] * t.invZ[2]) * invArea;
+			const float zb = (eb[0] * t.invZ[0] + eb[1] * t.invZ[1] + eb[2] * t.invZ[2]) * invArea;
+			float zc = (ec[0] * t.invZ[0] + ec[1] * t.invZ[1] + ec[2] * t.invZ[2]) * invArea;
+
+			// Conservative for an occluder: a pixel is written only when its whole square is inside every silhouette edge, and
+			// with the farthest depth over that square. Both are the centre value shifted by half the gradient along each axis.
+			for (int i = 0; i < 3; ++i)
+				if ((t.silhouette >> i) & 1u) ec[i] -= 0.5f * (std::fabs(ea[i]) + std::fabs(eb[i]));
+			zc -= 0.5f * (std::fabs(za) + std::fabs(zb));
+
+			const int x0 = std::max(static_cast<int>(tileX), static_cast<int>(std::floor(std::min({ t.x[0], t.x[1], t.x[2] }))));
+			const int x1 = std::min(static_cast<int>(tileRight) - 1, static_cast<int>(std::ceil(std::max({ t.x[0], t.x[1], t.x[2] }))));
+			const int y0 = std::max(static_cast<int>(tileY), static_cast<int>(std::floor(std::min({ t.y[0], t.y[1], t.y[2] }))));
+			const int y1 = std::min(static_cast<int>(tileTop) - 1, static_cast<int>(std::ceil(std::max({ t.y[0], t.y[1], t.y[2] }))));
+
+			for (int y = y0; y <= y1; ++y) {
+				const float py = static_cast<float>(y) + 0.5f;
+				float* row = depth.data() + static_cast<size_t>(y) * width;
+				const float e0 = eb[0] * py + ec[0], e1 = eb[1] * py + ec[1], e2 = eb[2] * py + ec[2];
+				const float zRow = zb * py + zc;
+
+				// Branch free so the compiler can run the span several pixels wide
+				for (int x = x0; x <= x1; ++x) {
+					const float px = static_cast<float>(x) + 0.5f;
+					const bool inside = (ea[0] * px + e0 >= 0.0f) & (ea[1] * px + e1 >= 0.0f) & (ea[2] * px + e2 >= 0.0f);
+					const float z = za * px + zRow;
+					row[x] = inside ? std::max(row[x], z) : row[x];
+				}
+			}
+		}
+	}
+
+	bool SoftwareOcclusion::isVisible(const Math::Vec3<float>& boundsMin, const Math::Vec3<float>& boundsMax, const Math::Mat4& model) const {
+		if (depth.empty()) return true;
+
+		float minX = static_cast<float>(width), maxX = -1.0f, minY = static_cast<float>(height), maxY = -1.0f;
+		float nearest = 0.0f;
+		for (int corner = 0; corner < 8; ++corner) {
+			const Math::Vec3<float> local{
+				(corner & 1) ? boundsMax.x : boundsMin.x,
+				(corner & 2) ? boundsMax.y : boundsMin.y,
+				(corner & 4) ? boundsMax.z : boundsMin.z
+			};
+			const Math::Vec3<float> view = frustum.toView(transformPoint(model, local));
+			if (view.z < frustum.nearPlane) return true; // Crosses the near plane, too close to judge
+
+			float x, y;
+			project(view, x, y);
+			minX = std::min(minX, x);
+			maxX = std::max(maxX, x);
+			minY = std::min(minY, y);
+			maxY = std::max(maxY, y);
+			nearest = std::max(nearest, 1.0f / view.z);
+		}
+
+		// Entirely off screen is invisible whatever the occluders are
+		if (maxX < 0.0f || maxY < 0.0f || minX >= static_cast<float>(width) || minY >= static_cast<float>(height)) return false;
+
+		const int x0 = std::max(0, static_cast<int>(std::floor(minX)));
+		const int x1 = std::min(static_cast<int>(width) - 1, static_cast<int>(std::ceil(maxX)));
+		const int y0 = std::max(0, static_cast<int>(std::floor(minY)));
+		const int y1 = std::min(static_cast<int>(height) - 1, static_cast<int>(std::ceil(maxY)));
+		for (int y = y0; y <= y1; ++y) {
+			const float* row = depth.data() + static_cast<size_t>(y) * width;
+			for (int x = x0; x <= x1; ++x)
+				if (row[x] <= nearest) return true;
+		}
+		return false;
+	}
+}
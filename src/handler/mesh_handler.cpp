@@ -3,16 +3,55 @@
 
 #include "starlet-graphics/resource/mesh_cpu.hpp"
 #include "starlet-graphics/resource/mesh_gpu.hpp"
+#include "starlet-graphics/streaming/staging_uploader.hpp"
 
 #include <glad/glad.h>
 
+#include <string>
+
 namespace Starlet::Graphics {
   bool MeshHandler::upload(MeshCPU& meshData, MeshGPU& meshOut) {
-    if (meshData.empty()) return Logger::error("MeshHandler", "upload", "Invalid mesh data");
+    return createBuffers(meshData, meshOut, nullptr, StagedMesh{});
+  }
+  bool MeshHandler::upload(MeshCPU& meshData, MeshGPU& meshOut, StagingUploader& staging) {
+    StagedMesh staged;
+    if (staging.isReady() && !meshData.empty()) stage(meshData, staging, staged);
+    return createBuffers(meshData, meshOut, &staging, staged);
+  }
+  bool MeshHandler::upload(MeshCPU& meshData, MeshGPU& meshOut, StagingUploader& staging, const StagedMesh& staged) {
+    return createBuffers(meshData, meshOut, &staging, staged);
+  }
+
+  void MeshHandler::stage(const MeshCPU& meshData, StagingUploader& staging, StagedMesh& out) {
+    out = StagedMesh{};
+    staging.stage(meshData.vertices.data(), sizeof(Math::Vertex) * meshData.numVertices, out.vertices);
+    staging.stage(meshData.indices.data(), sizeof(unsigned int) * meshData.indices.size(), out.indices);
+  }
+
+  void MeshHandler::cancel(StagingUploader* staging, const StagedMesh& staged) {
+    if (!staging) return;
+    if (staged.vertices.isValid()) staging->cancel(staged.vertices);
+    if (staged.indices.isValid()) staging->cancel(staged.indices);
+  }
+
+  bool MeshHandler::createBuffers(MeshCPU& meshData, MeshGPU& meshOut, StagingUploader* staging, const StagedMesh& staged) {
+    if (meshData.empty()) {
+      cancel(staging, staged);
+      return Logger::error("MeshHandler", "upload", "Invalid mesh data");
+    }
 
     meshOut.numVertices = meshData.numVertices;
     meshOut.numIndices = meshData.numIndices;
 
+    const GLsizeiptr vertexBytes = sizeof(Math::Vertex) * meshOut.numVertices;
+    // Coarser levels of detail follow the full mesh in the same index buffer
+    meshOut.lods = meshData.lods;
+    const GLsizeiptr indexBytes = sizeof(unsigned int) * meshData.indices.size();
+
+    //Staged data only reaches the buffers as a GPU side copy at the next flush, the rest is copied straight from client memory
+    const bool stageVertices = staged.vertices.isValid();
+    const bool stageIndices = staged.indices.isValid();
+
     //Create a VAO (Vertex Array Object), which will keep track of all the 'state' needed to draw from this buffer
     glGenVertexArrays(1, &(meshOut.VAOID)); //Ask OpenGL for a new buffer ID
     glBindVertexArray(meshOut.VAOID);       //Bind the buffer: aka "make this the 'current' VAO buffer
@@ -20,13 +59,72 @@ namespace Starlet::Graphics {
     //Now ANY state that is related to vertex or index buffer and vertex attribute layout, is stored in the 'state' of the VAO
     glGenBuffers(1, &(meshOut.VertexBufferID));
     glBindBuffer(GL_ARRAY_BUFFER, meshOut.VertexBufferID);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(Math::Vertex) * meshOut.numVertices, meshData.vertices.data(), GL_STATIC_DRAW);
+    glBufferData(GL_ARRAY_BUFFER, vertexBytes, stageVertices ? nullptr : meshData.vertices.data(), GL_STATIC_DRAW);
 
     //Copy the index buffer into the video card to create an index buffer
     glGenBuffers(1, &(meshOut.IndexBufferID));
     glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, meshOut.IndexBufferID);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(unsigned int) * meshOut.numIndices, meshData.indices.data(), GL_STATIC_DRAW);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, indexBytes, stageIndices ? nullptr : meshData.indices.data(), GL_STATIC_DRAW);
+
+    setVertexAttributes();
+    createDepthArray(meshOut);
+
+    GLenum err = glGetError();
+    if (err != GL_NO_ERROR) {
+      cancel(staging, staged);
+      unload(meshOut);
+      return Logger::error("MeshHandler", "upload", "OpenGL error " + std::to_string(err));
+    }
+
+    if (stageVertices) staging->enqueueBufferCopy(staged.vertices, meshOut.VertexBufferID, 0);
+    if (stageIndices) staging->enqueueBufferCopy(staged.indices, meshOut.IndexBufferID, 0);
+
+    if (!keepGeometry) {
+      meshData.vertices.clear();
+      meshData.indices.clear();
+    }
+    return true;
+  }
+
+  bool MeshHandler::allocate(const MeshCPU& layout, MeshGPU& meshOut) {
+    if (layout.numVertices == 0 || layout.numIndices == 0) return Logger::error("MeshHandler", "allocate", "Invalid mesh layout");
+
+    meshOut.numVertices = layout.numVertices;
+    meshOut.numIndices = layout.numIndices;
+    meshOut.lods.clear();
+
+    const GLsizeiptr vertexBytes = sizeof(Math::Vertex) * static_cast<GLsizeiptr>(meshOut.numVertices);
+    const GLsizeiptr indexBytes = sizeof(unsigned int) * static_cast<GLsizeiptr>(meshOut.numIndices);
+
+    //Immutable storage allocated once at full size, dynamic so chunks can be written with glBufferSubData
+    const auto allocateStorage = [](const GLenum target, const GLsizeiptr bytes) {
+      if (glBufferStorage) glBufferStorage(target, bytes, nullptr, GL_DYNAMIC_STORAGE_BIT);
+      else glBufferData(target, bytes, nullptr, GL_STATIC_DRAW);
+    };
+
+    glGenVertexArrays(1, &(meshOut.VAOID));
+    glBindVertexArray(meshOut.VAOID);
 
+    glGenBuffers(1, &(meshOut.VertexBufferID));
+    glBindBuffer(GL_ARRAY_BUFFER, meshOut.VertexBufferID);
+    allocateStorage(GL_ARRAY_BUFFER, vertexBytes);
+
+    glGenBuffers(1, &(meshOut.IndexBufferID));
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, meshOut.IndexBufferID);
+    allocateStorage(GL_ELEMENT_ARRAY_BUFFER, indexBytes);
+
+    setVertexAttributes();
+    createDepthArray(meshOut);
+
+    GLenum err = glGetError();
+    if (err != GL_NO_ERROR) {
+      unload(meshOut);
+      return Logger::error("MeshHandler", "allocate", "OpenGL error " + std::to_string(err));
+    }
+    return true;
+  }
+
+  void MeshHandler::setVertexAttributes() {
     glEnableVertexAttribArray(0);
     glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Math::Vertex), (void*)offsetof(Math::Vertex, pos));
 
@@ -38,23 +136,30 @@ namespace Starlet::Graphics {
 
     glEnableVertexAttribArray(3);
     glVertexAttribPointer(3, 2, GL_FLOAT, GL_FALSE, sizeof(Math::Vertex), (void*)offsetof(Math::Vertex, texCoord));
+  }
 
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
-    glBindVertexArray(0);
+  //Second VAO with only attribute 0, reading positions out of the vertex buffer at the Vertex stride and sharing the
+  //index buffer so level of detail ranges apply unchanged; depth-only passes fetch no other attribute and no copy is kept
+  void MeshHandler::createDepthArray(MeshGPU& meshOut) {
+    glGenVertexArrays(1, &(meshOut.DepthVAOID));
+    glBindVertexArray(meshOut.DepthVAOID);
 
-    GLenum err = glGetError();
-    if (err != GL_NO_ERROR) return Logger::error("MeshHandler", "upload", "OpenGL error " + std::to_string(err));
+    glBindBuffer(GL_ARRAY_BUFFER, meshOut.VertexBufferID);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, meshOut.IndexBufferID);
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Math::Vertex), (void*)offsetof(Math::Vertex, pos));
 
-    meshData.vertices.clear();
-    meshData.indices.clear();
-    return true;
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glBindVertexArray(0);
   }
 
   void MeshHandler::unload(MeshGPU& mesh) {
-    if (glIsVertexArray(mesh.VAOID))     glDeleteVertexArrays(1, &mesh.VAOID);
-    if (glIsBuffer(mesh.VertexBufferID)) glDeleteBuffers(1, &mesh.VertexBufferID);
-    if (glIsBuffer(mesh.IndexBufferID))  glDeleteBuffers(1, &mesh.IndexBufferID);
-    mesh.VAOID = mesh.VertexBufferID = mesh.IndexBufferID = 0;
+    if (glIsVertexArray(mesh.VAOID))       glDeleteVertexArrays(1, &mesh.VAOID);
+    if (glIsBuffer(mesh.VertexBufferID))   glDeleteBuffers(1, &mesh.VertexBufferID);
+    if (glIsBuffer(mesh.IndexBufferID))    glDeleteBuffers(1, &mesh.IndexBufferID);
+    if (glIsVertexArray(mesh.DepthVAOID))  glDeleteVertexArrays(1, &mesh.DepthVAOID);
+    mesh.VAOID = mesh.VertexBufferID = mesh.IndexBufferID = mesh.DepthVAOID = 0;
     mesh.numVertices = mesh.numIndices = 0;
+    mesh.lods.clear();
   }
 }
\ No newline at end of file
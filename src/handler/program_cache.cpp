@@ -0,0 +1,176 @@
+#include "starlet-graphics/handler/program_cache.hpp"
+#include "starlet-logger/logger.hpp"
+
+#include "starlet-graphics/resource/shader_cpu.hpp"
+
+#include <glad/glad.h>
+
+#include <filesystem>
+#include <fstream>
+#include <vector>
+
+namespace Starlet::Graphics {
+	namespace {
+		constexpr uint32_t CACHE_MAGIC{ 0x43425053 }; // "SPBC"
+		constexpr uint32_t CACHE_VERSION{ 1 };
+
+		struct CacheHeader {
+			uint32_t magic{ CACHE_MAGIC };
+			uint32_t version{ CACHE_VERSION };
+			uint64_t key{ 0 };
+			uint32_t format{ 0 };
+			uint32_t length{ 0 };
+		};
+
+		void hashBytes(uint64_t& hash, const std::string& bytes) {
+			for (unsigned char c : bytes) {
+				hash ^= c;
+				hash *= 0x100000001b3ull;
+			}
+			// Separator so ("ab","c") and ("a","bc") hash differently
+			hash ^= 0xff;
+			hash *= 0x100000001b3ull;
+		}
+
+		std::string glString(GLenum name) {
+			const GLubyte* value = glGetString(name);
+			return value ? reinterpret_cast<const char*>(value) : "";
+		}
+	}
+
+	void ProgramCache::setDirectory(const std::string& path) {
+		directory = path;
+		if (directory.empty()) return;
+
+		std::error_code ec;
+		std::filesystem::create_directories(directory, ec);
+		if (ec) {
+			Logger::error("ProgramCache", "setDirectory", "Failed to create cache directory: " + directory);
+			directory.clear();
+			return;
+		}
+
+		int formats = 0;
+		if (glGetProgramBinary && glProgramBinary) glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+		supported = formats > 0;
+		if (!supported) Logger::error("ProgramCache", "setDirectory", "Driver exposes no program binary formats, cache disabled");
+	}
+
+	const std::string& ProgramCache::getDriverID() {
+		if (driverID.empty())
+			driverID = glString(GL_VENDOR) + "|" + glString(GL_RENDERER) + "|" + glString(GL_VERSION);
+		return driverID;
+	}
+
+	uint64_t ProgramCache::makeKey(const ShaderCPU& cpu) {
+		uint64_t hash = 0xcbf29ce484222325ull;
+		hashBytes(hash, cpu.vertexSource);
+		hashBytes(hash, cpu.fragmentSource);
+		hashBytes(hash, cpu.defines);
+		hashBytes(hash, getDriverID());
+		return hash;
+	}
+
+	std::string ProgramCache::pathFor(const uint64_t key) const {
+		static const char digits[] = "0123456789abcdef";
+		std::string name(16, '0');
+		for (int i = 0; i < 16; ++i)
+			name[15 - i] = digits[(key >> (i * 4)) & 0xf];
+		return (std::filesystem::path(directory) / (name + ".bin")).string();
+	}
+
+	bool ProgramCache::load(const uint64_t key, unsigned int& programOut) {
+		programOut = 0;
+		if (!isEnabled()) return false;
+
+		const std::string path = pathFor(key);
+		std::ifstream file(path, std::ios::binary);
+		if (!file) {
+			++stats.misses;
+			return false;
+		}
+
+		CacheHeader header;
+		std::vector<char> binary;
+		bool complete = false;
+		if (file.read(reinterpret_cast<char*>(&header), sizeof(header))
+			&& header.magic == CACHE_MAGIC && header.version == CACHE_VERSION && header.key == key && header.length > 0) {
+			binary.resize(header.length);
+			complete = static_cast<bool>(file.read(binary.data(), header.length));
+		}
+		file.close();
+
+		if (!complete) {
+			++stats.rejected;
+			++stats.misses;
+			std::error_code ec;
+			std::filesystem::remove(path, ec);
+			return Logger::error("ProgramCache", "load", "Malformed cache entry: " + path);
+		}
+
+		const unsigned int program = glCreateProgram();
+		glProgramBinary(program, header.format, binary.data(), static_cast<GLsizei>(binary.size()));
+
+		int status = GL_FALSE;
+		glGetProgramiv(program, GL_LINK_STATUS, &status);
+		if (status != GL_TRUE) {
+			// Driver update or format change, the caller recompiles and overwrites the entry.
+			// A rejected binary leaves GL_INVALID_ENUM or GL_INVALID_VALUE pending, drained so the next error check is not blamed for it
+			for (int i = 0; i < 8 && glGetError() != GL_NO_ERROR; ++i) {}
+			glDeleteProgram(program);
+			++stats.rejected;
+			++stats.misses;
+			std::error_code ec;
+			std::filesystem::remove(path, ec);
+			return false;
+		}
+
+		++stats.hits;
+		programOut = program;
+		return true;
+	}
+
+	bool ProgramCache::store(const uint64_t key, const unsigned int program) {
+		if (!isEnabled()) return false;
+
+		int length = 0;
+		glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+		if (length <= 0) return Logger::error("ProgramCache", "store", "Program binary not retrievable");
+
+		std::vector<char> binary(static_cast<size_t>(length));
+		GLenum format = 0;
+		GLsizei written = 0;
+		glGetProgramBinary(program, length, &written, &format, binary.data());
+		if (written <= 0) return Logger::error("ProgramCache", "store", "glGetProgramBinary returned no data");
+
+		CacheHeader header;
+		header.key = key;
+		header.format = format;
+		header.length = static_cast<uint32_t>(written);
+
+		// Written beside the entry and renamed over it, so a reader or a crash mid-write never sees a torn entry
+		const std::string path = pathFor(key);
+		const std::string tempPath = path + ".tmp";
+		std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+		if (!file) return Logger::error("ProgramCache", "store", "Failed to open: " + tempPath);
+
+		file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+		file.write(binary.data(), written);
+		file.close();
+
+		std::error_code ec;
+		if (!file) {
+			std::filesystem::remove(tempPath, ec);
+			return Logger::error("ProgramCache", "store", "Failed to write: " + tempPath);
+		}
+
+		std::filesystem::rename(tempPath, path, ec);
+		if (ec) {
+			std::filesystem::remove(tempPath, ec);
+			return Logger::error("ProgramCache", "store", "Failed to replace: " + path);
+		}
+
+		++stats.stored;
+		return true;
+	}
+}
@@ -3,25 +3,90 @@
 
 #include "starlet-graphics/resource/shader_gpu.hpp"
 #include "starlet-graphics/resource/shader_cpu.hpp"
+#include "starlet-graphics/handler/program_cache.hpp"
 
 #include <glad/glad.h>
 
+#include <cstring>
+
+#ifndef GL_COMPLETION_STATUS_KHR
+#define GL_COMPLETION_STATUS_KHR 0x91B1
+#endif
+
 namespace Starlet::Graphics {
 	bool ShaderHandler::upload(ShaderCPU& cpu, ShaderGPU& gpu) {
+		if (!submit(cpu, gpu)) return false;
+		return finish(cpu, gpu);
+	}
+
+	bool ShaderHandler::detectParallelCompile() {
+		parallelCompile = false;
+
+		int count = 0;
+		glGetIntegerv(GL_NUM_EXTENSIONS, &count);
+		for (int i = 0; i < count && !parallelCompile; ++i) {
+			const char* name = reinterpret_cast<const char*>(glGetStringi(GL_EXTENSIONS, static_cast<GLuint>(i)));
+			parallelCompile = name && (std::strcmp(name, "GL_KHR_parallel_shader_compile") == 0 || std::strcmp(name, "GL_ARB_parallel_shader_compile") == 0);
+		}
+
+#ifdef GL_KHR_parallel_shader_compile
+		// Let the driver pick as many compiler threads as it wants
+		if (parallelCompile && glMaxShaderCompilerThreadsKHR) glMaxShaderCompilerThreadsKHR(0xFFFFFFFFu);
+#endif
+		return parallelCompile;
+	}
+
+	bool ShaderHandler::submit(ShaderCPU& cpu, ShaderGPU& gpu) {
 		if (cpu.empty()) return Logger::error("ShaderHandler", "upload", "Attempting to upload empty Shader");
 
+		if (programCache && programCache->isEnabled() && programCache->load(programCache->makeKey(cpu), gpu.programID)) {
+			gpu.linked = true;
+			return true;
+		}
+
 		if (!compileShader(gpu.vertexID, GL_VERTEX_SHADER, cpu.vertexSource)) return false;
 		if (!compileShader(gpu.fragmentID, GL_FRAGMENT_SHADER, cpu.fragmentSource)) {
 			glDeleteShader(gpu.vertexID);
+			gpu.vertexID = 0;
 			return false;
 		}
 
 		if (!linkProgram(gpu.programID, gpu.vertexID, gpu.fragmentID)) {
 			glDeleteShader(gpu.vertexID);
 			glDeleteShader(gpu.fragmentID);
+			gpu.vertexID = gpu.fragmentID = 0;
 			return false;
 		}
 
+		return true;
+	}
+
+	bool ShaderHandler::isComplete(const ShaderGPU& gpu) const {
+		if (gpu.linked || !parallelCompile || gpu.programID == 0) return true;
+
+		int complete = GL_FALSE;
+		glGetProgramiv(gpu.programID, GL_COMPLETION_STATUS_KHR, &complete);
+		return complete == GL_TRUE;
+	}
+
+	bool ShaderHandler::finish(ShaderCPU& cpu, ShaderGPU& gpu) {
+		if (gpu.linked) return true;
+
+		// Shader status first so a compile error is reported instead of the resulting link error
+		const bool vertOk = checkShader(gpu.vertexID, GL_VERTEX_SHADER);
+		const bool fragOk = checkShader(gpu.fragmentID, GL_FRAGMENT_SHADER);
+		const bool linkOk = vertOk && fragOk && checkProgram(gpu.programID);
+
+		if (!linkOk) {
+			if (gpu.programID) glDeleteProgram(gpu.programID);
+			if (gpu.vertexID) glDeleteShader(gpu.vertexID);
+			if (gpu.fragmentID) glDeleteShader(gpu.fragmentID);
+			gpu.programID = gpu.vertexID = gpu.fragmentID = 0;
+			return false;
+		}
+
+		if (programCache && programCache->isEnabled()) programCache->store(programCache->makeKey(cpu), gpu.programID);
+
 		gpu.linked = true;
 		return true;
 	}
@@ -33,24 +98,27 @@ namespace Starlet::Graphics {
 		const char* src = source.c_str();
 		glShaderSource(outShaderID, 1, &src, nullptr);
 		glCompileShader(outShaderID);
+		return true;
+	}
 
+	bool ShaderHandler::checkShader(unsigned int& shaderID, int glShaderType) {
 		int status = GL_FALSE;
-		glGetShaderiv(outShaderID, GL_COMPILE_STATUS, &status);
+		glGetShaderiv(shaderID, GL_COMPILE_STATUS, &status);
 		if (status == GL_TRUE) return true;
 
 		int logLen = 0;
-		glGetShaderiv(outShaderID, GL_INFO_LOG_LENGTH, &logLen);
+		glGetShaderiv(shaderID, GL_INFO_LOG_LENGTH, &logLen);
 		std::string log;
 		if (logLen > 1) {
 			log.resize(static_cast<size_t>(logLen));
 			int written = 0;
-			glGetShaderInfoLog(outShaderID, logLen, &written, log.data());
+			glGetShaderInfoLog(shaderID, logLen, &written, log.data());
 			if (written > 0 && static_cast<size_t>(written) < log.size())
 				log.resize(static_cast<size_t>(written));
 		}
 
-		glDeleteShader(outShaderID);
-		outShaderID = 0;
+		glDeleteShader(shaderID);
+		shaderID = 0;
 
 		const std::string shaderType =
 			(glShaderType == GL_VERTEX_SHADER ? "VERTEX"
@@ -65,29 +133,37 @@ namespace Starlet::Graphics {
 
 		glAttachShader(outProgramID, vertID);
 		glAttachShader(outProgramID, fragID);
+		if (programCache && programCache->isEnabled())
+			glProgramParameteri(outProgramID, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
 		glLinkProgram(outProgramID);
+		return true;
+	}
 
+	bool ShaderHandler::checkProgram(unsigned int& programID) {
 		int status = GL_FALSE;
-		glGetProgramiv(outProgramID, GL_LINK_STATUS, &status);
+		glGetProgramiv(programID, GL_LINK_STATUS, &status);
 
-		glDetachShader(outProgramID, vertID);
-		glDetachShader(outProgramID, fragID);
+		GLuint attached[2] = { 0, 0 };
+		GLsizei attachedCount = 0;
+		glGetAttachedShaders(programID, 2, &attachedCount, attached);
+		for (GLsizei i = 0; i < attachedCount; ++i)
+			glDetachShader(programID, attached[i]);
 		if (status == GL_TRUE) return true;
 
 		int logLen = 0;
-		glGetProgramiv(outProgramID, GL_INFO_LOG_LENGTH, &logLen);
+		glGetProgramiv(programID, GL_INFO_LOG_LENGTH, &logLen);
 
 		std::string log;
 		if (logLen > 1) {
 			log.resize(static_cast<size_t>(logLen));
 			int written = 0;
-			glGetProgramInfoLog(outProgramID, logLen, &written, log.data());
+			glGetProgramInfoLog(programID, logLen, &written, log.data());
 			if (written > 0 && static_cast<size_t>(written) < log.size())
 				log.resize(static_cast<size_t>(written));
 		}
 
-		glDeleteProgram(outProgramID);
-		outProgramID = 0;
+		glDeleteProgram(programID);
+		programID = 0;
 		return Logger::error("ShaderHandler", "linkProgram", std::string("Program link failed:\n") + log);
 	}
 
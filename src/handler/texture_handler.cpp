@@ -3,6 +3,7 @@
 
 #include "starlet-graphics/resource/texture_cpu.hpp"
 #include "starlet-graphics/resource/texture_gpu.hpp"
+#include "starlet-graphics/streaming/staging_uploader.hpp"
 
 #include <glad/glad.h>
 
@@ -38,6 +39,50 @@ namespace Starlet::Graphics {
     cpuTexture.freePixels();
     return true;
   }
+  bool TextureHandler::upload(TextureCPU& cpuTexture, TextureGPU& gpuTexture, bool generateMIPMap, StagingUploader& staging) {
+    if (cpuTexture.empty())
+      return Logger::error("TextureHandler", "upload", "Attempting to upload empty Texture");
+
+    StagedTexture staged;
+    if (!staging.isReady() || !stage(cpuTexture, staging, staged))
+      return upload(cpuTexture, gpuTexture, generateMIPMap);
+
+    return upload(staged, gpuTexture, generateMIPMap, staging);
+  }
+  bool TextureHandler::upload(const StagedTexture& staged, TextureGPU& gpuTexture, bool generateMIPMap, StagingUploader& staging) {
+    glGenTextures(1, &gpuTexture.id);
+    glBindTexture(GL_TEXTURE_2D, gpuTexture.id);
+
+    // Storage only, the pixels arrive from the staging ring (and mips are built) on the next flush
+    const GLenum src = (staged.pixelSize == 4) ? GL_RGBA : GL_RGB;
+    const GLint  internal = (staged.pixelSize == 4) ? GL_RGBA8 : GL_RGB8;
+    glTexImage2D(GL_TEXTURE_2D, 0, internal, staged.width, staged.height, 0, src, GL_UNSIGNED_BYTE, nullptr);
+
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, generateMIPMap ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    GLenum err = glGetError();
+    if (err != GL_NO_ERROR) {
+      staging.cancel(staged.allocation);
+      if (gpuTexture.id) glDeleteTextures(1, &gpuTexture.id);
+      return Logger::error("TextureHandler", "upload", "OpenGL error " + std::to_string(err));
+    }
+
+    staging.enqueueTextureCopy(staged.allocation, gpuTexture.id, GL_TEXTURE_2D, 0, staged.width, staged.height, src, generateMIPMap);
+    return true;
+  }
+  bool TextureHandler::stage(TextureCPU& cpuTexture, StagingUploader& staging, StagedTexture& out) {
+    if (cpuTexture.empty() || !staging.stage(cpuTexture.pixels.data(), cpuTexture.pixels.size(), out.allocation)) return false;
+
+    out.width = cpuTexture.width;
+    out.height = cpuTexture.height;
+    out.pixelSize = cpuTexture.pixelSize;
+    cpuTexture.freePixels();
+    return true;
+  }
   bool TextureHandler::upload(TextureCPU(&faces)[6], TextureGPU& cubeOut) {
     return upload(faces, cubeOut, true);
   }
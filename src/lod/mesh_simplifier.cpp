@@ -0,0 +1,234 @@
+#include "starlet-graphics/lod/mesh_simplifier.hpp"
+#include "starlet-graphics/resource/mesh_cpu.hpp"
+#include "starlet-logger/logger.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <unordered_map>
+
+namespace Starlet::Graphics {
+	namespace {
+		// Symmetric 4x4 matrix summing squared distances to planes: a00 a01 a02 a03 a11 a12 a13 a22 a23 a33
+		struct Quadric {
+			double a[10]{};
+
+			void addPlane(const double x, const double y, const double z, const double d) {
+				a[0] += x * x; a[1] += x * y; a[2] += x * z; a[3] += x * d;
+				a[4] += y * y; a[5] += y * z; a[6] += y * d;
+				a[7] += z * z; a[8] += z * d;
+				a[9] += d * d;
+			}
+			void add(const Quadric& other) {
+				for (int i = 0; i < 10; ++i) a[i] += other.a[i];
+			}
+			double evaluate(const Math::Vec3<float>& p) const {
+				const double x = p.x, y = p.y, z = p.z;
+				const double result = a[0] * x * x + 2.0 * a[1] * x * y + 2.0 * a[2] * x * z + 2.0 * a[3] * x
+					+ a[4] * y * y + 2.0 * a[5] * y * z + 2.0 * a[6] * y
+					+ a[7] * z * z + 2.0 * a[8] * z
+					+ a[9];
+				return std::max(result, 0.0);
+			}
+		};
+
+		struct Collapse {
+			uint32_t from, to;
+			double cost;
+		};
+
+		struct PositionKey {
+			uint32_t bits[3];
+			bool operator==(const PositionKey& other) const { return std::memcmp(bits, other.bits, sizeof(bits)) == 0; }
+		};
+		struct PositionKeyHash {
+			size_t operator()(const PositionKey& key) const {
+				return (static_cast<size_t>(key.bits[0]) * 73856093u) ^ (static_cast<size_t>(key.bits[1]) * 19349663u) ^ (static_cast<size_t>(key.bits[2]) * 83492791u);
+			}
+		};
+
+		Math::Vec3<float> triangleNormal(const Math::Vec3<float>& a, const Math::Vec3<float>& b, const Math::Vec3<float>& c) {
+			return (b - a).cross(c - a);
+		}
+
+		// Vertices sharing a position with another vertex, or on an edge used by one triangle, never move
+		std::vector<uint8_t> findLockedVertices(const std::vector<Math::Vertex>& vertices, const std::vector<unsigned int>& indices) {
+			std::unordered_map<PositionKey, uint32_t, PositionKeyHash> positions;
+			std::vector<uint32_t> weld(vertices.size());
+			std::vector<uint32_t> copies(vertices.size(), 0);
+			for (size_t v = 0; v < vertices.size(); ++v) {
+				PositionKey key;
+				std::memcpy(key.bits, &vertices[v].pos.x, sizeof(float));
+				std::memcpy(key.bits + 1, &vertices[v].pos.y, sizeof(float));
+				std::memcpy(key.bits + 2, &vertices[v].pos.z, sizeof(float));
+				weld[v] = positions.emplace(key, static_cast<uint32_t>(v)).first->second;
+				++copies[weld[v]];
+			}
+
+			std::unordered_map<uint64_t, uint32_t> edgeUses;
+			edgeUses.reserve(indices.size());
+			for (size_t i = 0; i < indices.size(); i += 3) {
+				for (int e = 0; e < 3; ++e) {
+					const uint64_t a = weld[indices[i + e]], b = weld[indices[i + (e + 1) % 3]];
+					++edgeUses[std::min(a, b) << 32 | std::max(a, b)];
+				}
+			}
+
+			std::vector<uint8_t> lockedWeld(vertices.size(), 0);
+			for (std::unordered_map<uint64_t, uint32_t>::const_iterator it = edgeUses.begin(); it != edgeUses.end(); ++it) {
+				if (it->second != 1) continue;
+				lockedWeld[it->first >> 32] = 1;
+				lockedWeld[it->first & 0xFFFFFFFFu] = 1;
+			}
+
+			std::vector<uint8_t> locked(vertices.size(), 0);
+			for (size_t v = 0; v < vertices.size(); ++v) locked[v] = lockedWeld[weld[v]] || copies[weld[v]] > 1;
+			return locked;
+		}
+	}
+
+	float MeshSimplifier::simplify(const std::vector<Math::Vertex>& vertices, const std::vector<unsigned int>& indices,
+		const size_t targetIndices, const float maxError, const float radius, std::vector<unsigned int>& out) {
+		out = indices;
+		if (indices.size() <= targetIndices || vertices.empty() || radius <= 0.0f) return 0.0f;
+
+		const std::vector<uint8_t> locked = findLockedVertices(vertices, indices);
+
+		// Unweighted planes keep costs in squared distance units, so the error converts straight to a length
+		std::vector<Quadric> quadrics(vertices.size());
+		for (size_t i = 0; i < indices.size(); i += 3) {
+			const Math::Vec3<float>& a = vertices[indices[i]].pos;
+			Math::Vec3<float> normal = triangleNormal(a, vertices[indices[i + 1]].pos, vertices[indices[i + 2]].pos);
+			const float length = normal.length();
+			if (length <= 0.0f) continue;
+			normal = normal * (1.0f / length);
+
+			Quadric plane;
+			plane.addPlane(normal.x, normal.y, normal.z, -normal.dot(a));
+			for (int corner = 0; corner < 3; ++corner) quadrics[indices[i + corner]].add(plane);
+		}
+
+		const double maxCost = static_cast<double>(maxError) * radius * maxError * radius;
+		double worstCost = 0.0;
+
+		std::vector<uint32_t> remap(vertices.size());
+		std::vector<uint8_t> touched(vertices.size());
+		std::vector<uint32_t> firstTriangle(vertices.size() + 1), vertexTriangles;
+		std::vector<Collapse> collapses;
+
+		while (out.size() > targetIndices) {
+			const size_t triangles = out.size() / 3;
+
+			// Triangles around each vertex, as offsets into vertexTriangles
+			std::fill(firstTriangle.begin(), firstTriangle.end(), 0);
+			for (const unsigned int index : out) ++firstTriangle[index + 1];
+			for (size_t v = 0; v < vertices.size(); ++v) firstTriangle[v + 1] += firstTriangle[v];
+			vertexTriangles.resize(out.size());
+			std::vector<uint32_t> fill(firstTriangle.begin(), firstTriangle.end() - 1);
+			for (size_t t = 0; t < triangles; ++t)
+				for (int corner = 0; corner < 3; ++corner) vertexTriangles[fill[out[t * 3 + corner]]++] = static_cast<uint32_t>(t);
+
+			// Interior edges appear once per side, keeping a < b visits each once
+			collapses.clear();
+			for (size_t t = 0; t < triangles; ++t) {
+				for (int e = 0; e < 3; ++e) {
+					const uint32_t a = out[t * 3 + e], b = out[t * 3 + (e + 1) % 3];
+					if (a > b || (locked[a] && locked[b])) continue;
+
+					Quadric merged = quadrics[a];
+					merged.add(quadrics[b]);
+					const double costToB = locked[a] ? -1.0 : merged.evaluate(vertices[b].pos);
+					const double costToA = locked[b] ? -1.0 : merged.evaluate(vertices[a].pos);
+					if (costToA < 0.0 || (costToB >= 0.0 && costToB <= costToA)) collapses.push_back({ a, b, costToB });
+					else collapses.push_back({ b, a, costToA });
+				}
+			}
+			std::sort(collapses.begin(), collapses.end(), [](const Collapse& l, const Collapse& r) { return l.cost < r.cost; });
+
+			for (size_t v = 0; v < vertices.size(); ++v) remap[v] = static_cast<uint32_t>(v);
+			std::fill(touched.begin(), touched.end(), 0);
+
+			size_t removed = 0, collapsed = 0;
+			const size_t removeTarget = triangles - targetIndices / 3;
+			for (const Collapse& collapse : collapses) {
+				if (collapse.cost > maxCost || removed >= removeTarget) break;
+				if (touched[collapse.from] || touched[collapse.to]) continue;
+
+				// Triangles that keep existing must not turn over once from moves onto to
+				bool flips = false;
+				size_t degenerate = 0;
+				const Math::Vec3<float>& target = vertices[collapse.to].pos;
+				for (uint32_t i = firstTriangle[collapse.from]; i < firstTriangle[collapse.from + 1] && !flips; ++i) {
+					const unsigned int* corners = &out[vertexTriangles[i] * 3];
+					if (corners[0] == collapse.to || corners[1] == collapse.to || corners[2] == collapse.to) {
+						++degenerate;
+						continue;
+					}
+
+					Math::Vec3<float> before[3], after[3];
+					for (int c = 0; c < 3; ++c) {
+						before[c] = vertices[corners[c]].pos;
+						after[c] = corners[c] == collapse.from ? target : before[c];
+					}
+					const Math::Vec3<float> oldNormal = triangleNormal(before[0], before[1], before[2]);
+					const Math::Vec3<float> newNormal = triangleNormal(after[0], after[1], after[2]);
+					flips = oldNormal.dot(newNormal) <= 0.0f;
+				}
+				if (flips) continue;
+
+				remap[collapse.from] = collapse.to;
+				quadrics[collapse.to].add(quadrics[collapse.from]);
+				worstCost = std::max(worstCost, collapse.cost);
+				removed += degenerate;
+				++collapsed;
+
+				// Independent collapses only: the one-rings of both ends are frozen until the next pass
+				for (const uint32_t end : { collapse.from, collapse.to })
+					for (uint32_t i = firstTriangle[end]; i < firstTriangle[end + 1]; ++i)
+						for (int c = 0; c < 3; ++c) touched[out[vertexTriangles[i] * 3 + c]] = 1;
+			}
+			if (collapsed == 0) break;
+
+			size_t kept = 0;
+			for (size_t t = 0; t < triangles; ++t) {
+				const unsigned int a = remap[out[t * 3]], b = remap[out[t * 3 + 1]], c = remap[out[t * 3 + 2]];
+				if (a == b || b == c || a == c) continue;
+				out[kept++] = a;
+				out[kept++] = b;
+				out[kept++] = c;
+			}
+			out.resize(kept);
+		}
+
+		return static_cast<float>(std::sqrt(worstCost)) / radius;
+	}
+
+	bool MeshSimplifier::buildLodChain(MeshCPU& mesh, const MeshLodSettings& settings) {
+		if (settings.maxLods == 0) return true;
+		if (mesh.empty()) return Logger::error("MeshSimplifier", "buildLodChain", "Mesh has no geometry");
+
+		if (!mesh.hasBounds) mesh.computeBounds();
+		mesh.lods.clear();
+		mesh.lods.push_back({ 0, mesh.numIndices, 0.0f });
+
+		std::vector<unsigned int> source(mesh.indices.begin(), mesh.indices.begin() + mesh.numIndices);
+		std::vector<unsigned int> simplified;
+		float error = 0.0f;
+		for (uint32_t level = 1; level <= settings.maxLods; ++level) {
+			const size_t target = static_cast<size_t>(source.size() / 3 * settings.reduction) * 3;
+			if (target / 3 < settings.minTriangles) break;
+
+			error = std::max(error, simplify(mesh.vertices, source, target, settings.maxError, mesh.boundingRadius, simplified));
+
+			// A level that barely shrank costs memory without saving anything
+			if (simplified.size() > source.size() * 9 / 10) break;
+
+			mesh.lods.push_back({ static_cast<uint32_t>(mesh.indices.size()), static_cast<uint32_t>(simplified.size()), error });
+			mesh.indices.insert(mesh.indices.end(), simplified.begin(), simplified.end());
+			source.swap(simplified);
+		}
+
+		if (mesh.lods.size() == 1) mesh.lods.clear();
+		return true;
+	}
+}
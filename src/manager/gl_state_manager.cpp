@@ -4,21 +4,157 @@
 #include <glad/glad.h>
 
 namespace Starlet::Graphics {
+	bool GLStateManager::changed(unsigned int& shadow, const unsigned int value) {
+		if (shadow == value) {
+			++stats.skipped;
+			return false;
+		}
+
+		shadow = value;
+		++stats.issued;
+		return true;
+	}
+
+	int GLStateManager::textureTargetIndex(const unsigned int target) {
+		switch (target) {
+		case GL_TEXTURE_2D:       return 0;
+		case GL_TEXTURE_CUBE_MAP: return 1;
+		case GL_TEXTURE_2D_ARRAY: return 2;
+		case GL_TEXTURE_3D:       return 3;
+		default:                  return -1;
+		}
+	}
+
+	int GLStateManager::bufferTargetIndex(const unsigned int target) {
+		switch (target) {
+		case GL_UNIFORM_BUFFER:        return 0;
+		case GL_SHADER_STORAGE_BUFFER: return 1;
+		case GL_ARRAY_BUFFER:          return 2;
+		case GL_ELEMENT_ARRAY_BUFFER:  return 3;
+		case GL_COPY_READ_BUFFER:      return 4;
+		case GL_COPY_WRITE_BUFFER:     return 5;
+		case GL_PIXEL_UNPACK_BUFFER:   return 6;
+		case GL_DRAW_INDIRECT_BUFFER:  return 7;
+		default:                       return -1;
+		}
+	}
+
 	bool GLStateManager::setProgram(const unsigned int id) {
 		if (id == 0) return Logger::error("Renderer", "setProgram", "Program is 0");
 
-		glUseProgram(id);
-		this->program = id;
+		// The program id is never UNKNOWN, so invalidate() leaves it at 0 to force the next bind
+		if (changed(program, id)) glUseProgram(id);
 		return true;
 	}
 
+	void GLStateManager::setDepthTest(const bool enabled) {
+		if (!changed(depthTest, enabled ? 1u : 0u)) return;
+		if (enabled) glEnable(GL_DEPTH_TEST);
+		else glDisable(GL_DEPTH_TEST);
+	}
+	void GLStateManager::setDepthMask(const bool write) {
+		if (changed(depthMask, write ? 1u : 0u)) glDepthMask(write ? GL_TRUE : GL_FALSE);
+	}
+	void GLStateManager::setDepthFunc(const unsigned int func) {
+		if (changed(depthFunc, func)) glDepthFunc(func);
+	}
+	void GLStateManager::setColourMask(const bool write) {
+		const GLboolean mask = write ? GL_TRUE : GL_FALSE;
+		if (changed(colourMask, write ? 1u : 0u)) glColorMask(mask, mask, mask, mask);
+	}
+
+	void GLStateManager::setBlend(const bool enabled) {
+		if (!changed(blend, enabled ? 1u : 0u)) return;
+		if (enabled) glEnable(GL_BLEND);
+		else glDisable(GL_BLEND);
+	}
+	void GLStateManager::setBlendFunc(const unsigned int src, const unsigned int dst) {
+		if (blendSrc == src && blendDst == dst) {
+			++stats.skipped;
+			return;
+		}
+
+		blendSrc = src;
+		blendDst = dst;
+		++stats.issued;
+		glBlendFunc(src, dst);
+	}
+
+	void GLStateManager::setCulling(const bool enabled) {
+		if (!changed(culling, enabled ? 1u : 0u)) return;
+		if (enabled) glEnable(GL_CULL_FACE);
+		else glDisable(GL_CULL_FACE);
+	}
+	void GLStateManager::setCullFace(const unsigned int face) {
+		if (changed(cullFace, face)) glCullFace(face);
+	}
+
+	void GLStateManager::bindVertexArray(const unsigned int vao) {
+		if (!changed(vertexArray, vao)) return;
+		glBindVertexArray(vao);
+		++stats.vertexArrayBinds;
+
+		// The element buffer binding belongs to the VAO
+		buffers[bufferTargetIndex(GL_ELEMENT_ARRAY_BUFFER)] = UNKNOWN;
+	}
+	void GLStateManager::bindBuffer(const unsigned int target, const unsigned int buffer) {
+		const int index = bufferTargetIndex(target);
+		if (index < 0) {
+			glBindBuffer(target, buffer);
+			++stats.issued;
+			return;
+		}
+		if (changed(buffers[index], buffer)) glBindBuffer(target, buffer);
+	}
+	void GLStateManager::bindBufferBase(const unsigned int target, const unsigned int index, const unsigned int buffer) {
+		const int targetIndex = bufferTargetIndex(target);
+		if (targetIndex < 0 || targetIndex >= static_cast<int>(INDEXED_BUFFER_TARGETS) || index >= MAX_BUFFER_BINDINGS) {
+			// Untracked binding point, issue it and forget the generic binding it replaced
+			glBindBufferBase(target, index, buffer);
+			++stats.issued;
+			if (targetIndex >= 0) buffers[targetIndex] = UNKNOWN;
+			return;
+		}
+
+		if (!changed(indexedBuffers[targetIndex][index], buffer)) return;
+		glBindBufferBase(target, index, buffer);
+		buffers[targetIndex] = buffer;
+	}
+
+	void GLStateManager::setActiveTexture(const unsigned int unit) {
+		if (changed(activeTexture, unit)) glActiveTexture(GL_TEXTURE0 + unit);
+	}
+	void GLStateManager::bindTexture(const unsigned int unit, const unsigned int target, const unsigned int texture) {
+		const int index = textureTargetIndex(target);
+		if (unit >= MAX_TEXTURE_UNITS || index < 0) {
+			// Untracked binding, issue it and forget what the unit holds
+			setActiveTexture(unit);
+			glBindTexture(target, texture);
+			++stats.issued;
+			++stats.textureBinds;
+			if (unit < MAX_TEXTURE_UNITS)
+				for (unsigned int i = 0; i < TEXTURE_TARGETS; ++i) textures[unit][i] = UNKNOWN;
+			return;
+		}
+
+		if (textures[unit][index] == texture) {
+			++stats.skipped;
+			return;
+		}
+
+		setActiveTexture(unit);
+		changed(textures[unit][index], texture);
+		glBindTexture(target, texture);
+		++stats.textureBinds;
+	}
+
 	void GLStateManager::setGLStateDefault() {
-		glEnable(GL_DEPTH_TEST);
-		glDepthFunc(GL_LEQUAL);
-		glEnable(GL_CULL_FACE);
-		glCullFace(GL_BACK);
-		glEnable(GL_BLEND);
-		glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+		setDepthTest(true);
+		setDepthFunc(GL_LEQUAL);
+		setCulling(true);
+		setCullFace(GL_BACK);
+		setBlend(true);
+		setBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 		glClearColor(0.2f, 0.2f, 0.2f, 1.0f);
 	}
 
@@ -26,4 +162,20 @@ namespace Starlet::Graphics {
 		wireframe = !wireframe;
 		glPolygonMode(GL_FRONT_AND_BACK, wireframe ? GL_LINE : GL_FILL);
 	}
+
+	void GLStateManager::invalidate() {
+		program = 0;
+		depthTest = depthMask = depthFunc = UNKNOWN;
+		colourMask = UNKNOWN;
+		blend = blendSrc = blendDst = UNKNOWN;
+		culling = cullFace = UNKNOWN;
+		vertexArray = activeTexture = UNKNOWN;
+		for (unsigned int unit = 0; unit < MAX_TEXTURE_UNITS; ++unit)
+			for (unsigned int target = 0; target < TEXTURE_TARGETS; ++target)
+				textures[unit][target] = UNKNOWN;
+		for (unsigned int target = 0; target < BUFFER_TARGETS; ++target) buffers[target] = UNKNOWN;
+		for (unsigned int target = 0; target < INDEXED_BUFFER_TARGETS; ++target)
+			for (unsigned int index = 0; index < MAX_BUFFER_BINDINGS; ++index)
+				indexedBuffers[target][index] = UNKNOWN;
+	}
 }
@@ -2,21 +2,99 @@
 #include "starlet-logger/logger.hpp"
 
 #include "starlet-serializer/data/mesh_data.hpp"
+#include "starlet-graphics/streaming/staging_uploader.hpp"
+#include "starlet-graphics/jobs/job_system.hpp"
+
+#include <set>
 
 namespace Starlet::Graphics {
 	MeshManager::~MeshManager() {
-		for (std::map<std::string, MeshGPU>::iterator it = pathToGPUMeshes.begin(); it != pathToGPUMeshes.end(); ++it)
-			handler.unload(it->second);
+		for (std::vector<MeshGPU>::iterator it = gpuMeshes.begin(); it != gpuMeshes.end(); ++it)
+			handler.unload(*it);
 	}
 
 	bool MeshManager::loadAndAddMesh(const std::string& path) {
 		if (exists(path)) return Logger::debug("MeshManager", "addMesh", "Mesh already exists: " + path);
 
-		Serializer::MeshData data;
-		if(!parser.parse(basePath + path, data))
-			return Logger::error("MeshManager", "loadAndAddMesh", "Could not load mesh from " + path);
+		const bool isPly = path.size() >= 4 && path.compare(path.size() - 4, 4, ".ply") == 0;
+		if (streamUploads && !retainGeometry && isPly && streamMesh(path))
+			return Logger::debug("MeshManager", "addMesh", "Streamed mesh: " + path);
 
 		MeshCPU meshCPU;
+		if (!parseMesh(path, meshCPU, parser, plyParser, plyJobs))
+			return Logger::error("MeshManager", "loadAndAddMesh", "Could not load mesh from " + path);
+
+		meshCPU.computeBounds();
+		if (!MeshSimplifier::buildLodChain(meshCPU, lodSettings))
+			Logger::error("MeshManager", "loadAndAddMesh", "Could not build levels of detail for: " + path);
+
+		if (!uploadAndStore(path, meshCPU))
+			return Logger::error("MeshManager", "loadAndAddMesh", "Could not upload mesh from: " + path);
+		return Logger::debug("MeshManager", "addMesh", "Added mesh: " + path);
+	}
+	bool MeshManager::loadAndAddMeshes(const std::vector<std::string>& paths) {
+		if (!loadJobs || !loadJobs->isRunning()) {
+			for (const std::string& path : paths)
+				if (!loadAndAddMesh(path)) return false;
+			return true;
+		}
+
+		// Streamed meshes, repeats and meshes already added go through loadAndAddMesh afterwards
+		std::vector<uint32_t> batch;
+		std::set<std::string> seen;
+		for (uint32_t i = 0; i < paths.size(); ++i) {
+			const std::string& path = paths[i];
+			const bool isPly = path.size() >= 4 && path.compare(path.size() - 4, 4, ".ply") == 0;
+			if (exists(path) || (streamUploads && !retainGeometry && isPly) || !seen.insert(path).second) continue;
+			batch.push_back(i);
+		}
+
+		struct Loaded {
+			MeshCPU mesh;
+			MeshBvh bvh;
+			MeshHandler::StagedMesh staged;
+			bool parsed{ false };
+		};
+		std::vector<Loaded> loaded(batch.size());
+
+		// Workers parse, simplify, build the BVH and copy into the staging ring without touching GL or the slots
+		StagingUploader* const ring = (staging && staging->isReady()) ? staging : nullptr;
+		loadJobs->parallelFor(static_cast<uint32_t>(batch.size()), 1, [&](const uint32_t begin, const uint32_t end) {
+			Serializer::MeshParser meshParser;
+			PlyParser ply;
+			for (uint32_t i = begin; i < end; ++i) {
+				Loaded& entry = loaded[i];
+				entry.parsed = parseMesh(paths[batch[i]], entry.mesh, meshParser, ply, nullptr);
+				if (!entry.parsed) continue;
+
+				entry.mesh.computeBounds();
+				MeshSimplifier::buildLodChain(entry.mesh, lodSettings);
+				if (buildBvh) entry.bvh.build(entry.mesh, nullptr, bvhSettings);
+				if (ring) MeshHandler::stage(entry.mesh, *ring, entry.staged);
+			}
+		});
+
+		bool ok = true;
+		for (size_t i = 0; i < batch.size(); ++i) {
+			const std::string& path = paths[batch[i]];
+			if (!loaded[i].parsed)
+				ok = Logger::error("MeshManager", "loadAndAddMeshes", "Could not load mesh from " + path);
+			else if (!uploadAndStore(path, loaded[i].mesh, std::move(loaded[i].bvh), loaded[i].staged))
+				ok = Logger::error("MeshManager", "loadAndAddMeshes", "Could not upload mesh from: " + path);
+		}
+
+		for (const std::string& path : paths)
+			if (!exists(path) && !loadAndAddMesh(path)) ok = false;
+		return ok;
+	}
+
+	bool MeshManager::parseMesh(const std::string& path, MeshCPU& meshCPU, Serializer::MeshParser& meshParser, PlyParser& ply, JobSystem* jobs) const {
+		const bool isPly = path.size() >= 4 && path.compare(path.size() - 4, 4, ".ply") == 0;
+		if (fastPly && isPly && ply.parse(basePath + path, meshCPU, jobs)) return true;
+
+		Serializer::MeshData data;
+		if (!meshParser.parse(basePath + path, data)) return false;
+
 		meshCPU.hasColours = data.hasColours;
 		meshCPU.hasNormals = data.hasNormals;
 		meshCPU.hasTexCoords = data.hasTexCoords;
@@ -27,47 +105,90 @@ namespace Starlet::Graphics {
 		meshCPU.vertices = std::move(data.vertices);
 		meshCPU.minY = data.minY;
 		meshCPU.maxY = data.maxY;
-
-		MeshGPU meshGPU;
-		if (!handler.upload(meshCPU, meshGPU))
-			return Logger::error("MeshManager", "loadAndAddMesh", "Could not upload mesh from: " + path);
-
-		pathToGPUMeshes[path] = std::move(meshGPU);
-		pathToCPUMeshes[path] = std::move(meshCPU);
-		return Logger::debug("MeshManager", "addMesh", "Added mesh: " + path);
+		return true;
 	}
+
 	bool MeshManager::addMesh(const std::string& path, MeshCPU& meshCPU) {
 		if (exists(path)) return true;
 		if (meshCPU.empty()) return Logger::error("MeshManager", "addMesh", "Trying to add an empty mesh");
 
-		MeshGPU meshGPU;
-		if(!handler.upload(meshCPU, meshGPU))
-			return Logger::error("MeshManager", "addMesh", "Could not upload mesh from: " + path);
+		meshCPU.computeBounds();
+		if (!MeshSimplifier::buildLodChain(meshCPU, lodSettings))
+			Logger::error("MeshManager", "addMesh", "Could not build levels of detail for: " + path);
 
-		pathToGPUMeshes[path] = std::move(meshGPU);
-		pathToCPUMeshes[path] = std::move(meshCPU);
+		if (!uploadAndStore(path, meshCPU))
+			return Logger::error("MeshManager", "addMesh", "Could not upload mesh from: " + path);
 		return Logger::debug("MeshManager", "addMesh", "Added mesh: " + path);
 	}
 
+	bool MeshManager::streamMesh(const std::string& path) {
+		MeshCPU meshCPU;
+		MeshGPU meshGPU;
+		MeshStreamUploader uploader(handler, meshGPU, streamChunkBytes);
+		if (!plyParser.stream(basePath + path, uploader, meshCPU)) return false;
+
+		lastStreamStats = uploader.getStats();
+		store(path, meshCPU, meshGPU);
+		return true;
+	}
+
+	bool MeshManager::uploadAndStore(const std::string& path, MeshCPU& meshCPU) {
+		// Built first, the handler frees the geometry once it is on the GPU unless it is being retained
+		MeshBvh bvh;
+		if (buildBvh && !bvh.build(meshCPU, bvhJobs, bvhSettings))
+			Logger::error("MeshManager", "uploadAndStore", "Could not build BVH for: " + path);
+
+		MeshHandler::StagedMesh staged;
+		if (staging && staging->isReady() && !meshCPU.empty()) MeshHandler::stage(meshCPU, *staging, staged);
+		return uploadAndStore(path, meshCPU, std::move(bvh), staged);
+	}
+	bool MeshManager::uploadAndStore(const std::string& path, MeshCPU& meshCPU, MeshBvh&& bvh, const MeshHandler::StagedMesh& staged) {
+		MeshGPU meshGPU;
+		handler.setKeepGeometry(retainGeometry);
+		const bool uploaded = staging ? handler.upload(meshCPU, meshGPU, *staging, staged) : handler.upload(meshCPU, meshGPU);
+		handler.setKeepGeometry(false);
+		if (!uploaded) return false;
+
+		store(path, meshCPU, meshGPU, std::move(bvh));
+		return true;
+	}
+
+	void MeshManager::store(const std::string& path, MeshCPU& meshCPU, MeshGPU& meshGPU, MeshBvh&& bvh) {
+		MeshInfo info = MeshInfo::describe(meshCPU);
+		info.retainsGeometry = retainGeometry && !meshCPU.vertices.empty();
+
+		pathToSlot[path] = static_cast<uint32_t>(infos.size());
+		infos.push_back(info);
+		gpuMeshes.push_back(std::move(meshGPU));
+		bvhs.push_back(std::move(bvh));
+		if (info.retainsGeometry) retainedMeshes[path] = std::move(meshCPU);
+	}
+
+	uint32_t MeshManager::getSlot(const std::string& path) const {
+		std::map<std::string, uint32_t>::const_iterator it = pathToSlot.find(path);
+		return it != pathToSlot.end() ? it->second : INVALID_SLOT;
+	}
+
+	const MeshInfo* MeshManager::getMeshInfo(const std::string& name) const {
+		return getMeshInfo(getSlot(name));
+	}
+
 	MeshGPU* MeshManager::getMeshGPU(const std::string& name) {
-		std::map<std::string, MeshGPU>::iterator it = pathToGPUMeshes.find(name);
-		if (it == pathToGPUMeshes.end()) return nullptr;
-		return &it->second;
+		const uint32_t slot = getSlot(name);
+		return slot < gpuMeshes.size() ? &gpuMeshes[slot] : nullptr;
 	}
 	const MeshGPU* MeshManager::getMeshGPU(const std::string& name) const {
-		std::map<std::string, MeshGPU>::const_iterator it = pathToGPUMeshes.find(name);
-		if (it == pathToGPUMeshes.end()) return nullptr;
-		return &it->second;
+		return getMeshGPU(getSlot(name));
 	}
 
 	MeshCPU* MeshManager::getMeshCPU(const std::string& name) {
-		std::map<std::string, MeshCPU>::iterator it = pathToCPUMeshes.find(name);
-		if (it == pathToCPUMeshes.end()) return nullptr;
+		std::map<std::string, MeshCPU>::iterator it = retainedMeshes.find(name);
+		if (it == retainedMeshes.end()) return nullptr;
 		return &it->second;
 	}
 	const MeshCPU* MeshManager::getMeshCPU(const std::string& name) const {
-		std::map<std::string, MeshCPU>::const_iterator it = pathToCPUMeshes.find(name);
-		if (it == pathToCPUMeshes.end()) return nullptr;
+		std::map<std::string, MeshCPU>::const_iterator it = retainedMeshes.find(name);
+		if (it == retainedMeshes.end()) return nullptr;
 		return &it->second;
 	}
 }
\ No newline at end of file
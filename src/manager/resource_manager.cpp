@@ -9,6 +9,8 @@
 #include "starlet-scene/component/transform.hpp"
 #include "starlet-scene/component/colour.hpp"
 
+#include "starlet-graphics/resource/texture_cpu.hpp"
+
 namespace Starlet::Graphics {
   ResourceManager::ResourceManager() : meshFactory(meshManager) {}
 
@@ -19,13 +21,26 @@ namespace Starlet::Graphics {
 
   ResourceHandle ResourceManager::addMesh(const std::string& path) {
     auto it = meshPathToHandle.find(path);
-    if (it != meshPathToHandle.end()) return it->second;
+    if (it != meshPathToHandle.end()) {
+      // Registered before it was loaded
+      if (meshSlots[it->second.id] == MeshManager::INVALID_SLOT) meshSlots[it->second.id] = meshManager.getSlot(path);
+      return it->second;
+    }
 
     ResourceHandle handle{ nextMeshId++ };
     meshPathToHandle[path] = handle;
     meshHandleToPath[handle.id] = path;
+    if (meshSlots.size() <= handle.id) meshSlots.resize(handle.id + 1, MeshManager::INVALID_SLOT);
+    meshSlots[handle.id] = meshManager.getSlot(path);
     return handle;
   }
+  ResourceHandle ResourceManager::addPrimitiveMesh(const Scene::Primitive& primitive, const Scene::TransformComponent& transform, const Scene::ColourComponent& colour) {
+    if (!meshFactory.createPrimitiveMesh(primitive, transform, colour)) {
+      Logger::error("ResourceManager", "addPrimitiveMesh", "Failed to create mesh for primitive: " + primitive.name);
+      return ResourceHandle{ 0 };
+    }
+    return addMesh(primitive.name);
+  }
   bool ResourceManager::hasMesh(const std::string& path) const {
     return meshPathToHandle.find(path) != meshPathToHandle.end();
   }
@@ -46,6 +61,10 @@ namespace Starlet::Graphics {
     textureNameToHandle[name] = handle;
     return handle;
   }
+  ResourceHandle ResourceManager::addTexture(const std::string& name, TextureCPU& cpu) {
+    if (!textureManager.addTexture(name, cpu)) return ResourceHandle{ 0 };
+    return addTexture(name, textureManager.getTextureID(name));
+  }
   bool ResourceManager::hasTexture(const std::string& name) const {
     return textureNameToHandle.find(name) != textureNameToHandle.end();
   }
@@ -57,6 +76,19 @@ namespace Starlet::Graphics {
     return it != textureNameToHandle.end() ? it->second : ResourceHandle{ 0 };
   }
 
+  void ResourceManager::setTextureStreaming(const bool enabled, const StreamingBudget& budget) {
+    textureManager.setStreamingBudget(budget);
+    textureManager.setStreaming(enabled);
+  }
+
+  bool ResourceManager::enableStagedUploads(const uint64_t capacity) {
+    if (!staging.init(capacity)) return Logger::error("ResourceManager", "enableStagedUploads", "Falling back to direct uploads");
+
+    meshManager.setStagingUploader(&staging);
+    textureManager.setStagingUploader(&staging);
+    return true;
+  }
+
 
 
   unsigned int ResourceManager::getTextureID(ResourceHandle handle) const {
@@ -68,13 +100,17 @@ namespace Starlet::Graphics {
     return textureManager.getTextureID(it->second);
   }
 
+  const MeshInfo* ResourceManager::getMeshInfo(ResourceHandle handle) const {
+    if (!handle.isValid() || handle.id >= meshSlots.size()) return nullptr;
+    return meshManager.getMeshInfo(meshSlots[handle.id]);
+  }
   const MeshGPU* ResourceManager::getMeshGPU(ResourceHandle handle) const {
-    if (!handle.isValid()) return nullptr;
-
-    auto it = meshHandleToPath.find(handle.id);
-    if (it == meshHandleToPath.end()) return nullptr;
-
-    return meshManager.getMeshGPU(it->second);
+    if (!handle.isValid() || handle.id >= meshSlots.size()) return nullptr;
+    return meshManager.getMeshGPU(meshSlots[handle.id]);
+  }
+  const MeshBvh* ResourceManager::getMeshBvh(ResourceHandle handle) const {
+    if (!handle.isValid() || handle.id >= meshSlots.size()) return nullptr;
+    return meshManager.getMeshBvh(meshSlots[handle.id]);
   }
   const MeshCPU* ResourceManager::getMeshCPU(ResourceHandle handle) const {
     if (!handle.isValid()) return nullptr;
@@ -87,6 +123,12 @@ namespace Starlet::Graphics {
 
 
   bool ResourceManager::loadMeshes(const std::vector<Scene::Model*>& models) {
+    std::vector<std::string> paths;
+    paths.reserve(models.size());
+    for (const Scene::Model* model : models) paths.push_back(model->meshPath);
+    if (!meshManager.loadAndAddMeshes(paths))
+      return Logger::error("ResourceLoader", "loadMeshes", "Failed to load meshes");
+
     for (Scene::Model* model : models) {
       if (!meshManager.loadAndAddMesh(model->meshPath))
         return Logger::error("ResourceLoader", "loadMeshes", "Failed to load/add mesh: " + model->meshPath);
@@ -100,6 +142,12 @@ namespace Starlet::Graphics {
     return Logger::debug("ResourceLoader", "loadMeshes", "Loaded and registered " + std::to_string(models.size()) + " meshes");
   }
   bool ResourceManager::loadTextures(const std::vector<Scene::TextureData*>& textures) {
+    std::vector<std::pair<std::string, std::string>> namesAndPaths;
+    for (const Scene::TextureData* texture : textures)
+      if (!texture->isCube) namesAndPaths.emplace_back(texture->name, texture->faces[0]);
+    if (!textureManager.addTextures(namesAndPaths))
+      return Logger::error("ResourceLoader", "loadTextures", "Failed to load 2D textures");
+
     for (const Scene::TextureData* texture : textures) {
       unsigned int textureID = 0;
 
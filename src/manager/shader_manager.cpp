@@ -5,38 +5,289 @@
 
 #include <glad/glad.h>
 
+#include <iterator>
+
 namespace Starlet::Graphics {
 	ShaderManager::~ShaderManager() {
 		for (std::map<std::string, ShaderGPU>::iterator it = nameToShaders.begin(); it != nameToShaders.end(); ++it)
 			handler.unload(it->second);
+
+		for (std::map<std::string, PendingProgram>::iterator it = nameToPending.begin(); it != nameToPending.end(); ++it)
+			handler.unload(it->second.gpu);
+
+		for (std::map<std::string, VariantProgram>::iterator it = nameToVariants.begin(); it != nameToVariants.end(); ++it)
+			for (std::unordered_map<uint32_t, ShaderGPU>::iterator variant = it->second.compiled.begin(); variant != it->second.compiled.end(); ++variant)
+				handler.unload(variant->second);
 	}
 
 	bool ShaderManager::createProgramFromPaths(const std::string& name, const std::string& vertPath, const std::string& fragPath) {
-		if (exists(name)) {
-			std::map<std::string, ShaderGPU>::iterator it = nameToShaders.find(name);
-			handler.unload(it->second);
-			nameToShaders.erase(it);
-		}
+		release(name);
 
 		ShaderCPU cpu;
+		if (!loadSources(cpu, vertPath, fragPath)) return false;
+		applyInvariantPosition(cpu);
+
+		ShaderGPU gpu;
+		if (!handler.upload(cpu, gpu))
+			return Logger::error("ShaderManager", "createProgramFromPaths", "Failed to upload shader");
+		gpu.invariantPosition = declaresInvariantPosition(cpu.vertexSource);
+
+		nameToShaders[name] = std::move(gpu);
+		return true;
+	}
+
+	bool ShaderManager::createProgramFromSources(const std::string& name, const std::string& vertSource, const std::string& fragSource) {
+		release(name);
+
+		ShaderCPU cpu;
+		cpu.vertexSource = vertSource;
+		cpu.fragmentSource = fragSource;
+		cpu.valid = true;
+		applyInvariantPosition(cpu);
+
+		ShaderGPU gpu;
+		if (!handler.upload(cpu, gpu))
+			return Logger::error("ShaderManager", "createProgramFromSources", "Failed to upload shader: " + name);
+		gpu.invariantPosition = declaresInvariantPosition(cpu.vertexSource);
+
+		nameToShaders[name] = std::move(gpu);
+		return true;
+	}
+
+	bool ShaderManager::submitProgramFromPaths(const std::string& name, const std::string& vertPath, const std::string& fragPath) {
+		release(name);
+
+		PendingProgram pending;
+		if (!loadSources(pending.cpu, vertPath, fragPath)) {
+			failedPrograms.insert(name);
+			return false;
+		}
+		applyInvariantPosition(pending.cpu);
+
+		if (!handler.submit(pending.cpu, pending.gpu)) {
+			failedPrograms.insert(name);
+			return Logger::error("ShaderManager", "submitProgramFromPaths", "Failed to submit shader: " + name);
+		}
+
+		nameToPending[name] = std::move(pending);
+		return true;
+	}
+
+	ProgramState ShaderManager::pollProgram(const std::string& name) {
+		if (nameToShaders.find(name) != nameToShaders.end()) return ProgramState::Ready;
+		if (failedPrograms.find(name) != failedPrograms.end()) return ProgramState::Failed;
+
+		std::map<std::string, PendingProgram>::iterator it = nameToPending.find(name);
+		if (it == nameToPending.end()) return ProgramState::Missing;
+		if (!handler.isComplete(it->second.gpu)) return ProgramState::Pending;
+		return complete(it);
+	}
+
+	size_t ShaderManager::pollPendingPrograms() {
+		std::map<std::string, PendingProgram>::iterator it = nameToPending.begin();
+		while (it != nameToPending.end()) {
+			std::map<std::string, PendingProgram>::iterator next = std::next(it);
+			if (handler.isComplete(it->second.gpu)) complete(it);
+			it = next;
+		}
+		return nameToPending.size();
+	}
+
+	bool ShaderManager::finishPendingPrograms() {
+		// finish() blocks on status queries, so the first program absorbs most of the wait while the rest complete in parallel
+		bool allReady = true;
+		while (!nameToPending.empty())
+			if (complete(nameToPending.begin()) != ProgramState::Ready) allReady = false;
+		return allReady;
+	}
+
+	ProgramState ShaderManager::complete(std::map<std::string, PendingProgram>::iterator it) {
+		const std::string name = it->first;
+		PendingProgram& pending = it->second;
+
+		const bool linked = handler.finish(pending.cpu, pending.gpu);
+		if (linked) {
+			pending.gpu.invariantPosition = declaresInvariantPosition(pending.cpu.vertexSource);
+			nameToShaders[name] = std::move(pending.gpu);
+		}
+		nameToPending.erase(it);
+
+		if (linked) return ProgramState::Ready;
+		failedPrograms.insert(name);
+		Logger::error("ShaderManager", "complete", "Failed to build shader: " + name);
+		return ProgramState::Failed;
+	}
+
+	bool ShaderManager::loadSources(ShaderCPU& cpu, const std::string& vertPath, const std::string& fragPath) {
 		if (!parser.loadFile(cpu.vertexSource, basePath + vertPath))
-			return Logger::error("ShaderLoader", "createProgramFromPaths", "Failed to load vertex shader source");
+			return Logger::error("ShaderLoader", "loadSources", "Failed to load vertex shader source");
 
 		if (!parser.loadFile(cpu.fragmentSource, basePath + fragPath))
-			return Logger::error("ShaderLoader", "createProgramFromPaths", "Failed to load fragment shader source");
+			return Logger::error("ShaderLoader", "loadSources", "Failed to load fragment shader source");
 
 		cpu.vertexPath = vertPath;
 		cpu.fragmentPath = fragPath;
 		cpu.valid = true;
+		return true;
+	}
+
+	void ShaderManager::release(const std::string& name) {
+		std::map<std::string, ShaderGPU>::iterator shader = nameToShaders.find(name);
+		if (shader != nameToShaders.end()) {
+			handler.unload(shader->second);
+			nameToShaders.erase(shader);
+		}
+
+		std::map<std::string, PendingProgram>::iterator pending = nameToPending.find(name);
+		if (pending != nameToPending.end()) {
+			handler.unload(pending->second.gpu);
+			nameToPending.erase(pending);
+		}
+
+		failedPrograms.erase(name);
+	}
+
+	bool ShaderManager::createVariantProgram(const std::string& name, const std::string& vertPath, const std::string& fragPath, const std::vector<VariantDefine>& defines) {
+		std::map<std::string, VariantProgram>::iterator existing = nameToVariants.find(name);
+		if (existing != nameToVariants.end()) {
+			for (std::unordered_map<uint32_t, ShaderGPU>::iterator variant = existing->second.compiled.begin(); variant != existing->second.compiled.end(); ++variant)
+				handler.unload(variant->second);
+			nameToVariants.erase(existing);
+		}
+
+		uint32_t totalBits = 0;
+		for (const VariantDefine& define : defines) totalBits += define.bitCount;
+		if (totalBits > 32) return Logger::error("ShaderManager", "createVariantProgram", "Variant defines exceed 32 mask bits: " + name);
+
+		VariantProgram program;
+		if (!parser.loadFile(program.vertexSource, basePath + vertPath))
+			return Logger::error("ShaderManager", "createVariantProgram", "Failed to load vertex shader source");
+
+		if (!parser.loadFile(program.fragmentSource, basePath + fragPath))
+			return Logger::error("ShaderManager", "createVariantProgram", "Failed to load fragment shader source");
+
+		program.vertexPath = vertPath;
+		program.fragmentPath = fragPath;
+		program.defines = defines;
+
+		// Variants compile lazily on first request
+		nameToVariants[name] = std::move(program);
+		return true;
+	}
+
+	unsigned int ShaderManager::getVariantProgramID(const std::string& name, const uint32_t mask) {
+		std::map<std::string, VariantProgram>::iterator it = nameToVariants.find(name);
+		if (it == nameToVariants.end()) return 0;
+
+		VariantProgram& program = it->second;
+		std::unordered_map<uint32_t, ShaderGPU>::const_iterator compiled = program.compiled.find(mask);
+		if (compiled != program.compiled.end()) return compiled->second.programID;
+		if (program.failed.find(mask) != program.failed.end()) return 0;
+
+		ShaderCPU cpu;
+		cpu.defines = buildDefines(program.defines, mask);
+		cpu.vertexSource = injectDefines(program.vertexSource, cpu.defines);
+		cpu.fragmentSource = injectDefines(program.fragmentSource, cpu.defines);
+		cpu.vertexPath = program.vertexPath;
+		cpu.fragmentPath = program.fragmentPath;
+		cpu.valid = true;
+		applyInvariantPosition(cpu);
 
 		ShaderGPU gpu;
-		if (!handler.upload(cpu, gpu))
-			return Logger::error("ShaderManager", "createProgramFromPaths", "Failed to upload shader");
+		if (!handler.upload(cpu, gpu)) {
+			program.failed[mask] = true;
+			Logger::error("ShaderManager", "getVariantProgramID", "Failed to compile variant " + std::to_string(mask) + " of: " + name);
+			return 0;
+		}
+		gpu.invariantPosition = declaresInvariantPosition(cpu.vertexSource);
 
-		nameToShaders[name] = std::move(gpu);
+		const unsigned int programID = gpu.programID;
+		program.compiled.emplace(mask, std::move(gpu));
+		return programID;
+	}
+
+	size_t ShaderManager::getVariantCount(const std::string& name) const {
+		std::map<std::string, VariantProgram>::const_iterator it = nameToVariants.find(name);
+		return (it == nameToVariants.end()) ? 0 : it->second.compiled.size();
+	}
+
+	std::string ShaderManager::buildDefines(const std::vector<VariantDefine>& defines, const uint32_t mask) {
+		std::string out;
+		uint32_t shift = 0;
+		for (const VariantDefine& define : defines) {
+			const uint32_t fieldMask = (define.bitCount >= 32) ? 0xffffffffu : ((1u << define.bitCount) - 1u);
+			const uint32_t value = (mask >> shift) & fieldMask;
+			shift += define.bitCount;
+
+			if (define.bitCount == 1) {
+				if (value) out += "#define " + define.name + "\n";
+			}
+			else out += "#define " + define.name + " " + std::to_string(value) + "\n";
+		}
+		return out;
+	}
+
+	std::string ShaderManager::injectDefines(const std::string& source, const std::string& defines) {
+		if (defines.empty()) return source;
+
+		// GLSL requires #version to come first, so defines go on the line after it
+		const size_t version = source.find("#version");
+		if (version == std::string::npos) return defines + source;
+
+		const size_t lineEnd = source.find('\n', version);
+		if (lineEnd == std::string::npos) return source + "\n" + defines;
+
+		std::string out;
+		out.reserve(source.size() + defines.size());
+		out.append(source, 0, lineEnd + 1);
+		out += defines;
+		out.append(source, lineEnd + 1, std::string::npos);
+		return out;
+	}
+
+	bool ShaderManager::declaresInvariantPosition(const std::string& vertexSource) {
+		return vertexSource.find("invariant gl_Position") != std::string::npos;
+	}
+
+	void ShaderManager::applyInvariantPosition(ShaderCPU& cpu) const {
+		if (invariantPosition && !declaresInvariantPosition(cpu.vertexSource))
+			cpu.vertexSource = injectDefines(cpu.vertexSource, "invariant gl_Position;\n");
+	}
+
+	bool ShaderManager::hasInvariantPosition(const unsigned int programID) const {
+		if (programID == 0) return false;
+		for (std::map<std::string, ShaderGPU>::const_iterator it = nameToShaders.begin(); it != nameToShaders.end(); ++it)
+			if (it->second.programID == programID) return it->second.invariantPosition;
+
+		for (std::map<std::string, VariantProgram>::const_iterator it = nameToVariants.begin(); it != nameToVariants.end(); ++it)
+			for (std::unordered_map<uint32_t, ShaderGPU>::const_iterator variant = it->second.compiled.begin(); variant != it->second.compiled.end(); ++variant)
+				if (variant->second.programID == programID) return variant->second.invariantPosition;
+		return false;
+	}
+
+	bool ShaderManager::hasInvariantVariants(const std::string& name) const {
+		std::map<std::string, VariantProgram>::const_iterator it = nameToVariants.find(name);
+		if (it == nameToVariants.end()) return false;
+
+		// Variants compile lazily, the ones still to come are only covered when injection is on or the source declares it
+		if (!invariantPosition && !declaresInvariantPosition(it->second.vertexSource)) return false;
+		for (std::unordered_map<uint32_t, ShaderGPU>::const_iterator variant = it->second.compiled.begin(); variant != it->second.compiled.end(); ++variant)
+			if (!variant->second.invariantPosition) return false;
 		return true;
 	}
 
+	void ShaderManager::setProgramCacheDirectory(const std::string& path) {
+		programCache.setDirectory(path);
+		handler.setProgramCache(programCache.isEnabled() ? &programCache : nullptr);
+	}
+
+	void ShaderManager::logProgramCacheStats() const {
+		const ProgramCacheStats& stats = programCache.getStats();
+		Logger::debug("ShaderManager", "logProgramCacheStats",
+			"Program cache hits: " + std::to_string(stats.hits) + ", misses: " + std::to_string(stats.misses)
+			+ ", rejected: " + std::to_string(stats.rejected) + ", stored: " + std::to_string(stats.stored));
+	}
+
 	unsigned int ShaderManager::getProgramID(const std::string& name) const {
 		std::map<std::string, ShaderGPU>::const_iterator it = nameToShaders.find(name);
 		return (it == nameToShaders.end()) ? 0u : it->second.programID;
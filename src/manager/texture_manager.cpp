@@ -3,11 +3,15 @@
 
 #include "starlet-serializer/data/image_data.hpp"
 #include "starlet-graphics/resource/texture_cpu.hpp"
+#include "starlet-graphics/streaming/staging_uploader.hpp"
+#include "starlet-graphics/jobs/job_system.hpp"
 
 namespace Starlet::Graphics {
   TextureManager::~TextureManager() {
-    for (std::map<std::string, TextureGPU>::iterator it = nameToGPUTextures.begin(); it != nameToGPUTextures.end(); ++it)
+    for (std::map<std::string, TextureGPU>::iterator it = nameToGPUTextures.begin(); it != nameToGPUTextures.end(); ++it) {
+      streamer.remove(it->second.id);
       handler.unload(it->second);
+    }
   }
 
   unsigned int TextureManager::getTextureID(const std::string& name) const {
@@ -15,28 +19,108 @@ namespace Starlet::Graphics {
     return (it == nameToGPUTextures.end()) ? 0u : it->second.id;
   }
 
+  bool TextureManager::loadImage(Serializer::ImageParser& imageParser, const std::string& fullPath, TextureCPU& out) {
+    Serializer::ImageData data;
+    if (!imageParser.parse(fullPath, data)) return false;
+
+    out.width = data.width;
+    out.height = data.height;
+    out.pixelSize = data.pixelSize;
+    out.byteSize = data.byteSize;
+    out.pixels = std::move(data.pixels);
+    return true;
+  }
+
   bool TextureManager::addTexture(const std::string& name, const std::string& path) {
     if (exists(name)) return true;
 
-    Serializer::ImageData data;
-    if (!parser.parse(basePath + path, data))
-      return Logger::error("TextureManager", "addTexture", "Failed load: " + basePath + path);
-
+    const std::string fullPath = basePath + path;
     TextureCPU cpuTexture;
-    cpuTexture.width = data.width;
-    cpuTexture.height = data.height;
-    cpuTexture.pixelSize = data.pixelSize;
-		cpuTexture.byteSize = data.byteSize;
-    cpuTexture.pixels = std::move(data.pixels);
+    if (!loadImage(fullPath, cpuTexture))
+      return Logger::error("TextureManager", "addTexture", "Failed load: " + fullPath);
 
     TextureGPU gpuTexture;
-    if (!handler.upload(cpuTexture, gpuTexture, true))
+    if (streaming) {
+      // Evicted levels are decoded from the file again instead of keeping a CPU copy of every level, on a load job
+      // when set, so the reload brings its own parser
+      if (!streamer.add(cpuTexture, gpuTexture, [fullPath](TextureCPU& cpu) { Serializer::ImageParser imageParser; return loadImage(imageParser, fullPath, cpu); }))
+        return Logger::error("TextureManager", "addTexture", "Failed to stream: " + name);
+    }
+    else if (!(staging ? handler.upload(cpuTexture, gpuTexture, true, *staging) : handler.upload(cpuTexture, gpuTexture, true)))
       return Logger::error("TextureManager", "addTexture", "Failed upload: " + name);
 
     nameToGPUTextures[name] = std::move(gpuTexture);
     return Logger::debug("TextureManager", "addTexture", "Added texture: " + name + " at: " + path);
   }
 
+  bool TextureManager::addTexture(const std::string& name, TextureCPU& cpu) {
+    if (exists(name)) return true;
+
+    TextureGPU gpuTexture;
+    if (streaming) {
+      if (!streamer.add(cpu, gpuTexture))
+        return Logger::error("TextureManager", "addTexture", "Failed to stream: " + name);
+    }
+    else if (!(staging ? handler.upload(cpu, gpuTexture, true, *staging) : handler.upload(cpu, gpuTexture, true)))
+      return Logger::error("TextureManager", "addTexture", "Failed upload: " + name);
+
+    nameToGPUTextures[name] = std::move(gpuTexture);
+    return Logger::debug("TextureManager", "addTexture", "Added texture: " + name + " from memory");
+  }
+
+  bool TextureManager::addTextures(const std::vector<std::pair<std::string, std::string>>& namesAndPaths) {
+    if (!loadJobs || !loadJobs->isRunning() || streaming || !staging || !staging->isReady()) {
+      for (const std::pair<std::string, std::string>& entry : namesAndPaths)
+        if (!addTexture(entry.first, entry.second)) return false;
+      return true;
+    }
+
+    struct Loaded {
+      TextureCPU cpu;
+      TextureHandler::StagedTexture staged;
+      bool decoded{ false }, isStaged{ false };
+    };
+    std::vector<Loaded> loaded(namesAndPaths.size());
+
+    // Workers decode and copy into the staging ring without touching GL or the texture map
+    loadJobs->parallelFor(static_cast<uint32_t>(namesAndPaths.size()), 1, [&](const uint32_t begin, const uint32_t end) {
+      Serializer::ImageParser imageParser;
+      for (uint32_t i = begin; i < end; ++i) {
+        if (exists(namesAndPaths[i].first)) continue;
+        loaded[i].decoded = loadImage(imageParser, basePath + namesAndPaths[i].second, loaded[i].cpu);
+        loaded[i].isStaged = loaded[i].decoded && TextureHandler::stage(loaded[i].cpu, *staging, loaded[i].staged);
+      }
+    });
+
+    // Every staged allocation is either queued or cancelled, an abandoned one would hold the ring forever
+    bool ok = true;
+    for (size_t i = 0; i < namesAndPaths.size(); ++i) {
+      const std::string& name = namesAndPaths[i].first;
+      Loaded& entry = loaded[i];
+      if (exists(name)) {
+        if (entry.isStaged) staging->cancel(entry.staged.allocation);
+        continue;
+      }
+      if (!entry.decoded) {
+        ok = Logger::error("TextureManager", "addTextures", "Failed load: " + basePath + namesAndPaths[i].second);
+        continue;
+      }
+
+      TextureGPU gpuTexture;
+      const bool uploaded = entry.isStaged
+        ? handler.upload(entry.staged, gpuTexture, true, *staging)
+        : handler.upload(entry.cpu, gpuTexture, true);
+      if (!uploaded) {
+        ok = Logger::error("TextureManager", "addTextures", "Failed upload: " + name);
+        continue;
+      }
+
+      nameToGPUTextures[name] = std::move(gpuTexture);
+      Logger::debug("TextureManager", "addTextures", "Added texture: " + name + " at: " + namesAndPaths[i].second);
+    }
+    return ok;
+  }
+
   bool TextureManager::addTextureCube(const std::string& name, const std::string(&facePaths)[6]) {
     if (exists(name)) return true;
 
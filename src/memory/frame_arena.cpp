@@ -0,0 +1,75 @@
+#include "starlet-graphics/memory/frame_arena.hpp"
+
+#include <algorithm>
+
+namespace Starlet::Graphics {
+	namespace {
+		constexpr size_t BLOCK_ALIGNMENT{ alignof(std::max_align_t) };
+
+		uintptr_t alignUp(const uintptr_t value, const size_t alignment) {
+			return (value + alignment - 1) & ~(alignment - 1);
+		}
+	}
+
+	FrameArena::FrameArena(const size_t initialCapacity, std::pmr::memory_resource* upstreamResource)
+		: upstream(upstreamResource ? upstreamResource : std::pmr::get_default_resource()) {
+		capacity = alignUp(std::max<size_t>(initialCapacity, BLOCK_ALIGNMENT), BLOCK_ALIGNMENT);
+		block = static_cast<std::byte*>(upstream->allocate(capacity, BLOCK_ALIGNMENT));
+	}
+
+	FrameArena::~FrameArena() {
+		releaseOverflow();
+		upstream->deallocate(block, capacity, BLOCK_ALIGNMENT);
+	}
+
+	void FrameArena::reset() {
+		const size_t frameBytes = used + overflowBytes;
+		highWater = std::max(highWater, frameBytes);
+
+		// Grow once with headroom so the frames after an overflow stay inside the block
+		if (overflowCount > 0) {
+			upstream->deallocate(block, capacity, BLOCK_ALIGNMENT);
+			capacity = alignUp(frameBytes + frameBytes / 2, BLOCK_ALIGNMENT);
+			block = static_cast<std::byte*>(upstream->allocate(capacity, BLOCK_ALIGNMENT));
+		}
+
+		releaseOverflow();
+		used = 0;
+	}
+
+	void* FrameArena::do_allocate(const size_t bytes, const size_t alignment) {
+		// Aligned against the address rather than the offset so over-aligned requests still fit in the block
+		const uintptr_t base = reinterpret_cast<uintptr_t>(block);
+		const size_t offset = static_cast<size_t>(alignUp(base + used, alignment) - base);
+		if (offset + bytes <= capacity) {
+			used = offset + bytes;
+			return block + offset;
+		}
+
+		// Header in front of the allocation so reset() can walk and free the chain
+		const size_t headerAlignment = std::max(alignment, alignof(Overflow));
+		const size_t header = alignUp(sizeof(Overflow), headerAlignment);
+		std::byte* raw = static_cast<std::byte*>(upstream->allocate(header + bytes, headerAlignment));
+		Overflow* node = reinterpret_cast<Overflow*>(raw);
+		node->next = overflow;
+		node->bytes = header + bytes;
+		node->alignment = headerAlignment;
+		overflow = node;
+
+		overflowBytes += bytes + alignment;
+		++overflowCount;
+		return raw + header;
+	}
+
+	void FrameArena::do_deallocate(void*, const size_t, const size_t) {}
+
+	void FrameArena::releaseOverflow() {
+		while (overflow) {
+			Overflow* next = overflow->next;
+			upstream->deallocate(overflow, overflow->bytes, overflow->alignment);
+			overflow = next;
+		}
+		overflowBytes = 0;
+		overflowCount = 0;
+	}
+}
@@ -0,0 +1,18 @@
+#include "starlet-graphics/memory/heap_counter.hpp"
+
+#include <atomic>
+
+namespace Starlet::Graphics {
+	namespace {
+		// Constant initialised, so allocations made before main() are counted safely
+		std::atomic<uint64_t> heapAllocations{ 0 };
+	}
+
+	void recordHeapAllocation() {
+		heapAllocations.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	uint64_t getHeapAllocationCount() {
+		return heapAllocations.load(std::memory_order_relaxed);
+	}
+}
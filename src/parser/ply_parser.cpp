@@ -0,0 +1,967 @@
+#include "starlet-graphics/parser/ply_parser.hpp"
+#include "starlet-logger/logger.hpp"
+
+#include "starlet-graphics/resource/mesh_cpu.hpp"
+#include "starlet-graphics/jobs/job_system.hpp"
+#include "starlet-graphics/streaming/mesh_stream_uploader.hpp"
+
+#include "starlet-serializer/parser/mesh_parser.hpp"
+#include "starlet-serializer/data/mesh_data.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <charconv>
+#include <cmath>
+#include <chrono>
+#include <cstring>
+#include <string_view>
+#include <vector>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace Starlet::Graphics {
+	namespace {
+		using Clock = std::chrono::steady_clock;
+
+		constexpr uint32_t BINARY_ROW_GRAIN{ 64 * 1024 };
+
+		// Runs fn over [0, count) as jobs when a scheduler is given, otherwise in one call on this thread
+		template <typename Function>
+		void forRanges(JobSystem* jobs, const uint32_t count, const uint32_t grain, const Function& fn) {
+			if (jobs) jobs->parallelFor(count, grain, fn);
+			else if (count) fn(0u, count);
+		}
+
+		// Read-only view of a whole file, unmapped on destruction
+		class MappedFile {
+		public:
+			~MappedFile() { close(); }
+
+			bool open(const std::string& path) {
+#ifdef _WIN32
+				file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+				if (file == INVALID_HANDLE_VALUE) return false;
+				LARGE_INTEGER fileSize;
+				if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0) return false;
+				mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+				if (!mapping) return false;
+				bytes = static_cast<const char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+				length = static_cast<size_t>(fileSize.QuadPart);
+#else
+				descriptor = ::open(path.c_str(), O_RDONLY);
+				if (descriptor < 0) return false;
+				struct stat info;
+				if (fstat(descriptor, &info) != 0 || info.st_size == 0) return false;
+				void* view = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, descriptor, 0);
+				if (view == MAP_FAILED) return false;
+				madvise(view, static_cast<size_t>(info.st_size), MADV_SEQUENTIAL);
+				bytes = static_cast<const char*>(view);
+				length = static_cast<size_t>(info.st_size);
+#endif
+				return bytes != nullptr;
+			}
+
+			void close() {
+#ifdef _WIN32
+				if (bytes) UnmapViewOfFile(bytes);
+				if (mapping) CloseHandle(mapping);
+				if (file != INVALID_HANDLE_VALUE) CloseHandle(file);
+				mapping = nullptr;
+				file = INVALID_HANDLE_VALUE;
+#else
+				if (bytes) munmap(const_cast<char*>(bytes), length);
+				if (descriptor >= 0) ::close(descriptor);
+				descriptor = -1;
+#endif
+				bytes = nullptr;
+				length = released = 0;
+			}
+
+			// Lets the kernel drop whole pages before upTo, they fault back in from the file if touched again
+			void release(const char* upTo) {
+#ifndef _WIN32
+				static const size_t pageSize = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+				const size_t stop = (static_cast<size_t>(upTo - bytes) / pageSize) * pageSize;
+				if (stop <= released) return;
+				madvise(const_cast<char*>(bytes) + released, stop - released, MADV_DONTNEED);
+				released = stop;
+#else
+				(void)upTo;
+#endif
+			}
+
+			const char* data() const { return bytes; }
+			size_t size() const { return length; }
+
+		private:
+#ifdef _WIN32
+			HANDLE file{ INVALID_HANDLE_VALUE }, mapping{ nullptr };
+#else
+			int descriptor{ -1 };
+#endif
+			const char* bytes{ nullptr };
+			size_t length{ 0 }, released{ 0 };
+		};
+
+		enum class PlyType : uint8_t { Int8, UInt8, Int16, UInt16, Int32, UInt32, Float32, Float64, Invalid };
+
+		// Vertex field a property is written to
+		enum class Slot : uint8_t { PosX, PosY, PosZ, NormX, NormY, NormZ, ColR, ColG, ColB, ColA, TexU, TexV, None };
+
+		struct PlyProperty {
+			PlyType type{ PlyType::Invalid };
+			PlyType countType{ PlyType::Invalid };  // Invalid unless the property is a list
+			Slot slot{ Slot::None };
+			float scale{ 1.0f };
+			bool indices{ false };
+			size_t offset{ 0 };  // Within a binary row of scalars
+		};
+
+		struct PlyElement {
+			std::string name;
+			uint32_t count{ 0 };
+			std::vector<PlyProperty> properties;
+			size_t rowBytes{ 0 };  // Zero when the element has a list
+		};
+
+		struct PlyHeader {
+			bool binary{ false };
+			size_t bodyOffset{ 0 };
+			std::vector<PlyElement> elements;
+			int vertexElement{ -1 }, faceElement{ -1 };
+			bool hasNormals{ false }, hasColours{ false }, hasAlpha{ false }, hasTexCoords{ false };
+		};
+
+		// A slice of an ASCII body starting on a line boundary
+		struct TextChunk {
+			const char* begin{ nullptr };
+			const char* end{ nullptr };
+			uint32_t firstRow{ 0 }, rows{ 0 };
+			bool failed{ false }, polygons{ false };
+		};
+
+		PlyType parseType(const std::string_view name) {
+			if (name == "char" || name == "int8") return PlyType::Int8;
+			if (name == "uchar" || name == "uint8") return PlyType::UInt8;
+			if (name == "short" || name == "int16") return PlyType::Int16;
+			if (name == "ushort" || name == "uint16") return PlyType::UInt16;
+			if (name == "int" || name == "int32") return PlyType::Int32;
+			if (name == "uint" || name == "uint32") return PlyType::UInt32;
+			if (name == "float" || name == "float32") return PlyType::Float32;
+			if (name == "double" || name == "float64") return PlyType::Float64;
+			return PlyType::Invalid;
+		}
+
+		size_t typeSize(const PlyType type) {
+			switch (type) {
+			case PlyType::Int8: case PlyType::UInt8: return 1;
+			case PlyType::Int16: case PlyType::UInt16: return 2;
+			case PlyType::Int32: case PlyType::UInt32: case PlyType::Float32: return 4;
+			case PlyType::Float64: return 8;
+			default: return 0;
+			}
+		}
+
+		bool isFloatType(const PlyType type) { return type == PlyType::Float32 || type == PlyType::Float64; }
+
+		Slot parseSlot(const std::string_view name) {
+			if (name == "x") return Slot::PosX;
+			if (name == "y") return Slot::PosY;
+			if (name == "z") return Slot::PosZ;
+			if (name == "nx") return Slot::NormX;
+			if (name == "ny") return Slot::NormY;
+			if (name == "nz") return Slot::NormZ;
+			if (name == "red") return Slot::ColR;
+			if (name == "green") return Slot::ColG;
+			if (name == "blue") return Slot::ColB;
+			if (name == "alpha") return Slot::ColA;
+			if (name == "u" || name == "s" || name == "texture_u" || name == "texture_s") return Slot::TexU;
+			if (name == "v" || name == "t" || name == "texture_v" || name == "texture_t") return Slot::TexV;
+			return Slot::None;
+		}
+
+		void writeSlot(Math::Vertex& vertex, const Slot slot, const float value) {
+			switch (slot) {
+			case Slot::PosX: vertex.pos.x = value; break;
+			case Slot::PosY: vertex.pos.y = value; break;
+			case Slot::PosZ: vertex.pos.z = value; break;
+			case Slot::NormX: vertex.norm.x = value; break;
+			case Slot::NormY: vertex.norm.y = value; break;
+			case Slot::NormZ: vertex.norm.z = value; break;
+			case Slot::ColR: vertex.col.x = value; break;
+			case Slot::ColG: vertex.col.y = value; break;
+			case Slot::ColB: vertex.col.z = value; break;
+			case Slot::ColA: vertex.col.w = value; break;
+			case Slot::TexU: vertex.texCoord.x = value; break;
+			case Slot::TexV: vertex.texCoord.y = value; break;
+			default: break;
+			}
+		}
+
+		std::vector<std::string_view> splitWords(const std::string_view line) {
+			std::vector<std::string_view> words;
+			size_t position = 0;
+			while (position < line.size()) {
+				const size_t start = line.find_first_not_of(" \t\r", position);
+				if (start == std::string_view::npos) break;
+				const size_t stop = std::min(line.find_first_of(" \t\r", start), line.size());
+				words.push_back(line.substr(start, stop - start));
+				position = stop;
+			}
+			return words;
+		}
+
+		bool parseHeader(const char* data, const size_t size, PlyHeader& header) {
+			const std::string_view text(data, size);
+			size_t position = 0;
+			bool first = true, sawFormat = false;
+
+			while (position < text.size()) {
+				const size_t newline = text.find('\n', position);
+				if (newline == std::string_view::npos) return Logger::error("PlyParser", "parseHeader", "Header has no end_header");
+				const std::vector<std::string_view> words = splitWords(text.substr(position, newline - position));
+				position = newline + 1;
+
+				if (first) {
+					if (words.size() != 1 || words[0] != "ply") return Logger::error("PlyParser", "parseHeader", "Missing ply magic");
+					first = false;
+					continue;
+				}
+				if (words.empty() || words[0] == "comment" || words[0] == "obj_info") continue;
+
+				if (words[0] == "end_header") {
+					header.bodyOffset = position;
+					break;
+				}
+				if (words[0] == "format") {
+					if (words.size() < 2) return Logger::error("PlyParser", "parseHeader", "Malformed format line");
+					if (words[1] == "ascii") header.binary = false;
+					else if (words[1] == "binary_little_endian") header.binary = true;
+					else return Logger::error("PlyParser", "parseHeader", "Unsupported format: " + std::string(words[1]));
+					sawFormat = true;
+				}
+				else if (words[0] == "element") {
+					if (words.size() != 3) return Logger::error("PlyParser", "parseHeader", "Malformed element line");
+					PlyElement element;
+					element.name = std::string(words[1]);
+					if (std::from_chars(words[2].data(), words[2].data() + words[2].size(), element.count).ec != std::errc())
+						return Logger::error("PlyParser", "parseHeader", "Bad element count for " + element.name);
+					header.elements.push_back(std::move(element));
+				}
+				else if (words[0] == "property") {
+					if (header.elements.empty()) return Logger::error("PlyParser", "parseHeader", "Property before any element");
+					PlyProperty property;
+					std::string_view name;
+					if (words.size() == 5 && words[1] == "list") {
+						property.countType = parseType(words[2]);
+						property.type = parseType(words[3]);
+						name = words[4];
+						if (property.countType == PlyType::Invalid || isFloatType(property.countType))
+							return Logger::error("PlyParser", "parseHeader", "Bad list count type for " + std::string(name));
+					}
+					else if (words.size() == 3) {
+						property.type = parseType(words[1]);
+						name = words[2];
+					}
+					else return Logger::error("PlyParser", "parseHeader", "Malformed property line");
+					if (property.type == PlyType::Invalid) return Logger::error("PlyParser", "parseHeader", "Unknown type for " + std::string(name));
+
+					PlyElement& element = header.elements.back();
+					const bool isList = property.countType != PlyType::Invalid;
+					if (element.name == "vertex" && !isList) {
+						property.slot = parseSlot(name);
+						if (property.type == PlyType::UInt8 && property.slot >= Slot::ColR && property.slot <= Slot::ColA) property.scale = 1.0f / 255.0f;
+						if (property.type == PlyType::UInt16 && property.slot >= Slot::ColR && property.slot <= Slot::ColA) property.scale = 1.0f / 65535.0f;
+					}
+					if (element.name == "face" && isList && (name == "vertex_indices" || name == "vertex_index")) {
+						if (isFloatType(property.type)) return Logger::error("PlyParser", "parseHeader", "Face indices must be integers");
+						property.indices = true;
+					}
+					element.properties.push_back(property);
+				}
+				else return Logger::error("PlyParser", "parseHeader", "Unknown header line: " + std::string(words[0]));
+			}
+
+			if (header.bodyOffset == 0) return Logger::error("PlyParser", "parseHeader", "Header has no end_header");
+			if (!sawFormat) return Logger::error("PlyParser", "parseHeader", "Header has no format");
+
+			bool slots[static_cast<size_t>(Slot::None)]{};
+			for (size_t index = 0; index < header.elements.size(); ++index) {
+				PlyElement& element = header.elements[index];
+				size_t offset = 0;
+				bool fixed = true, hasIndices = false;
+				for (PlyProperty& property : element.properties) {
+					if (property.countType != PlyType::Invalid) fixed = false;
+					property.offset = offset;
+					offset += typeSize(property.type);
+					if (property.slot != Slot::None) slots[static_cast<size_t>(property.slot)] = true;
+					if (property.indices) hasIndices = true;
+				}
+				element.rowBytes = fixed ? offset : 0;
+
+				if (element.name == "vertex") {
+					if (!fixed) return Logger::error("PlyParser", "parseHeader", "Vertex element has a list property");
+					header.vertexElement = static_cast<int>(index);
+				}
+				else if (element.name == "face") {
+					if (!hasIndices) return Logger::error("PlyParser", "parseHeader", "Face element has no vertex_indices");
+					header.faceElement = static_cast<int>(index);
+				}
+			}
+			if (header.vertexElement < 0 || header.faceElement < 0)
+				return Logger::error("PlyParser", "parseHeader", "File needs a vertex and a face element");
+			if (!slots[static_cast<size_t>(Slot::PosX)] || !slots[static_cast<size_t>(Slot::PosY)] || !slots[static_cast<size_t>(Slot::PosZ)])
+				return Logger::error("PlyParser", "parseHeader", "Vertex element has no x, y, z");
+
+			header.hasNormals = slots[static_cast<size_t>(Slot::NormX)] && slots[static_cast<size_t>(Slot::NormY)] && slots[static_cast<size_t>(Slot::NormZ)];
+			header.hasColours = slots[static_cast<size_t>(Slot::ColR)] && slots[static_cast<size_t>(Slot::ColG)] && slots[static_cast<size_t>(Slot::ColB)];
+			header.hasAlpha = slots[static_cast<size_t>(Slot::ColA)];
+			header.hasTexCoords = slots[static_cast<size_t>(Slot::TexU)] && slots[static_cast<size_t>(Slot::TexV)];
+			return true;
+		}
+
+		/* ASCII */
+
+		const char* skipSpaces(const char* p, const char* end) {
+			while (p < end && (*p == ' ' || *p == '\t' || *p == '\r')) ++p;
+			return p;
+		}
+
+		// Hand-rolled since indices are the bulk of a face line and never carry a fraction or exponent
+		bool parseInteger(const char*& p, const char* end, int64_t& out) {
+			p = skipSpaces(p, end);
+			bool negative = false;
+			if (p < end && (*p == '-' || *p == '+')) negative = *p++ == '-';
+
+			const char* start = p;
+			int64_t value = 0;
+			while (p < end && static_cast<unsigned char>(*p - '0') < 10) value = value * 10 + (*p++ - '0');
+			if (p == start) return false;
+
+			out = negative ? -value : value;
+			return true;
+		}
+
+		bool parseReal(const char*& p, const char* end, float& out) {
+			p = skipSpaces(p, end);
+			if (p < end && *p == '+') ++p;
+			const std::from_chars_result result = std::from_chars(p, end, out);
+			if (result.ec != std::errc()) return false;
+			p = result.ptr;
+			return true;
+		}
+
+		bool parseValue(const char*& p, const char* end, const PlyType type, float& out) {
+			if (isFloatType(type)) return parseReal(p, end, out);
+			int64_t value;
+			if (!parseInteger(p, end, value)) return false;
+			out = static_cast<float>(value);
+			return true;
+		}
+
+		bool skipWord(const char*& p, const char* end) {
+			p = skipSpaces(p, end);
+			const char* start = p;
+			while (p < end && *p != ' ' && *p != '\t' && *p != '\r') ++p;
+			return p != start;
+		}
+
+		bool parseVertexLine(const char* p, const char* end, const PlyElement& element, Math::Vertex& vertex) {
+			for (const PlyProperty& property : element.properties) {
+				float value;
+				if (!parseValue(p, end, property.type, value)) return false;
+				writeSlot(vertex, property.slot, value * property.scale);
+			}
+			return true;
+		}
+
+		// Reads the polygon's corners into corners, returns false on malformed lines or out of range indices
+		bool parseFaceLine(const char* p, const char* end, const PlyElement& element, const uint32_t vertexCount, std::vector<unsigned int>& corners) {
+			corners.clear();
+			for (const PlyProperty& property : element.properties) {
+				if (property.countType == PlyType::Invalid) {
+					if (!skipWord(p, end)) return false;
+					continue;
+				}
+
+				int64_t count;
+				if (!parseInteger(p, end, count) || count < 0) return false;
+				for (int64_t corner = 0; corner < count; ++corner) {
+					int64_t index;
+					if (property.indices) {
+						if (!parseInteger(p, end, index) || index < 0 || index >= vertexCount) return false;
+						corners.push_back(static_cast<unsigned int>(index));
+					}
+					else if (!skipWord(p, end)) return false;
+				}
+			}
+			return true;
+		}
+
+		// Triangle faces go straight into their slot, anything else marks the chunk for the sequential fan pass
+		bool parseTriangleLine(const char* p, const char* end, const PlyElement& element, const uint32_t vertexCount, unsigned int* out, bool& polygon) {
+			for (const PlyProperty& property : element.properties) {
+				if (property.countType == PlyType::Invalid) {
+					if (!skipWord(p, end)) return false;
+					continue;
+				}
+
+				int64_t count;
+				if (!parseInteger(p, end, count)) return false;
+				if (property.indices && count != 3) {
+					polygon = true;
+					return true;
+				}
+				for (int64_t corner = 0; corner < count; ++corner) {
+					int64_t index;
+					if (!parseInteger(p, end, index)) return false;
+					if (!property.indices) continue;
+					if (index < 0 || index >= vertexCount) return false;
+					out[corner] = static_cast<unsigned int>(index);
+				}
+			}
+			return true;
+		}
+
+		const char* lineEnd(const char* p, const char* end) {
+			const char* newline = static_cast<const char*>(std::memchr(p, '\n', end - p));
+			return newline ? newline : end;
+		}
+
+		// Steps p over blank lines to the next row and returns where that row ends, end when none is left
+		const char* rowEnd(const char*& p, const char* end) {
+			for (;;) {
+				const char* stop = lineEnd(p, end);
+				if (stop == end || skipSpaces(p, stop) != stop) return stop;
+				p = stop + 1;
+			}
+		}
+
+		// Rows are the lines with anything but whitespace on them
+		uint32_t countRows(const char* p, const char* end) {
+			uint32_t rows = 0;
+			while (p < end) {
+				const char* stop = lineEnd(p, end);
+				if (skipSpaces(p, stop) != stop) ++rows;
+				p = stop + 1;
+			}
+			return rows;
+		}
+
+		// Fan-triangulates every face in order, used when a file has any non-triangle face
+		bool parseTextFaces(const char* p, const char* end, const PlyElement& element, const uint32_t vertexCount, std::vector<unsigned int>& indices) {
+			indices.clear();
+			indices.reserve(static_cast<size_t>(element.count) * 3);
+			std::vector<unsigned int> corners;
+			for (uint32_t face = 0; face < element.count; ++face) {
+				if (p >= end) return false;
+				const char* stop = rowEnd(p, end);
+				if (!parseFaceLine(p, stop, element, vertexCount, corners) || corners.size() < 3) return false;
+				for (size_t corner = 1; corner + 1 < corners.size(); ++corner) {
+					indices.push_back(corners[0]);
+					indices.push_back(corners[corner]);
+					indices.push_back(corners[corner + 1]);
+				}
+				p = stop + 1;
+			}
+			return true;
+		}
+
+		bool parseText(const char* body, const char* end, const PlyHeader& header, const size_t chunkBytes, MeshCPU& mesh, JobSystem* jobs, uint32_t& chunkCount) {
+			// Cut on the first newline after each multiple of chunkBytes so every chunk starts a line
+			std::vector<TextChunk> chunks;
+			for (const char* p = body; p < end;) {
+				const char* stop = (static_cast<size_t>(end - p) > chunkBytes) ? lineEnd(p + chunkBytes, end) : end;
+				if (stop < end) ++stop;
+				chunks.push_back({ p, stop });
+				p = stop;
+			}
+			chunkCount = static_cast<uint32_t>(chunks.size());
+
+			forRanges(jobs, chunkCount, 1, [&chunks](const uint32_t begin, const uint32_t stop) {
+				for (uint32_t index = begin; index < stop; ++index) chunks[index].rows = countRows(chunks[index].begin, chunks[index].end);
+			});
+
+			uint32_t totalRows = 0;
+			for (TextChunk& chunk : chunks) {
+				chunk.firstRow = totalRows;
+				totalRows += chunk.rows;
+			}
+
+			// Each element covers a fixed range of rows, rows past the last element are ignored
+			uint32_t vertexBegin = 0, faceBegin = 0, elementRow = 0;
+			for (size_t index = 0; index < header.elements.size(); ++index) {
+				if (static_cast<int>(index) == header.vertexElement) vertexBegin = elementRow;
+				if (static_cast<int>(index) == header.faceElement) faceBegin = elementRow;
+				elementRow += header.elements[index].count;
+			}
+			if (totalRows < elementRow) return Logger::error("PlyParser", "parseText", "Body has fewer rows than the header declares");
+
+			const PlyElement& vertexElement = header.elements[header.vertexElement];
+			const PlyElement& faceElement = header.elements[header.faceElement];
+			const uint32_t vertexEnd = vertexBegin + vertexElement.count, faceEnd = faceBegin + faceElement.count;
+			const uint32_t vertexCount = vertexElement.count;
+
+			forRanges(jobs, chunkCount, 1, [&](const uint32_t begin, const uint32_t stop) {
+				for (uint32_t index = begin; index < stop; ++index) {
+					TextChunk& chunk = chunks[index];
+					const char* p = chunk.begin;
+					for (uint32_t row = chunk.firstRow; row < chunk.firstRow + chunk.rows && !chunk.failed; ++row) {
+						const char* next = rowEnd(p, chunk.end);
+						if (row >= vertexBegin && row < vertexEnd)
+							chunk.failed = !parseVertexLine(p, next, vertexElement, mesh.vertices[row - vertexBegin]);
+						else if (row >= faceBegin && row < faceEnd && !chunk.polygons)
+							chunk.failed = !parseTriangleLine(p, next, faceElement, vertexCount, &mesh.indices[static_cast<size_t>(row - faceBegin) * 3], chunk.polygons);
+						p = next + 1;
+					}
+				}
+			});
+
+			bool polygons = false;
+			for (const TextChunk& chunk : chunks) {
+				if (chunk.failed) return Logger::error("PlyParser", "parseText", "Malformed row or index out of range near row " + std::to_string(chunk.firstRow));
+				polygons = polygons || chunk.polygons;
+			}
+			if (!polygons) return true;
+
+			// Walk to the first face line from the chunk that holds it and fan every face on this thread
+			for (const TextChunk& chunk : chunks) {
+				if (faceBegin < chunk.firstRow || faceBegin >= chunk.firstRow + chunk.rows) continue;
+				const char* p = chunk.begin;
+				for (uint32_t row = chunk.firstRow; row < faceBegin; ++row) p = rowEnd(p, end) + 1;
+				if (!parseTextFaces(p, end, faceElement, vertexCount, mesh.indices))
+					return Logger::error("PlyParser", "parseText", "Malformed face or index out of range");
+				return true;
+			}
+			return Logger::error("PlyParser", "parseText", "Could not locate the face rows");
+		}
+
+		/* Binary little-endian */
+
+		template <typename T>
+		T load(const char* p) {
+			T value;
+			std::memcpy(&value, p, sizeof(T));
+			return value;
+		}
+
+		double readScalar(const char* p, const PlyType type) {
+			switch (type) {
+			case PlyType::Int8: return load<int8_t>(p);
+			case PlyType::UInt8: return load<uint8_t>(p);
+			case PlyType::Int16: return load<int16_t>(p);
+			case PlyType::UInt16: return load<uint16_t>(p);
+			case PlyType::Int32: return load<int32_t>(p);
+			case PlyType::UInt32: return load<uint32_t>(p);
+			case PlyType::Float32: return load<float>(p);
+			case PlyType::Float64: return load<double>(p);
+			default: return 0.0;
+			}
+		}
+
+		int64_t readInteger(const char* p, const PlyType type) {
+			switch (type) {
+			case PlyType::Int8: return load<int8_t>(p);
+			case PlyType::UInt8: return load<uint8_t>(p);
+			case PlyType::Int16: return load<int16_t>(p);
+			case PlyType::UInt16: return load<uint16_t>(p);
+			case PlyType::Int32: return load<int32_t>(p);
+			case PlyType::UInt32: return load<uint32_t>(p);
+			default: return -1;
+			}
+		}
+
+		// Byte size of the row at p, zero if it runs past end
+		size_t binaryRowSize(const char* p, const char* end, const PlyElement& element) {
+			if (element.rowBytes) return static_cast<size_t>(end - p) >= element.rowBytes ? element.rowBytes : 0;
+
+			size_t size = 0;
+			for (const PlyProperty& property : element.properties) {
+				if (property.countType == PlyType::Invalid) {
+					size += typeSize(property.type);
+					continue;
+				}
+				const size_t countSize = typeSize(property.countType);
+				if (static_cast<size_t>(end - p) < size + countSize) return 0;
+				const int64_t count = readInteger(p + size, property.countType);
+				if (count < 0) return 0;
+				size += countSize + static_cast<size_t>(count) * typeSize(property.type);
+			}
+			return static_cast<size_t>(end - p) >= size ? size : 0;
+		}
+
+		// Sequential walk used for faces that are not all triangles, fans polygons and returns the end of the element
+		const char* parseBinaryFaces(const char* p, const char* end, const PlyElement& element, const uint32_t vertexCount, std::vector<unsigned int>& indices) {
+			indices.clear();
+			indices.reserve(static_cast<size_t>(element.count) * 3);
+			std::vector<unsigned int> corners;
+			for (uint32_t face = 0; face < element.count; ++face) {
+				corners.clear();
+				for (const PlyProperty& property : element.properties) {
+					if (property.countType == PlyType::Invalid) {
+						if (static_cast<size_t>(end - p) < typeSize(property.type)) return nullptr;
+						p += typeSize(property.type);
+						continue;
+					}
+					if (static_cast<size_t>(end - p) < typeSize(property.countType)) return nullptr;
+					const int64_t count = readInteger(p, property.countType);
+					p += typeSize(property.countType);
+					const size_t valueSize = typeSize(property.type);
+					if (count < 0 || static_cast<size_t>(end - p) < static_cast<size_t>(count) * valueSize) return nullptr;
+					for (int64_t corner = 0; corner < count && property.indices; ++corner) {
+						const int64_t index = readInteger(p + corner * valueSize, property.type);
+						if (index < 0 || index >= vertexCount) return nullptr;
+						corners.push_back(static_cast<unsigned int>(index));
+					}
+					p += static_cast<size_t>(count) * valueSize;
+				}
+				if (corners.size() < 3) return nullptr;
+				for (size_t corner = 1; corner + 1 < corners.size(); ++corner) {
+					indices.push_back(corners[0]);
+					indices.push_back(corners[corner]);
+					indices.push_back(corners[corner + 1]);
+				}
+			}
+			return p;
+		}
+
+		// Faces whose only property is the index list and whose first row is a triangle are tried as fixed-size rows
+		bool tryParseBinaryTriangles(const char* p, const char* end, const PlyElement& element, const uint32_t vertexCount, MeshCPU& mesh, JobSystem* jobs) {
+			if (element.properties.size() != 1 || element.count == 0) return false;
+			const PlyProperty& property = element.properties[0];
+			const size_t countSize = typeSize(property.countType), valueSize = typeSize(property.type);
+			const size_t rowBytes = countSize + 3 * valueSize;
+			if (static_cast<size_t>(end - p) / rowBytes < element.count) return false;
+
+			std::atomic<bool> fixed{ true };
+			forRanges(jobs, element.count, BINARY_ROW_GRAIN, [&](const uint32_t begin, const uint32_t stop) {
+				for (uint32_t face = begin; face < stop; ++face) {
+					const char* row = p + static_cast<size_t>(face) * rowBytes;
+					if (readInteger(row, property.countType) != 3) {
+						fixed.store(false, std::memory_order_relaxed);
+						return;
+					}
+					for (uint32_t corner = 0; corner < 3; ++corner) {
+						const int64_t index = readInteger(row + countSize + corner * valueSize, property.type);
+						if (index < 0 || index >= vertexCount) {
+							fixed.store(false, std::memory_order_relaxed);
+							return;
+						}
+						mesh.indices[static_cast<size_t>(face) * 3 + corner] = static_cast<unsigned int>(index);
+					}
+				}
+			});
+			return fixed.load();
+		}
+
+		bool parseBinary(const char* p, const char* end, const PlyHeader& header, MeshCPU& mesh, JobSystem* jobs) {
+			if constexpr (std::endian::native != std::endian::little)
+				return Logger::error("PlyParser", "parseBinary", "Binary PLY needs a little-endian host");
+
+			for (size_t index = 0; index < header.elements.size(); ++index) {
+				const PlyElement& element = header.elements[index];
+				const uint32_t vertexCount = header.elements[header.vertexElement].count;
+
+				if (static_cast<int>(index) == header.vertexElement) {
+					if (static_cast<size_t>(end - p) / element.rowBytes < element.count)
+						return Logger::error("PlyParser", "parseBinary", "Vertex rows run past the end of the file");
+					forRanges(jobs, element.count, BINARY_ROW_GRAIN, [&](const uint32_t begin, const uint32_t stop) {
+						for (uint32_t vertex = begin; vertex < stop; ++vertex) {
+							const char* row = p + static_cast<size_t>(vertex) * element.rowBytes;
+							for (const PlyProperty& property : element.properties)
+								writeSlot(mesh.vertices[vertex], property.slot, static_cast<float>(readScalar(row + property.offset, property.type)) * property.scale);
+						}
+					});
+					p += static_cast<size_t>(element.count) * element.rowBytes;
+				}
+				else if (static_cast<int>(index) == header.faceElement) {
+					if (tryParseBinaryTriangles(p, end, element, vertexCount, mesh, jobs)) {
+						p += static_cast<size_t>(element.count) * (typeSize(element.properties[0].countType) + 3 * typeSize(element.properties[0].type));
+						continue;
+					}
+					p = parseBinaryFaces(p, end, element, vertexCount, mesh.indices);
+					if (!p) return Logger::error("PlyParser", "parseBinary", "Malformed face or index out of range");
+				}
+				else {
+					for (uint32_t row = 0; row < element.count; ++row) {
+						const size_t size = binaryRowSize(p, end, element);
+						if (size == 0) return Logger::error("PlyParser", "parseBinary", "Element " + element.name + " runs past the end of the file");
+						p += size;
+					}
+				}
+			}
+			return true;
+		}
+
+		/* Streaming */
+
+		struct StreamBounds {
+			Math::Vec3<float> min, max;
+			float radiusSq{ 0.0f };
+			bool any{ false };
+
+			void add(const Math::Vertex* vertices, const uint32_t count) {
+				for (uint32_t i = 0; i < count; ++i) {
+					const Math::Vec3<float>& pos = vertices[i].pos;
+					if (!any) {
+						min = max = pos;
+						any = true;
+					}
+					min = { std::min(min.x, pos.x), std::min(min.y, pos.y), std::min(min.z, pos.z) };
+					max = { std::max(max.x, pos.x), std::max(max.y, pos.y), std::max(max.z, pos.z) };
+					radiusSq = std::max(radiusSq, pos.dot(pos));
+				}
+			}
+		};
+
+		// Row readers for one element that advance p, text rows end at a newline and binary rows at their size
+		bool streamVertexRows(const char*& p, const char* end, const bool binary, const PlyElement& element, Math::Vertex* out, const uint32_t count) {
+			if (binary) {
+				if (static_cast<size_t>(end - p) / element.rowBytes < count) return false;
+				for (uint32_t row = 0; row < count; ++row, p += element.rowBytes)
+					for (const PlyProperty& property : element.properties)
+						writeSlot(out[row], property.slot, static_cast<float>(readScalar(p + property.offset, property.type)) * property.scale);
+				return true;
+			}
+			for (uint32_t row = 0; row < count; ++row) {
+				if (p >= end) return false;
+				const char* stop = rowEnd(p, end);
+				if (!parseVertexLine(p, stop, element, out[row])) return false;
+				p = stop + 1;
+			}
+			return true;
+		}
+
+		bool streamFaceRows(const char*& p, const char* end, const bool binary, const PlyElement& element, const uint32_t vertexCount, unsigned int* out, const uint32_t count) {
+			for (uint32_t row = 0; row < count; ++row) {
+				if (p >= end) return false;
+				if (!binary) {
+					const char* stop = rowEnd(p, end);
+					bool polygon = false;
+					if (!parseTriangleLine(p, stop, element, vertexCount, out + static_cast<size_t>(row) * 3, polygon) || polygon) return false;
+					p = stop + 1;
+					continue;
+				}
+
+				for (const PlyProperty& property : element.properties) {
+					if (property.countType == PlyType::Invalid) {
+						if (static_cast<size_t>(end - p) < typeSize(property.type)) return false;
+						p += typeSize(property.type);
+						continue;
+					}
+					const size_t countSize = typeSize(property.countType), valueSize = typeSize(property.type);
+					if (static_cast<size_t>(end - p) < countSize) return false;
+					const int64_t corners = readInteger(p, property.countType);
+					p += countSize;
+					if (corners < 0 || static_cast<size_t>(end - p) < static_cast<size_t>(corners) * valueSize) return false;
+					if (property.indices) {
+						if (corners != 3) return false;
+						for (uint32_t corner = 0; corner < 3; ++corner) {
+							const int64_t index = readInteger(p + corner * valueSize, property.type);
+							if (index < 0 || index >= vertexCount) return false;
+							out[static_cast<size_t>(row) * 3 + corner] = static_cast<unsigned int>(index);
+						}
+					}
+					p += static_cast<size_t>(corners) * valueSize;
+				}
+			}
+			return true;
+		}
+
+		bool skipRows(const char*& p, const char* end, const bool binary, const PlyElement& element) {
+			for (uint32_t row = 0; row < element.count; ++row) {
+				if (p >= end) return false;
+				if (!binary) {
+					p = rowEnd(p, end) + 1;
+					continue;
+				}
+				const size_t size = binaryRowSize(p, end, element);
+				if (size == 0) return false;
+				p += size;
+			}
+			return true;
+		}
+	}
+
+	bool PlyParser::parse(const std::string& path, MeshCPU& mesh, JobSystem* jobs) {
+		const Clock::time_point start = Clock::now();
+		lastStats = {};
+
+		MappedFile file;
+		if (!file.open(path)) return Logger::error("PlyParser", "parse", "Could not map file: " + path);
+
+		PlyHeader header;
+		if (!parseHeader(file.data(), file.size(), header)) return Logger::error("PlyParser", "parse", "Could not read header of " + path);
+
+		const uint32_t vertexCount = header.elements[header.vertexElement].count;
+		const uint32_t faceCount = header.elements[header.faceElement].count;
+
+		// Sized up front so every job writes its own rows in place, alpha defaults to opaque when colours lack it
+		Math::Vertex blank{};
+		if (header.hasColours && !header.hasAlpha) blank.col.w = 1.0f;
+		mesh.vertices.assign(vertexCount, blank);
+		mesh.indices.assign(static_cast<size_t>(faceCount) * 3, 0u);
+
+		const char* body = file.data() + header.bodyOffset;
+		const char* end = file.data() + file.size();
+		uint32_t chunks = 1;
+		if (!(header.binary ? parseBinary(body, end, header, mesh, jobs) : parseText(body, end, header, chunkBytes, mesh, jobs, chunks))) {
+			mesh.vertices.clear();
+			mesh.indices.clear();
+			return Logger::error("PlyParser", "parse", "Could not parse body of " + path);
+		}
+
+		mesh.numVertices = vertexCount;
+		mesh.numIndices = static_cast<unsigned int>(mesh.indices.size());
+		mesh.numTriangles = mesh.numIndices / 3;
+		mesh.hasNormals = header.hasNormals;
+		mesh.hasColours = header.hasColours;
+		mesh.hasTexCoords = header.hasTexCoords;
+
+		mesh.minY = mesh.maxY = mesh.vertices.empty() ? 0.0f : mesh.vertices[0].pos.y;
+		for (const Math::Vertex& vertex : mesh.vertices) {
+			mesh.minY = std::min(mesh.minY, vertex.pos.y);
+			mesh.maxY = std::max(mesh.maxY, vertex.pos.y);
+		}
+
+		lastStats.bytes = file.size();
+		lastStats.vertices = vertexCount;
+		lastStats.faces = faceCount;
+		lastStats.chunks = header.binary ? 1 : chunks;
+		lastStats.binary = header.binary;
+		lastStats.milliseconds = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+		return true;
+	}
+
+	bool PlyParser::stream(const std::string& path, MeshStreamSink& sink, MeshCPU& mesh) {
+		const Clock::time_point start = Clock::now();
+		lastStats = {};
+
+		MappedFile file;
+		if (!file.open(path)) return Logger::error("PlyParser", "stream", "Could not map file: " + path);
+
+		PlyHeader header;
+		if (!parseHeader(file.data(), file.size(), header)) return Logger::error("PlyParser", "stream", "Could not read header of " + path);
+		if (header.binary && std::endian::native != std::endian::little)
+			return Logger::error("PlyParser", "stream", "Binary PLY needs a little-endian host");
+
+		const uint32_t vertexCount = header.elements[header.vertexElement].count;
+		const uint32_t faceCount = header.elements[header.faceElement].count;
+
+		mesh.vertices.clear();
+		mesh.indices.clear();
+		mesh.lods.clear();
+		mesh.numVertices = vertexCount;
+		mesh.numIndices = faceCount * 3;
+		mesh.numTriangles = faceCount;
+		mesh.hasNormals = header.hasNormals;
+		mesh.hasColours = header.hasColours;
+		mesh.hasTexCoords = header.hasTexCoords;
+		if (!sink.begin(mesh)) return Logger::error("PlyParser", "stream", "Sink rejected " + path);
+
+		const size_t chunk = sink.getChunkBytes();
+		const uint32_t vertexRows = static_cast<uint32_t>(std::max<size_t>(1, chunk / sizeof(Math::Vertex)));
+		const uint32_t faceRows = static_cast<uint32_t>(std::max<size_t>(1, chunk / (3 * sizeof(unsigned int))));
+
+		Math::Vertex blank{};
+		if (header.hasColours && !header.hasAlpha) blank.col.w = 1.0f;
+
+		const char* p = file.data() + header.bodyOffset;
+		const char* end = file.data() + file.size();
+		StreamBounds bounds;
+		uint32_t chunks = 0;
+		bool ok = true;
+
+		for (size_t index = 0; index < header.elements.size() && ok; ++index) {
+			const PlyElement& element = header.elements[index];
+			if (static_cast<int>(index) == header.vertexElement) {
+				for (uint32_t first = 0; first < element.count && ok; first += vertexRows) {
+					const uint32_t count = std::min(vertexRows, element.count - first);
+					Math::Vertex* rows = sink.mapVertices(count);
+					std::fill(rows, rows + count, blank);
+					ok = streamVertexRows(p, end, header.binary, element, rows, count);
+					if (!ok) {
+						Logger::error("PlyParser", "stream", "Malformed vertex row near " + std::to_string(first));
+						break;
+					}
+					bounds.add(rows, count);
+					ok = sink.commitVertices(first, count);
+					file.release(p);
+					++chunks;
+				}
+			}
+			else if (static_cast<int>(index) == header.faceElement) {
+				for (uint32_t first = 0; first < element.count && ok; first += faceRows) {
+					const uint32_t count = std::min(faceRows, element.count - first);
+					unsigned int* rows = sink.mapIndices(count * 3);
+					ok = streamFaceRows(p, end, header.binary, element, vertexCount, rows, count);
+					if (!ok) {
+						Logger::error("PlyParser", "stream", "Non-triangle face, malformed row or index out of range near face " + std::to_string(first));
+						break;
+					}
+					ok = sink.commitIndices(static_cast<uint64_t>(first) * 3, count * 3);
+					file.release(p);
+					++chunks;
+				}
+			}
+			else if (!skipRows(p, end, header.binary, element)) {
+				ok = Logger::error("PlyParser", "stream", "Element " + element.name + " runs past the end of the file");
+			}
+		}
+
+		if (!ok) {
+			sink.abort();
+			return Logger::error("PlyParser", "stream", "Could not stream body of " + path);
+		}
+		if (!sink.finish()) return Logger::error("PlyParser", "stream", "Sink failed to finish " + path);
+
+		mesh.boundsMin = bounds.min;
+		mesh.boundsMax = bounds.max;
+		mesh.boundingRadius = std::sqrt(bounds.radiusSq);
+		mesh.hasBounds = bounds.any;
+		mesh.minY = bounds.min.y;
+		mesh.maxY = bounds.max.y;
+
+		lastStats.bytes = file.size();
+		lastStats.vertices = vertexCount;
+		lastStats.faces = faceCount;
+		lastStats.chunks = chunks;
+		lastStats.binary = header.binary;
+		lastStats.milliseconds = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+		return true;
+	}
+
+	PlyBenchResult PlyParser::benchmark(const std::string& path, const uint32_t iterations, JobSystem* jobs) {
+		PlyBenchResult result;
+		Serializer::MeshParser serializer;
+
+		for (uint32_t iteration = 0; iteration < iterations; ++iteration) {
+			MeshCPU mesh;
+			if (!parse(path, mesh, jobs)) return result;
+			result.bytes = lastStats.bytes;
+			result.fastMs = iteration == 0 ? lastStats.milliseconds : std::min(result.fastMs, lastStats.milliseconds);
+
+			Serializer::MeshData data;
+			const Clock::time_point start = Clock::now();
+			if (!serializer.parse(path, data)) return result;
+			const double serializerMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+			result.serializerMs = iteration == 0 ? serializerMs : std::min(result.serializerMs, serializerMs);
+			result.iterations = iteration + 1;
+		}
+
+		const double megabytes = result.bytes / (1024.0 * 1024.0);
+		if (result.fastMs > 0.0) result.fastMBps = megabytes / (result.fastMs / 1000.0);
+		if (result.serializerMs > 0.0) result.serializerMBps = megabytes / (result.serializerMs / 1000.0);
+		return result;
+	}
+}
@@ -0,0 +1,421 @@
+#include "starlet-graphics/picking/mesh_bvh.hpp"
+#include "starlet-logger/logger.hpp"
+
+#include "starlet-graphics/resource/mesh_cpu.hpp"
+#include "starlet-graphics/jobs/job_system.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <limits>
+#include <random>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define STARLET_BVH_SSE 1
+#include <xmmintrin.h>
+#endif
+
+namespace Starlet::Graphics {
+	namespace {
+		using Clock = std::chrono::steady_clock;
+
+		constexpr uint32_t MAX_DEPTH{ 60 };        // Traversal keeps one stack entry per level
+		constexpr uint32_t MAX_BINS{ 64 };
+		constexpr uint32_t FORCED_LEAF_LIMIT{ 16 }; // Above this a split is taken even when SAH prefers a leaf
+		constexpr float TRAVERSAL_COST{ 1.0f };   // Relative to one triangle test
+
+		template <typename Function>
+		void forRanges(JobSystem* jobs, const uint32_t count, const uint32_t grain, const Function& fn) {
+			if (jobs) jobs->parallelFor(count, grain, fn);
+			else if (count) fn(0u, count);
+		}
+
+		struct Bounds {
+			float min[3]{ std::numeric_limits<float>::max(), std::numeric_limits<float>::max(), std::numeric_limits<float>::max() };
+			float max[3]{ -std::numeric_limits<float>::max(), -std::numeric_limits<float>::max(), -std::numeric_limits<float>::max() };
+
+			void grow(const float* point) {
+				for (int axis = 0; axis < 3; ++axis) {
+					min[axis] = std::min(min[axis], point[axis]);
+					max[axis] = std::max(max[axis], point[axis]);
+				}
+			}
+			void grow(const Bounds& other) {
+				for (int axis = 0; axis < 3; ++axis) {
+					min[axis] = std::min(min[axis], other.min[axis]);
+					max[axis] = std::max(max[axis], other.max[axis]);
+				}
+			}
+			float area() const {
+				const float x = max[0] - min[0], y = max[1] - min[1], z = max[2] - min[2];
+				return (x < 0.0f) ? 0.0f : 2.0f * (x * y + y * z + z * x);
+			}
+		};
+
+		struct Primitive {
+			Bounds bounds;
+			float centroid[3];
+		};
+
+		struct Subtree {
+			uint32_t node, first, count, depth;
+		};
+
+		struct Builder {
+			const BvhSettings& settings;
+			const std::vector<Primitive>& primitives;
+			std::vector<uint32_t>& order;
+
+			void makeLeaf(BvhNode& node, const uint32_t first, const uint32_t count) const {
+				node.first = first;
+				node.count = count;
+			}
+
+			// Fills nodes[index] for order[first, first + count) and appends its children. With deferred set, ranges at or
+			// below the parallel threshold are left as leaves and recorded to be built as separate jobs.
+			void build(std::vector<BvhNode>& nodes, const uint32_t index, const uint32_t first, const uint32_t count, const uint32_t depth, std::vector<Subtree>* deferred) const {
+				Bounds bounds, centroids;
+				for (uint32_t i = first; i < first + count; ++i) {
+					const Primitive& primitive = primitives[order[i]];
+					bounds.grow(primitive.bounds);
+					centroids.grow(primitive.centroid);
+				}
+				std::copy(bounds.min, bounds.min + 3, nodes[index].min);
+				std::copy(bounds.max, bounds.max + 3, nodes[index].max);
+
+				if (count <= settings.maxLeafTriangles || depth >= MAX_DEPTH) return makeLeaf(nodes[index], first, count);
+				if (deferred && count <= settings.parallelThreshold) {
+					makeLeaf(nodes[index], first, count);
+					deferred->push_back({ index, first, count, depth });
+					return;
+				}
+
+				int axis = 0;
+				float extent[3];
+				for (int a = 0; a < 3; ++a) extent[a] = centroids.max[a] - centroids.min[a];
+				if (extent[1] > extent[axis]) axis = 1;
+				if (extent[2] > extent[axis]) axis = 2;
+				if (extent[axis] <= 0.0f) return makeLeaf(nodes[index], first, count);
+
+				// Bin centroids along the widest axis and sweep both ways for the cheapest boundary
+				const uint32_t binCount = std::clamp<uint32_t>(settings.bins, 2, MAX_BINS);
+				const float scale = binCount / extent[axis];
+				const float origin = centroids.min[axis];
+				const auto binOf = [&](const uint32_t primitive) {
+					return std::min(binCount - 1, static_cast<uint32_t>((primitives[primitive].centroid[axis] - origin) * scale));
+				};
+
+				Bounds binBounds[MAX_BINS];
+				uint32_t binCounts[MAX_BINS]{};
+				for (uint32_t i = first; i < first + count; ++i) {
+					const uint32_t bin = binOf(order[i]);
+					binBounds[bin].grow(primitives[order[i]].bounds);
+					++binCounts[bin];
+				}
+
+				float rightCost[MAX_BINS]{};
+				Bounds right;
+				uint32_t rightCount = 0;
+				for (uint32_t bin = binCount - 1; bin > 0; --bin) {
+					right.grow(binBounds[bin]);
+					rightCount += binCounts[bin];
+					rightCost[bin - 1] = rightCount * right.area();
+				}
+
+				float bestCost = std::numeric_limits<float>::max();
+				uint32_t bestSplit = 0;
+				Bounds left;
+				uint32_t leftCount = 0;
+				for (uint32_t split = 0; split + 1 < binCount; ++split) {
+					left.grow(binBounds[split]);
+					leftCount += binCounts[split];
+					const float cost = leftCount * left.area() + rightCost[split];
+					if (leftCount > 0 && leftCount < count && cost < bestCost) {
+						bestCost = cost;
+						bestSplit = split;
+					}
+				}
+
+				const float parentArea = bounds.area();
+				const float leafCost = count * parentArea;
+				const float splitCost = TRAVERSAL_COST * parentArea + bestCost;
+				if (splitCost >= leafCost && count <= FORCED_LEAF_LIMIT) return makeLeaf(nodes[index], first, count);
+
+				uint32_t* begin = order.data() + first;
+				uint32_t* middle = std::partition(begin, begin + count, [&](const uint32_t primitive) { return binOf(primitive) <= bestSplit; });
+				uint32_t leftSize = static_cast<uint32_t>(middle - begin);
+				if (leftSize == 0 || leftSize == count) {
+					// Every centroid landed in one bin, fall back to an object median
+					leftSize = count / 2;
+					std::nth_element(begin, begin + leftSize, begin + count, [&](const uint32_t a, const uint32_t b) {
+						return primitives[a].centroid[axis] < primitives[b].centroid[axis];
+					});
+				}
+
+				const uint32_t child = static_cast<uint32_t>(nodes.size());
+				nodes.resize(nodes.size() + 2);
+				nodes[index].first = child;
+				nodes[index].count = 0;
+				build(nodes, child, first, leftSize, depth + 1, deferred);
+				build(nodes, child + 1, first + leftSize, count - leftSize, depth + 1, deferred);
+			}
+		};
+
+		struct RayBox {
+			float origin[3], inverse[3];
+#ifdef STARLET_BVH_SSE
+			__m128 wideOrigin, wideInverse;
+#endif
+		};
+
+		RayBox makeRayBox(const Math::Vec3<float>& origin, const Math::Vec3<float>& direction) {
+			// Near-zero components get a huge finite inverse so 0 * inverse stays 0 instead of 0 * inf = NaN
+			const auto safeInverse = [](const float d) { return 1.0f / (std::fabs(d) > 1e-12f ? d : std::copysign(1e-12f, d)); };
+			RayBox ray;
+			ray.origin[0] = origin.x; ray.origin[1] = origin.y; ray.origin[2] = origin.z;
+			ray.inverse[0] = safeInverse(direction.x); ray.inverse[1] = safeInverse(direction.y); ray.inverse[2] = safeInverse(direction.z);
+#ifdef STARLET_BVH_SSE
+			ray.wideOrigin = _mm_set_ps(ray.origin[0], ray.origin[2], ray.origin[1], ray.origin[0]);
+			ray.wideInverse = _mm_set_ps(ray.inverse[0], ray.inverse[2], ray.inverse[1], ray.inverse[0]);
+#endif
+			return ray;
+		}
+
+		// Slab test against [0, maxDistance], entry is the distance where the ray enters the box
+		template <bool Sse>
+		bool hitBox(const BvhNode& node, const RayBox& ray, const float maxDistance, float& entry) {
+#ifdef STARLET_BVH_SSE
+			if constexpr (Sse) {
+				// Lane 3 loads first/count, it is replaced by a copy of lane 0 before the horizontal reductions
+				const __m128 t1 = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(node.min), ray.wideOrigin), ray.wideInverse);
+				const __m128 t2 = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(node.max), ray.wideOrigin), ray.wideInverse);
+				__m128 near = _mm_min_ps(t1, t2), far = _mm_max_ps(t1, t2);
+				near = _mm_shuffle_ps(near, near, _MM_SHUFFLE(0, 2, 1, 0));
+				far = _mm_shuffle_ps(far, far, _MM_SHUFFLE(0, 2, 1, 0));
+
+				near = _mm_max_ps(near, _mm_shuffle_ps(near, near, _MM_SHUFFLE(2, 3, 0, 1)));
+				near = _mm_max_ps(near, _mm_shuffle_ps(near, near, _MM_SHUFFLE(1, 0, 3, 2)));
+				far = _mm_min_ps(far, _mm_shuffle_ps(far, far, _MM_SHUFFLE(2, 3, 0, 1)));
+				far = _mm_min_ps(far, _mm_shuffle_ps(far, far, _MM_SHUFFLE(1, 0, 3, 2)));
+
+				entry = std::max(_mm_cvtss_f32(near), 0.0f);
+				return entry <= std::min(_mm_cvtss_f32(far), maxDistance);
+			}
+#endif
+			float near = 0.0f, far = maxDistance;
+			for (int axis = 0; axis < 3; ++axis) {
+				const float t1 = (node.min[axis] - ray.origin[axis]) * ray.inverse[axis];
+				const float t2 = (node.max[axis] - ray.origin[axis]) * ray.inverse[axis];
+				near = std::max(near, std::min(t1, t2));
+				far = std::min(far, std::max(t1, t2));
+			}
+			entry = near;
+			return near <= far;
+		}
+
+		// Möller-Trumbore, two-sided
+		bool hitTriangle(const Math::Vec3<float>& v0, const Math::Vec3<float>& e1, const Math::Vec3<float>& e2,
+			const Math::Vec3<float>& origin, const Math::Vec3<float>& direction, float& t, float& u, float& v) {
+			const Math::Vec3<float> p = direction.cross(e2);
+			const float det = e1.dot(p);
+			if (std::fabs(det) < 1e-20f) return false;
+
+			const float invDet = 1.0f / det;
+			const Math::Vec3<float> s = origin - v0;
+			u = s.dot(p) * invDet;
+			if (u < 0.0f || u > 1.0f) return false;
+
+			const Math::Vec3<float> q = s.cross(e1);
+			v = direction.dot(q) * invDet;
+			if (v < 0.0f || u + v > 1.0f) return false;
+
+			t = e2.dot(q) * invDet;
+			return t >= 0.0f;
+		}
+	}
+
+	bool MeshBvh::build(const MeshCPU& mesh, JobSystem* jobs, const BvhSettings& settings) {
+		clear();
+
+		// Coarser levels of detail follow numIndices in the index buffer and are left out
+		const uint32_t triangleCount = mesh.numIndices / 3;
+		if (triangleCount == 0 || mesh.indices.size() < static_cast<size_t>(triangleCount) * 3 || mesh.vertices.empty())
+			return Logger::error("MeshBvh", "build", "Mesh has no geometry");
+
+		const size_t vertexCount = mesh.vertices.size();
+		for (uint32_t i = 0; i < triangleCount * 3; ++i)
+			if (mesh.indices[i] >= vertexCount) return Logger::error("MeshBvh", "build", "Index out of range");
+
+		std::vector<Primitive> primitives(triangleCount);
+		forRanges(jobs, triangleCount, 4096, [&](const uint32_t begin, const uint32_t end) {
+			for (uint32_t triangle = begin; triangle < end; ++triangle) {
+				Primitive& primitive = primitives[triangle];
+				for (uint32_t corner = 0; corner < 3; ++corner)
+					primitive.bounds.grow(&mesh.vertices[mesh.indices[triangle * 3 + corner]].pos.x);
+				for (int axis = 0; axis < 3; ++axis) primitive.centroid[axis] = (primitive.bounds.min[axis] + primitive.bounds.max[axis]) * 0.5f;
+			}
+		});
+
+		std::vector<uint32_t> order(triangleCount);
+		for (uint32_t i = 0; i < triangleCount; ++i) order[i] = i;
+
+		const Builder builder{ settings, primitives, order };
+		nodes.reserve(std::max<size_t>(1, 2 * static_cast<size_t>(triangleCount) / std::max<uint32_t>(1, settings.maxLeafTriangles)));
+		nodes.resize(1);
+
+		const bool parallel = jobs && jobs->getWorkerCount() > 1 && triangleCount > settings.parallelThreshold;
+		if (!parallel) builder.build(nodes, 0, 0, triangleCount, 0, nullptr);
+		else {
+			std::vector<Subtree> deferred;
+			builder.build(nodes, 0, 0, triangleCount, 0, &deferred);
+
+			std::vector<std::vector<BvhNode>> subtrees(deferred.size());
+			forRanges(jobs, static_cast<uint32_t>(deferred.size()), 1, [&](const uint32_t begin, const uint32_t end) {
+				for (uint32_t i = begin; i < end; ++i) {
+					subtrees[i].resize(1);
+					builder.build(subtrees[i], 0, deferred[i].first, deferred[i].count, deferred[i].depth, nullptr);
+				}
+			});
+
+			// Each subtree root replaces its placeholder leaf, the rest is appended with child links shifted
+			for (size_t i = 0; i < deferred.size(); ++i) {
+				const uint32_t base = static_cast<uint32_t>(nodes.size()) - 1;
+				std::vector<BvhNode>& subtree = subtrees[i];
+				for (BvhNode& node : subtree)
+					if (node.count == 0) node.first += base;
+				nodes[deferred[i].node] = subtree[0];
+				nodes.insert(nodes.end(), subtree.begin() + 1, subtree.end());
+			}
+		}
+
+		triangles.resize(triangleCount);
+		triangleIds = std::move(order);
+		forRanges(jobs, triangleCount, 4096, [&](const uint32_t begin, const uint32_t end) {
+			for (uint32_t i = begin; i < end; ++i) {
+				const uint32_t triangle = triangleIds[i];
+				const Math::Vec3<float>& a = mesh.vertices[mesh.indices[triangle * 3]].pos;
+				triangles[i] = { a, mesh.vertices[mesh.indices[triangle * 3 + 1]].pos - a, mesh.vertices[mesh.indices[triangle * 3 + 2]].pos - a };
+			}
+		});
+		return true;
+	}
+
+	void MeshBvh::clear() {
+		nodes.clear();
+		triangles.clear();
+		triangleIds.clear();
+	}
+
+	template <bool AnyHit, bool Sse>
+	bool MeshBvh::traverse(const Math::Vec3<float>& origin, const Math::Vec3<float>& direction, float maxDistance, BvhHit* hit) const {
+		if (nodes.empty()) return false;
+
+		const RayBox ray = makeRayBox(origin, direction);
+		float entry;
+		if (!hitBox<Sse>(nodes[0], ray, maxDistance, entry)) return false;
+
+		struct Entry {
+			uint32_t node;
+			float distance;
+		};
+		Entry stack[MAX_DEPTH + 4];
+		uint32_t depth = 0;
+		uint32_t index = 0;
+		bool found = false;
+
+		while (true) {
+			const BvhNode& node = nodes[index];
+			if (node.count == 0) {
+				float leftEntry, rightEntry;
+				const bool left = hitBox<Sse>(nodes[node.first], ray, maxDistance, leftEntry);
+				const bool right = hitBox<Sse>(nodes[node.first + 1], ray, maxDistance, rightEntry);
+				if (left && right) {
+					// Nearer child first, the other waits with its entry distance so it can be dropped once a closer hit exists
+					const bool leftFirst = leftEntry <= rightEntry;
+					stack[depth++] = { leftFirst ? node.first + 1 : node.first, leftFirst ? rightEntry : leftEntry };
+					index = leftFirst ? node.first : node.first + 1;
+					continue;
+				}
+				if (left || right) {
+					index = left ? node.first : node.first + 1;
+					continue;
+				}
+			}
+			else {
+				for (uint32_t i = node.first; i < node.first + node.count; ++i) {
+					const Triangle& triangle = triangles[i];
+					float t, u, v;
+					if (!hitTriangle(triangle.v0, triangle.e1, triangle.e2, origin, direction, t, u, v) || t > maxDistance) continue;
+					if constexpr (AnyHit) return true;
+
+					maxDistance = t;
+					found = true;
+					hit->distance = t;
+					hit->u = u;
+					hit->v = v;
+					hit->triangle = triangleIds[i];
+					hit->normal = triangle.e1.cross(triangle.e2);
+				}
+			}
+
+			while (depth > 0 && stack[depth - 1].distance > maxDistance) --depth;
+			if (depth == 0) break;
+			index = stack[--depth].node;
+		}
+		return found;
+	}
+
+	bool MeshBvh::intersect(const Math::Vec3<float>& origin, const Math::Vec3<float>& direction, const float maxDistance, BvhHit& hit) const {
+#ifdef STARLET_BVH_SSE
+		if (!scalarSlabs) return traverse<false, true>(origin, direction, maxDistance, &hit);
+#endif
+		return traverse<false, false>(origin, direction, maxDistance, &hit);
+	}
+
+	bool MeshBvh::occluded(const Math::Vec3<float>& origin, const Math::Vec3<float>& direction, const float maxDistance) const {
+#ifdef STARLET_BVH_SSE
+		if (!scalarSlabs) return traverse<true, true>(origin, direction, maxDistance, nullptr);
+#endif
+		return traverse<true, false>(origin, direction, maxDistance, nullptr);
+	}
+
+	bool MeshBvh::hasSseSlabs() {
+#ifdef STARLET_BVH_SSE
+		return true;
+#else
+		return false;
+#endif
+	}
+
+	BvhBenchResult MeshBvh::benchmark(const uint32_t rays, const uint32_t seed) const {
+		BvhBenchResult result;
+		if (nodes.empty() || rays == 0) return result;
+
+		const BvhNode& root = nodes[0];
+		const Math::Vec3<float> centre{ (root.min[0] + root.max[0]) * 0.5f, (root.min[1] + root.max[1]) * 0.5f, (root.min[2] + root.max[2]) * 0.5f };
+		const Math::Vec3<float> half{ root.max[0] - centre.x, root.max[1] - centre.y, root.max[2] - centre.z };
+		const float radius = std::max(half.length() * 2.0f, 1e-3f);
+
+		// Generated up front so only traversal is timed
+		std::mt19937 random(seed);
+		std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+		std::vector<Math::Vec3<float>> origins(rays), directions(rays);
+		for (uint32_t i = 0; i < rays; ++i) {
+			Math::Vec3<float> onSphere;
+			do onSphere = { unit(random), unit(random), unit(random) }; while (onSphere.dot(onSphere) < 1e-4f || onSphere.dot(onSphere) > 1.0f);
+			origins[i] = centre + onSphere.normalized() * radius;
+			const Math::Vec3<float> target{ centre.x + half.x * unit(random), centre.y + half.y * unit(random), centre.z + half.z * unit(random) };
+			directions[i] = target - origins[i];
+		}
+
+		const Clock::time_point start = Clock::now();
+		BvhHit hit;
+		for (uint32_t i = 0; i < rays; ++i)
+			if (intersect(origins[i], directions[i], std::numeric_limits<float>::max(), hit)) ++result.hits;
+		result.milliseconds = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+		result.rays = rays;
+		if (result.milliseconds > 0.0) result.raysPerSecond = rays / (result.milliseconds / 1000.0);
+		return result;
+	}
+}
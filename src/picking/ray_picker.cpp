@@ -0,0 +1,130 @@
+#include "starlet-graphics/picking/ray_picker.hpp"
+
+#include "starlet-graphics/manager/resource_manager.hpp"
+#include "starlet-graphics/resource/mesh_info.hpp"
+#include "starlet-graphics/renderer/render_world.hpp"
+#include "starlet-graphics/renderer/camera_view.hpp"
+
+#include "starlet-math/mat4.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace Starlet::Graphics {
+	namespace {
+		Math::Vec3<float> transformPoint(const Math::Mat4& matrix, const Math::Vec3<float>& p) {
+			const float* m = matrix.models;
+			return {
+				m[0] * p.x + m[4] * p.y + m[8] * p.z + m[12],
+				m[1] * p.x + m[5] * p.y + m[9] * p.z + m[13],
+				m[2] * p.x + m[6] * p.y + m[10] * p.z + m[14]
+			};
+		}
+
+		Math::Vec3<float> transformVector(const Math::Mat4& matrix, const Math::Vec3<float>& v) {
+			const float* m = matrix.models;
+			return {
+				m[0] * v.x + m[4] * v.y + m[8] * v.z,
+				m[1] * v.x + m[5] * v.y + m[9] * v.z,
+				m[2] * v.x + m[6] * v.y + m[10] * v.z
+			};
+		}
+
+		// Normals go through the inverse transpose, given the inverse this reads it by rows
+		Math::Vec3<float> transformNormal(const Math::Mat4& inverse, const Math::Vec3<float>& n) {
+			const float* m = inverse.models;
+			return {
+				m[0] * n.x + m[1] * n.y + m[2] * n.z,
+				m[4] * n.x + m[5] * n.y + m[6] * n.z,
+				m[8] * n.x + m[9] * n.y + m[10] * n.z
+			};
+		}
+
+		// Distance along a unit ray to the sphere's near side, 0 when inside, negative when missed
+		float sphereEntry(const Math::Vec3<float>& origin, const Math::Vec3<float>& direction, const Math::Vec3<float>& centre, const float radius) {
+			const Math::Vec3<float> offset = centre - origin;
+			const float along = offset.dot(direction);
+			const float distanceSq = offset.dot(offset) - along * along;
+			const float radiusSq = radius * radius;
+			if (distanceSq > radiusSq) return -1.0f;
+
+			const float entry = along - std::sqrt(radiusSq - distanceSq);
+			if (entry >= 0.0f) return entry;
+			return along + std::sqrt(radiusSq - distanceSq) >= 0.0f ? 0.0f : -1.0f;
+		}
+	}
+
+	bool RayPicker::raycast(const RenderWorld& world, const Math::Vec3<float>& origin, const Math::Vec3<float>& direction, RayHit& hit, const float maxDistance) const {
+		return trace<false>(world, origin, direction, maxDistance, &hit);
+	}
+
+	bool RayPicker::lineOfSight(const RenderWorld& world, const Math::Vec3<float>& from, const Math::Vec3<float>& to) const {
+		const Math::Vec3<float> offset = to - from;
+		const float distance = offset.length();
+		if (distance <= 0.0f) return true;
+
+		// Pulled in slightly so surfaces the points sit on do not block them
+		const float epsilon = std::max(distance * 1e-4f, 1e-5f);
+		if (distance <= 2.0f * epsilon) return true;
+		const Math::Vec3<float> direction = offset * (1.0f / distance);
+		return !trace<true>(world, from + direction * epsilon, direction, distance - 2.0f * epsilon, nullptr);
+	}
+
+	void RayPicker::screenRay(const ViewFrustum& frustum, const float ndcX, const float ndcY, Math::Vec3<float>& origin, Math::Vec3<float>& direction) {
+		const CameraView& view = frustum.view;
+		origin = view.eye;
+		direction = (view.front + view.right * (ndcX * frustum.tanHalfX) + view.up * (ndcY * frustum.tanHalfY)).normalized();
+	}
+
+	template <bool AnyHit>
+	bool RayPicker::trace(const RenderWorld& world, const Math::Vec3<float>& origin, const Math::Vec3<float>& direction, float maxDistance, RayHit* hit) const {
+		const float length = direction.length();
+		if (!(length > 0.0f)) return false;
+
+		// With a unit world ray, model space distances along the transformed ray are world distances
+		const Math::Vec3<float> unit = direction * (1.0f / length);
+		const RenderModels& models = world.models;
+		bool found = false;
+
+		for (size_t row = 0; row < models.size(); ++row) {
+			if (!(models.flags[row] & RENDER_MODEL_VISIBLE)) continue;
+
+			const MeshBvh* bvh = resourceManager.getMeshBvh(models.mesh[row]);
+			const MeshInfo* info = resourceManager.getMeshInfo(models.mesh[row]);
+			if (!bvh || !info) continue;
+
+			const Math::Vec3<float>& scale = models.scale[row];
+			const float radius = info->boundingRadius * std::max({ std::fabs(scale.x), std::fabs(scale.y), std::fabs(scale.z) });
+			const float entry = sphereEntry(origin, unit, models.position[row], radius);
+			if (entry < 0.0f || entry > maxDistance) continue;
+
+			const Math::Mat4 model = Math::Mat4::modelMatrix({ { models.position[row], 0.0f }, models.rotation[row], scale });
+			const Math::Mat4 inverse = model.inverse();
+			const Math::Vec3<float> localOrigin = transformPoint(inverse, origin);
+			const Math::Vec3<float> localDirection = transformVector(inverse, unit);
+
+			if constexpr (AnyHit) {
+				if (bvh->occluded(localOrigin, localDirection, maxDistance)) return true;
+				continue;
+			}
+			else {
+				BvhHit local;
+				if (!bvh->intersect(localOrigin, localDirection, maxDistance, local)) continue;
+
+				maxDistance = local.distance;
+				found = true;
+				hit->distance = local.distance;
+				hit->position = origin + unit * local.distance;
+				hit->row = static_cast<uint32_t>(row);
+				hit->entity = models.entity[row];
+				hit->triangle = local.triangle;
+
+				Math::Vec3<float> normal = transformNormal(inverse, local.normal);
+				const float normalLength = normal.length();
+				if (normalLength > 0.0f) normal = normal * (1.0f / normalLength);
+				hit->normal = normal.dot(unit) > 0.0f ? normal * -1.0f : normal;
+			}
+		}
+		return found;
+	}
+}
@@ -0,0 +1,256 @@
+#include "starlet-graphics/profiler/profiler.hpp"
+#include "starlet-logger/logger.hpp"
+
+#include <glad/glad.h>
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+
+namespace Starlet::Graphics {
+	namespace {
+		constexpr GLsizei QUERY_BATCH{ 16 };
+		constexpr size_t DEFAULT_MAX_EVENTS{ 4096 };
+
+		void appendEscaped(std::string& out, const char* text) {
+			for (; *text; ++text) {
+				const char c = *text;
+				if (c == '"' || c == '\\') { out += '\\'; out += c; }
+				else if (static_cast<unsigned char>(c) < 0x20) out += ' ';
+				else out += c;
+			}
+		}
+
+		void appendEvent(std::string& out, const ProfileEvent& event, const int tid, const double beginUs, const double endUs) {
+			char numbers[128];
+			std::snprintf(numbers, sizeof(numbers), "\"ts\":%.3f,\"dur\":%.3f,\"pid\":1,\"tid\":%d", beginUs, endUs - beginUs, tid);
+
+			out += ",\n{\"name\":\"";
+			appendEscaped(out, event.name);
+			out += "\",\"cat\":\"";
+			out += (tid == 1) ? "cpu" : "gpu";
+			out += "\",\"ph\":\"X\",";
+			out += numbers;
+			out += ",\"args\":{\"frame\":" + std::to_string(event.frame) + ",\"depth\":" + std::to_string(event.depth) + "}}";
+		}
+	}
+
+	Profiler::Profiler() : epoch(std::chrono::steady_clock::now()) {
+		events.resize(DEFAULT_MAX_EVENTS);
+	}
+
+	double Profiler::nowUs() const {
+		return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - epoch).count();
+	}
+
+	bool Profiler::initGpu() {
+		if (gpuEnabled) return true;
+		if (!glGenQueries || !glDeleteQueries || !glQueryCounter || !glGetQueryObjectiv || !glGetQueryObjectui64v || !glGetInteger64v)
+			return Logger::error("Profiler", "initGpu", "Timer queries unavailable, GPU profiling disabled");
+
+		// GL_TIMESTAMP is on the GPU clock, sample both clocks once to line them up
+		GLint64 gpuNow = 0;
+		glGetInteger64v(GL_TIMESTAMP, &gpuNow);
+		gpuOffsetUs = nowUs() - static_cast<double>(gpuNow) / 1000.0;
+
+		debugGroups = glPushDebugGroup && glPopDebugGroup;
+		gpuEnabled = true;
+		return true;
+	}
+
+	void Profiler::shutdownGpu() {
+		if (!gpuEnabled) return;
+
+		for (FrameSlot& slot : slots) {
+			freeQueries.insert(freeQueries.end(), slot.queries.begin(), slot.queries.end());
+			slot.queries.clear();
+			slot.pending = false;
+		}
+		if (!freeQueries.empty()) glDeleteQueries(static_cast<GLsizei>(freeQueries.size()), freeQueries.data());
+		freeQueries.clear();
+
+		debugGroups = false;
+		gpuEnabled = false;
+	}
+
+	std::vector<ProfileEvent> Profiler::getEvents() const {
+		std::vector<ProfileEvent> out;
+		out.reserve(eventCount);
+		for (size_t i = 0; i < eventCount; ++i) out.push_back(getEvent(i));
+		return out;
+	}
+
+	void Profiler::setMaxEvents(const size_t count) {
+		// The newest events that still fit are kept
+		std::vector<ProfileEvent> kept = getEvents();
+		const size_t first = kept.size() > count ? kept.size() - count : 0;
+
+		events.assign(count, ProfileEvent{});
+		eventHead = 0;
+		eventCount = kept.size() - first;
+		for (size_t i = 0; i < eventCount; ++i) events[i] = kept[first + i];
+	}
+
+	unsigned int Profiler::acquireQuery() {
+		if (freeQueries.empty()) {
+			GLuint batch[QUERY_BATCH];
+			glGenQueries(QUERY_BATCH, batch);
+			freeQueries.insert(freeQueries.end(), batch, batch + QUERY_BATCH);
+		}
+
+		const unsigned int query = freeQueries.back();
+		freeQueries.pop_back();
+		return query;
+	}
+
+	void Profiler::beginFrame() {
+		if (!enabled) return;
+		if (inFrame) endFrame();
+
+		++frame;
+		inFrame = true;
+
+		FrameSlot& slot = slots[frame % FRAME_LATENCY];
+		if (slot.pending) resolve(slot, false);
+		slot.frame = frame;
+		slot.events.clear();
+		slot.queries.clear();
+	}
+
+	void Profiler::endFrame() {
+		if (!inFrame) return;
+
+		if (!open.empty()) {
+			Logger::error("Profiler", "endFrame", std::to_string(open.size()) + " scope(s) still open at end of frame");
+			while (!open.empty()) endScope();
+		}
+		inFrame = false;
+
+		FrameSlot& slot = slots[frame % FRAME_LATENCY];
+		if (gpuEnabled && !slot.queries.empty()) slot.pending = true;
+		else {
+			publish(slot.events);
+			lastResolvedFrame = slot.frame;
+		}
+	}
+
+	bool Profiler::beginScope(const char* name) {
+		if (!enabled || !inFrame) return false;
+
+		FrameSlot& slot = slots[frame % FRAME_LATENCY];
+		ProfileEvent event;
+		event.name = name;
+		event.frame = frame;
+		event.depth = static_cast<uint32_t>(open.size());
+
+		open.push_back(slot.events.size());
+		if (debugGroups) glPushDebugGroup(GL_DEBUG_SOURCE_APPLICATION, 0, -1, name);
+		if (gpuEnabled) {
+			const unsigned int query = acquireQuery();
+			glQueryCounter(query, GL_TIMESTAMP);
+			slot.queries.push_back(query);
+			slot.queries.push_back(0);
+		}
+
+		event.cpuBeginUs = nowUs();
+		slot.events.push_back(event);
+		return true;
+	}
+
+	void Profiler::endScope() {
+		if (open.empty()) return;
+
+		FrameSlot& slot = slots[frame % FRAME_LATENCY];
+		const size_t index = open.back();
+		open.pop_back();
+		slot.events[index].cpuEndUs = nowUs();
+
+		if (gpuEnabled && slot.queries.size() > 2 * index + 1) {
+			const unsigned int query = acquireQuery();
+			glQueryCounter(query, GL_TIMESTAMP);
+			slot.queries[2 * index + 1] = query;
+		}
+		if (debugGroups) glPopDebugGroup();
+	}
+
+	void Profiler::resolve(FrameSlot& slot, const bool wait) {
+		// The last end timestamp completes after every other query of the frame
+		GLint available = GL_TRUE;
+		if (!wait && !slot.queries.empty()) glGetQueryObjectiv(slot.queries.back(), GL_QUERY_RESULT_AVAILABLE, &available);
+
+		if (available) {
+			for (size_t i = 0; i < slot.events.size() && 2 * i + 1 < slot.queries.size(); ++i) {
+				GLuint64 beginNs = 0, endNs = 0;
+				glGetQueryObjectui64v(slot.queries[2 * i], GL_QUERY_RESULT, &beginNs);
+				glGetQueryObjectui64v(slot.queries[2 * i + 1], GL_QUERY_RESULT, &endNs);
+				slot.events[i].gpuBeginUs = static_cast<double>(beginNs) / 1000.0 + gpuOffsetUs;
+				slot.events[i].gpuEndUs = static_cast<double>(endNs) / 1000.0 + gpuOffsetUs;
+			}
+		}
+		else ++droppedGpuFrames;
+
+		for (const unsigned int query : slot.queries)
+			if (query) freeQueries.push_back(query);
+		slot.queries.clear();
+		slot.pending = false;
+
+		publish(slot.events);
+		lastResolvedFrame = slot.frame;
+	}
+
+	void Profiler::publish(std::vector<ProfileEvent>& frameEvents) {
+		if (!events.empty()) {
+			for (const ProfileEvent& event : frameEvents) {
+				if (eventCount < events.size()) events[(eventHead + eventCount++) % events.size()] = event;
+				else {
+					events[eventHead] = event;
+					eventHead = (eventHead + 1) % events.size();
+				}
+			}
+		}
+		frameEvents.clear();
+	}
+
+	double Profiler::getCpuMs(const char* name) const {
+		double total = 0.0;
+		for (size_t i = eventCount; i-- > 0;) {
+			const ProfileEvent& event = getEvent(i);
+			if (event.frame != lastResolvedFrame) break;
+			if (std::strcmp(event.name, name) == 0) total += (event.cpuEndUs - event.cpuBeginUs) / 1000.0;
+		}
+		return total;
+	}
+
+	double Profiler::getGpuMs(const char* name) const {
+		double total = 0.0;
+		for (size_t i = eventCount; i-- > 0;) {
+			const ProfileEvent& event = getEvent(i);
+			if (event.frame != lastResolvedFrame) break;
+			if (std::strcmp(event.name, name) == 0 && event.hasGpu()) total += (event.gpuEndUs - event.gpuBeginUs) / 1000.0;
+		}
+		return total;
+	}
+
+	std::string Profiler::toChromeTrace(const std::vector<ProfileEvent>& events) {
+		std::string out = "{\"traceEvents\":[";
+		out += "\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":1,\"args\":{\"name\":\"CPU\"}}";
+		out += ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":2,\"args\":{\"name\":\"GPU\"}}";
+
+		for (const ProfileEvent& event : events) {
+			appendEvent(out, event, 1, event.cpuBeginUs, event.cpuEndUs);
+			if (event.hasGpu()) appendEvent(out, event, 2, event.gpuBeginUs, event.gpuEndUs);
+		}
+
+		out += "\n],\"displayTimeUnit\":\"ms\"}\n";
+		return out;
+	}
+
+	bool Profiler::writeChromeTrace(const std::string& path) const {
+		std::ofstream file(path, std::ios::binary | std::ios::trunc);
+		if (!file) return Logger::error("Profiler", "writeChromeTrace", "Failed to open: " + path);
+
+		file << toChromeTrace(getEvents());
+		if (!file) return Logger::error("Profiler", "writeChromeTrace", "Failed to write: " + path);
+		return Logger::debug("Profiler", "writeChromeTrace", "Wrote " + std::to_string(eventCount) + " events to: " + path);
+	}
+}
@@ -1,5 +1,6 @@
 #include "starlet-graphics/renderer/camera_renderer.hpp"
 #include "starlet-graphics/uniform/uniform_cache.hpp"
+#include "starlet-graphics/renderer/frame_stats.hpp"
 
 #include "starlet-math/mat4.hpp"
 
@@ -12,5 +13,6 @@ namespace Starlet::Graphics {
 		const ModelUL& modelUL = uniforms.getModelCache().getModelUL();
 		glUniformMatrix4fv(modelUL.modelView, 1, GL_FALSE, view.ptr());
 		glUniformMatrix4fv(modelUL.modelProj, 1, GL_FALSE, projection.ptr());
+		stats.uniformUploads += 3;
 	}
 }
\ No newline at end of file
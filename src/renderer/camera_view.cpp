@@ -1,6 +1,8 @@
 #include "starlet-graphics/renderer/camera_view.hpp"
 #include "starlet-math/constants.hpp"
 
+#include <cmath>
+
 namespace Starlet::Graphics {
   CameraView CameraView::fromTransform(const Math::Vec3<float>& position, const Math::Vec3<float>& rotation, const Math::Vec3<float>& worldUp) {
     CameraView view;
@@ -18,4 +20,31 @@ namespace Starlet::Graphics {
     view.up = view.right.cross(view.front).normalized();
     return view;
   }
+
+  ViewFrustum ViewFrustum::fromView(const CameraView& view, const float fov, const float aspect, const float nearPlane, const float farPlane) {
+    ViewFrustum frustum;
+    frustum.view = view;
+    frustum.tanHalfY = std::tan(radians(fov) * 0.5f);
+    frustum.tanHalfX = frustum.tanHalfY * aspect;
+    frustum.nearPlane = nearPlane;
+    frustum.farPlane = farPlane;
+    return frustum;
+  }
+
+  Math::Vec3<float> ViewFrustum::toView(const Math::Vec3<float>& point) const {
+    const Math::Vec3<float> offset = point - view.eye;
+    return { offset.dot(view.right), offset.dot(view.up), offset.dot(view.front) };
+  }
+
+  bool ViewFrustum::intersectsSphere(const Math::Vec3<float>& centre, const float radius) const {
+    const Math::Vec3<float> p = toView(centre);
+    if (p.z + radius < nearPlane || p.z - radius > farPlane) return false;
+
+    // Side planes pass through the eye, (1, 0, -tan) scaled to unit length is the right plane normal
+    const float scaleX = 1.0f / std::sqrt(1.0f + tanHalfX * tanHalfX);
+    const float scaleY = 1.0f / std::sqrt(1.0f + tanHalfY * tanHalfY);
+    if ((p.x - p.z * tanHalfX) * scaleX > radius || (-p.x - p.z * tanHalfX) * scaleX > radius) return false;
+    if ((p.y - p.z * tanHalfY) * scaleY > radius || (-p.y - p.z * tanHalfY) * scaleY > radius) return false;
+    return true;
+  }
 }
\ No newline at end of file
@@ -0,0 +1,86 @@
+#include "starlet-graphics/renderer/depth_prepass.hpp"
+#include "starlet-logger/logger.hpp"
+
+#include "starlet-graphics/manager/shader_manager.hpp"
+#include "starlet-graphics/manager/gl_state_manager.hpp"
+#include "starlet-graphics/renderer/frame_stats.hpp"
+
+#include "starlet-math/mat4.hpp"
+
+#include <glad/glad.h>
+
+#include <algorithm>
+
+namespace Starlet::Graphics {
+	namespace {
+		// Same uniform names and multiplication order as the model program, so both passes produce identical depth
+		constexpr const char* DEPTH_VERTEX_SOURCE{
+			"#version 330 core\n"
+			"layout(location = 0) in vec3 vPos;\n"
+			"uniform mat4 mModel;\n"
+			"uniform mat4 mView;\n"
+			"uniform mat4 mProj;\n"
+			"invariant gl_Position;\n"
+			"void main() {\n"
+			"\tgl_Position = mProj * mView * mModel * vec4(vPos, 1.0);\n"
+			"}\n"
+		};
+
+		constexpr const char* DEPTH_FRAGMENT_SOURCE{
+			"#version 330 core\n"
+			"void main() {}\n"
+		};
+	}
+
+	bool DepthPrepass::init(ShaderManager& sm) {
+		if (!sm.createProgramFromSources(PROGRAM_NAME, DEPTH_VERTEX_SOURCE, DEPTH_FRAGMENT_SOURCE))
+			return Logger::error("DepthPrepass", "init", "Failed to build depth program");
+
+		program = sm.getProgramID(PROGRAM_NAME);
+		modelLocation = glGetUniformLocation(program, "mModel");
+		viewLocation = glGetUniformLocation(program, "mView");
+		projLocation = glGetUniformLocation(program, "mProj");
+		if (modelLocation < 0 || viewLocation < 0 || projLocation < 0) {
+			program = 0;
+			return Logger::error("DepthPrepass", "init", "Depth program is missing mModel, mView or mProj");
+		}
+		return true;
+	}
+
+	void DepthPrepass::draw(const std::pmr::vector<DrawPacket>& packets, const Math::Mat4& view, const Math::Mat4& projection) {
+		if (!program || packets.empty()) return;
+
+		state.setProgram(program);
+		glUniformMatrix4fv(viewLocation, 1, GL_FALSE, view.ptr());
+		glUniformMatrix4fv(projLocation, 1, GL_FALSE, projection.ptr());
+		stats.uniformUploads += 2;
+
+		state.setDepthTest(true);
+		state.setDepthFunc(GL_LESS);
+		state.setDepthMask(true);
+		state.setColourMask(false);
+		state.setCulling(true);
+		state.setCullFace(GL_BACK);
+
+		std::pmr::vector<uint32_t> order(packets.size(), &frameMemory);
+		for (uint32_t i = 0; i < order.size(); ++i) order[i] = i;
+		std::sort(order.begin(), order.end(), [&packets](const uint32_t a, const uint32_t b) { return packets[a].distanceSq < packets[b].distanceSq; });
+
+		for (const uint32_t index : order) {
+			const DrawPacket& packet = packets[index];
+			if (!packet.valid) continue;
+			glUniformMatrix4fv(modelLocation, 1, GL_FALSE, packet.model.models);
+			state.bindVertexArray(packet.depthVao ? packet.depthVao : packet.vao);
+			glDrawElements(GL_TRIANGLES, packet.numIndices, GL_UNSIGNED_INT, reinterpret_cast<const void*>(static_cast<uintptr_t>(packet.firstIndex) * sizeof(unsigned int)));
+
+			++stats.uniformUploads;
+			++stats.drawCalls;
+			++stats.prepassDrawCalls;
+			stats.triangles += packet.numIndices / 3;
+			stats.prepassTriangles += packet.numIndices / 3;
+			stats.vertices += packet.numVertices;
+		}
+
+		state.setColourMask(true);
+	}
+}
@@ -0,0 +1,68 @@
+#include "starlet-graphics/renderer/draw_errors.hpp"
+#include "starlet-logger/logger.hpp"
+
+#include <algorithm>
+#include <string>
+
+namespace Starlet::Graphics {
+	namespace {
+		constexpr const char* ERROR_NAMES[DrawErrorCounts::KINDS]{ "missing mesh", "missing texture", "missing program variant" };
+	}
+
+	void DrawErrorCounts::add(const DrawError error, const std::string_view name) {
+		const size_t kind = static_cast<size_t>(error);
+		if (counts[kind]++ != 0) return;
+
+		const size_t length = std::min(name.size(), NAME_LENGTH - 1);
+		name.copy(firstName[kind], length);
+		firstName[kind][length] = '\0';
+	}
+
+	void DrawErrorCounts::merge(const DrawErrorCounts& other) {
+		for (size_t kind = 0; kind < KINDS; ++kind) {
+			if (other.counts[kind] == 0) continue;
+			if (counts[kind] == 0) std::copy(other.firstName[kind], other.firstName[kind] + NAME_LENGTH, firstName[kind]);
+			counts[kind] += other.counts[kind];
+		}
+	}
+
+	void DrawErrorCounts::clear() {
+		for (size_t kind = 0; kind < KINDS; ++kind) {
+			counts[kind] = 0;
+			firstName[kind][0] = '\0';
+		}
+	}
+
+	uint32_t DrawErrorCounts::total() const {
+		uint32_t sum = 0;
+		for (const uint32_t count : counts) sum += count;
+		return sum;
+	}
+
+	bool DrawErrorReport::endFrame() {
+		lastFrame = frame;
+		frame.clear();
+		if (lastFrame.total() != 0) {
+			pending.merge(lastFrame);
+			++pendingFrames;
+		}
+		if (pendingFrames == 0) return false;
+
+		const Clock::time_point now = Clock::now();
+		if (hasLogged && std::chrono::duration<double>(now - lastLog).count() < interval) return false;
+
+		// The only place a message is formatted, at most once per interval
+		std::string message = "Skipped draws over " + std::to_string(pendingFrames) + " frame(s):";
+		for (size_t kind = 0; kind < DrawErrorCounts::KINDS; ++kind) {
+			if (pending.counts[kind] == 0) continue;
+			message += std::string(" ") + ERROR_NAMES[kind] + " x" + std::to_string(pending.counts[kind]) + " (first: " + pending.firstName[kind] + ")";
+		}
+		Logger::error("Renderer", "renderFrame", message);
+
+		pending.clear();
+		pendingFrames = 0;
+		lastLog = now;
+		hasLogged = true;
+		return true;
+	}
+}
@@ -0,0 +1,40 @@
+#include "starlet-graphics/renderer/frame_stats.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace Starlet::Graphics {
+	void FrameStatsHistory::setCapacity(const size_t frames) {
+		frameMs.assign(frames, 0.0);
+		sorted.clear();
+		sorted.reserve(frames);
+		next = 0;
+		count = 0;
+	}
+
+	void FrameStatsHistory::push(const FrameStats& stats) {
+		if (frameMs.empty()) return;
+
+		frameMs[next] = stats.frameMs;
+		next = (next + 1) % frameMs.size();
+		if (count < frameMs.size()) ++count;
+	}
+
+	void FrameStatsHistory::clear() {
+		next = 0;
+		count = 0;
+	}
+
+	double FrameStatsHistory::percentile(const double p) const {
+		if (count == 0) return 0.0;
+
+		// Until the ring wraps the held frames are the prefix, after that every slot is live
+		sorted.assign(frameMs.begin(), frameMs.begin() + static_cast<std::ptrdiff_t>(count));
+		const double clamped = std::clamp(p, 0.0, 100.0);
+		const size_t rank = static_cast<size_t>(std::ceil(clamped / 100.0 * static_cast<double>(count)));
+		const size_t index = (rank == 0) ? 0 : rank - 1;
+
+		std::nth_element(sorted.begin(), sorted.begin() + static_cast<std::ptrdiff_t>(index), sorted.end());
+		return sorted[index];
+	}
+}
@@ -0,0 +1,189 @@
+#include "starlet-graphics/renderer/light_clusters.hpp"
+#include "starlet-graphics/renderer/render_world.hpp"
+#include "starlet-graphics/renderer/camera_view.hpp"
+#include "starlet-graphics/manager/gl_state_manager.hpp"
+#include "starlet-graphics/jobs/job_system.hpp"
+#include "starlet-logger/logger.hpp"
+
+#include "starlet-math/constants.hpp"
+
+#include <glad/glad.h>
+
+#include <algorithm>
+#include <cmath>
+
+namespace Starlet::Graphics {
+	float lightInfluenceRange(const Math::Vec4<float>& attenuation, const float cutoff) {
+		if (cutoff <= 0.0f) return -1.0f;
+
+		const float constant = attenuation.x, linear = attenuation.y, quadratic = attenuation.z;
+		const float c = constant - 1.0f / cutoff;
+		if (c >= 0.0f) return 0.0f; // Never brighter than the cutoff
+
+		if (quadratic > 0.0f) return (-linear + std::sqrt(linear * linear - 4.0f * quadratic * c)) / (2.0f * quadratic);
+		if (linear > 0.0f) return -c / linear;
+		return -1.0f;
+	}
+
+	void LightClusters::setGrid(const uint32_t x, const uint32_t y, const uint32_t z) {
+		dimX = std::max<uint32_t>(1, x);
+		dimY = std::max<uint32_t>(1, y);
+		dimZ = std::max<uint32_t>(1, z);
+		bounds.clear();
+	}
+
+	void LightClusters::buildBounds(const ClusterProjection& projection) {
+		boundsProjection = projection;
+		bounds.resize(static_cast<size_t>(dimX) * dimY * dimZ);
+
+		const float tanHalfY = std::tan(radians(projection.fov) * 0.5f);
+		const float tanHalfX = tanHalfY * projection.aspect;
+		const float depthRatio = projection.farPlane / projection.nearPlane;
+
+		sliceScale = static_cast<float>(dimZ) / std::log(depthRatio);
+		sliceBias = sliceScale * std::log(projection.nearPlane);
+
+		for (uint32_t z = 0; z < dimZ; ++z) {
+			const float zNear = projection.nearPlane * std::pow(depthRatio, static_cast<float>(z) / dimZ);
+			const float zFar = projection.nearPlane * std::pow(depthRatio, static_cast<float>(z + 1) / dimZ);
+
+			for (uint32_t y = 0; y < dimY; ++y) {
+				const float y0 = (-1.0f + 2.0f * y / dimY) * tanHalfY;
+				const float y1 = (-1.0f + 2.0f * (y + 1) / dimY) * tanHalfY;
+
+				for (uint32_t x = 0; x < dimX; ++x) {
+					const float x0 = (-1.0f + 2.0f * x / dimX) * tanHalfX;
+					const float x1 = (-1.0f + 2.0f * (x + 1) / dimX) * tanHalfX;
+
+					// Tile edges are lines through the eye, so the extremes sit at one of the two depths
+					ClusterBounds& cluster = bounds[getClusterIndex(x, y, z)];
+					cluster.min = { std::min(x0 * zNear, x0 * zFar), std::min(y0 * zNear, y0 * zFar), zNear };
+					cluster.max = { std::max(x1 * zNear, x1 * zFar), std::max(y1 * zNear, y1 * zFar), zFar };
+				}
+			}
+		}
+	}
+
+	bool LightClusters::sphereIntersects(const ClusterBounds& cluster, const Math::Vec3<float>& centre, const float radius) {
+		const float dx = centre.x - std::clamp(centre.x, cluster.min.x, cluster.max.x);
+		const float dy = centre.y - std::clamp(centre.y, cluster.min.y, cluster.max.y);
+		const float dz = centre.z - std::clamp(centre.z, cluster.min.z, cluster.max.z);
+		return dx * dx + dy * dy + dz * dz <= radius * radius;
+	}
+
+	void LightClusters::build(const RenderWorld& world, const CameraView& view, const ClusterProjection& projection, JobSystem* jobs) {
+		if (projection.nearPlane <= 0.0f || projection.farPlane <= projection.nearPlane) {
+			Logger::error("LightClusters", "build", "Clustering needs 0 < near < far");
+			return;
+		}
+
+		const bool projectionChanged = projection.fov != boundsProjection.fov || projection.aspect != boundsProjection.aspect
+			|| projection.nearPlane != boundsProjection.nearPlane || projection.farPlane != boundsProjection.farPlane;
+		if (bounds.empty() || projectionChanged) buildBounds(projection);
+
+		const RenderLights& source = world.lights;
+		lights.clear();
+		spheres.clear();
+		globalLights.clear();
+		for (size_t i = 0; i < source.size(); ++i) {
+			if (!source.active[i]) continue;
+
+			const Math::Vec3<float> offset{ source.position[i].x - view.eye.x, source.position[i].y - view.eye.y, source.position[i].z - view.eye.z };
+			float radius = source.param1[i].x == DIRECTIONAL_LIGHT_TYPE ? -1.0f : lightInfluenceRange(source.attenuation[i], cutoff);
+			if (radius == 0.0f) continue;
+
+			const uint32_t index = static_cast<uint32_t>(lights.size());
+			lights.push_back({ source.position[i], source.diffuse[i], source.attenuation[i], source.direction[i], source.param1[i], { 1.0f, 0.0f, 0.0f, 0.0f } });
+			spheres.push_back({ offset.dot(view.right), offset.dot(view.up), offset.dot(view.front), radius });
+			if (radius < 0.0f) globalLights.push_back(index);
+		}
+
+		clusterLists.resize(bounds.size());
+		if (jobs) jobs->parallelFor(dimZ, 1, [this](const uint32_t begin, const uint32_t end) {
+			for (uint32_t slice = begin; slice < end; ++slice) assignSlice(slice);
+		});
+		else for (uint32_t slice = 0; slice < dimZ; ++slice) assignSlice(slice);
+
+		ranges.resize(bounds.size() * 2);
+		indices.clear();
+		for (size_t cluster = 0; cluster < bounds.size(); ++cluster) {
+			ranges[cluster * 2] = static_cast<uint32_t>(indices.size());
+			ranges[cluster * 2 + 1] = static_cast<uint32_t>(clusterLists[cluster].size());
+			indices.insert(indices.end(), clusterLists[cluster].begin(), clusterLists[cluster].end());
+		}
+	}
+
+	void LightClusters::assignSlice(const uint32_t slice) {
+		const size_t first = static_cast<size_t>(slice) * dimX * dimY;
+		const ClusterBounds& sliceBounds = bounds[first];
+
+		for (size_t cluster = first; cluster < first + static_cast<size_t>(dimX) * dimY; ++cluster)
+			clusterLists[cluster].assign(globalLights.begin(), globalLights.end());
+
+		for (uint32_t light = 0; light < spheres.size(); ++light) {
+			const Math::Vec4<float>& sphere = spheres[light];
+			if (sphere.w < 0.0f) continue;
+			if (sphere.z + sphere.w < sliceBounds.min.z || sphere.z - sphere.w > sliceBounds.max.z) continue;
+
+			const Math::Vec3<float> centre{ sphere.x, sphere.y, sphere.z };
+			for (size_t cluster = first; cluster < first + static_cast<size_t>(dimX) * dimY; ++cluster)
+				if (sphereIntersects(bounds[cluster], centre, sphere.w)) clusterLists[cluster].push_back(light);
+		}
+	}
+
+	const uint32_t* LightClusters::getClusterLights(const size_t cluster, uint32_t& count) const {
+		count = ranges[cluster * 2 + 1];
+		return indices.data() + ranges[cluster * 2];
+	}
+
+	bool LightClusters::enableUpload(GLStateManager& sm, const unsigned int binding) {
+		disableUpload();
+
+		glGenBuffers(3, buffers);
+		if (buffers[0] == 0 || buffers[1] == 0 || buffers[2] == 0) {
+			glDeleteBuffers(3, buffers);
+			buffers[0] = buffers[1] = buffers[2] = 0;
+			return Logger::error("LightClusters", "enableUpload", "Failed to create cluster buffers");
+		}
+
+		state = &sm;
+		bindingBase = binding;
+		return true;
+	}
+
+	void LightClusters::disableUpload() {
+		if (!state) return;
+
+		// Clears the generic binding too, so the shadow never holds a deleted name
+		for (unsigned int i = 0; i < 3; ++i) state->bindBufferBase(GL_SHADER_STORAGE_BUFFER, bindingBase + i, 0);
+		glDeleteBuffers(3, buffers);
+		buffers[0] = buffers[1] = buffers[2] = 0;
+		state = nullptr;
+	}
+
+	void LightClusters::upload() {
+		if (!state) return;
+
+		struct GridHeader {
+			uint32_t dims[4];
+			float depth[4];
+		} header{
+			{ dimX, dimY, dimZ, static_cast<uint32_t>(lights.size()) },
+			{ boundsProjection.nearPlane, boundsProjection.farPlane, sliceScale, sliceBias }
+		};
+
+		// Sizes change every frame, glBufferData orphans the previous storage instead of waiting on it
+		state->bindBuffer(GL_SHADER_STORAGE_BUFFER, buffers[0]);
+		glBufferData(GL_SHADER_STORAGE_BUFFER, std::max<size_t>(1, lights.size()) * sizeof(LightStd140), lights.empty() ? nullptr : lights.data(), GL_STREAM_DRAW);
+
+		state->bindBuffer(GL_SHADER_STORAGE_BUFFER, buffers[1]);
+		glBufferData(GL_SHADER_STORAGE_BUFFER, sizeof(GridHeader) + ranges.size() * sizeof(uint32_t), nullptr, GL_STREAM_DRAW);
+		glBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, sizeof(GridHeader), &header);
+		glBufferSubData(GL_SHADER_STORAGE_BUFFER, sizeof(GridHeader), ranges.size() * sizeof(uint32_t), ranges.data());
+
+		state->bindBuffer(GL_SHADER_STORAGE_BUFFER, buffers[2]);
+		glBufferData(GL_SHADER_STORAGE_BUFFER, std::max<size_t>(1, indices.size()) * sizeof(uint32_t), indices.empty() ? nullptr : indices.data(), GL_STREAM_DRAW);
+
+		for (unsigned int i = 0; i < 3; ++i) state->bindBufferBase(GL_SHADER_STORAGE_BUFFER, bindingBase + i, buffers[i]);
+	}
+}
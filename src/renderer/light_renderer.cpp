@@ -1,51 +1,179 @@
 #include "starlet-graphics/renderer/light_renderer.hpp"
 #include "starlet-graphics/uniform/uniform_cache.hpp"
-
-#include "starlet-scene/scene.hpp"
-#include "starlet-scene/component/light.hpp"
-#include "starlet-scene/component/transform.hpp"
-#include "starlet-scene/component/colour.hpp"
+#include "starlet-graphics/renderer/frame_stats.hpp"
+#include "starlet-graphics/renderer/render_world.hpp"
+#include "starlet-graphics/renderer/light_clusters.hpp"
+#include "starlet-graphics/renderer/camera_view.hpp"
+#include "starlet-graphics/manager/gl_state_manager.hpp"
+#include "starlet-logger/logger.hpp"
 
 #include <glad/glad.h>
 
+#include <algorithm>
+
 namespace Starlet::Graphics {
-	void LightRenderer::updateLightUniforms(const unsigned int program, const Scene::Scene& scene) const {
-		auto lightEntities = scene.getEntitiesOfType<Scene::Light>();
-		updateLightCount(static_cast<int>(lightEntities.size()));
-
-		const unsigned int location = uniforms.getLightCache().getAmbientLightLocation();
-		if (location != -1) glUniform4fv(location, 1, &scene.getAmbientLight().x);
-
-		int lightIndex = 0;
-		for (const auto& [entity, light] : lightEntities) {
-			std::string prefix = "theLights[" + std::to_string(lightIndex) + "].";
-			int pos_UL = glGetUniformLocation(program, (prefix + "position").c_str());
-			int diff_UL = glGetUniformLocation(program, (prefix + "diffuse").c_str());
-			int atten_UL = glGetUniformLocation(program, (prefix + "attenuation").c_str());
-			int dir_UL = glGetUniformLocation(program, (prefix + "direction").c_str());
-			int param1_UL = glGetUniformLocation(program, (prefix + "param1").c_str());
-			int param2_UL = glGetUniformLocation(program, (prefix + "param2").c_str());
-
-			if (!light->enabled || !scene.hasComponent<Scene::TransformComponent>(entity)) {
-				if (param2_UL != -1) glUniform4f(param2_UL, 0.0f, 0.0f, 0.0f, 0.0f);
-				++lightIndex;
+	namespace {
+		bool sameVec4(const Math::Vec4<float>& a, const Math::Vec4<float>& b) { return a.x == b.x && a.y == b.y && a.z == b.z && a.w == b.w; }
+	}
+
+	bool LightRenderer::enableUniformBuffer(const unsigned int binding) {
+		disableUniformBuffer();
+
+		glGenBuffers(1, &ubo);
+		if (ubo == 0) return Logger::error("LightRenderer", "enableUniformBuffer", "Failed to create light uniform buffer");
+
+		state.bindBuffer(GL_UNIFORM_BUFFER, ubo);
+		glBufferData(GL_UNIFORM_BUFFER, LightCache::MAX_LIGHTS * sizeof(LightStd140), nullptr, GL_DYNAMIC_DRAW);
+		state.bindBufferBase(GL_UNIFORM_BUFFER, binding, ubo);
+
+		uboBinding = binding;
+		uboVersions.assign(LightCache::MAX_LIGHTS, 0);
+		for (std::unordered_map<unsigned int, ProgramLights>::iterator it = programs.begin(); it != programs.end(); ++it)
+			it->second.blockBound = false;
+		return true;
+	}
+
+	void LightRenderer::disableUniformBuffer() {
+		if (ubo == 0) return;
+
+		state.bindBufferBase(GL_UNIFORM_BUFFER, uboBinding, 0);
+		glDeleteBuffers(1, &ubo);
+		ubo = 0;
+		uboVersions.clear();
+	}
+
+	void LightRenderer::invalidate() {
+		programs.clear();
+		std::fill(uboVersions.begin(), uboVersions.end(), 0);
+	}
+
+	void LightRenderer::pack(const RenderWorld& world, const size_t slot, const size_t row) {
+		// Versions are unique across rows, so a slot that now holds a different light also reads as changed
+		const RenderLights& lights = world.lights;
+		if (packedVersions[slot] == lights.version[row]) return;
+		packedVersions[slot] = lights.version[row];
+
+		LightStd140& light = packed[slot];
+		light.position = lights.position[row];
+		light.diffuse = lights.diffuse[row];
+		light.attenuation = lights.attenuation[row];
+		light.direction = lights.direction[row];
+		light.param1 = lights.param1[row];
+		light.param2 = { lights.active[row] ? 1.0f : 0.0f, 0.0f, 0.0f, 0.0f };
+	}
+
+	void LightRenderer::prepareLights(const RenderWorld& world, const ViewFrustum* frustum) {
+		const RenderLights& lights = world.lights;
+		packed.resize(lights.size());
+		packedVersions.resize(lights.size(), 0);
+
+		if (!culling) {
+			for (size_t row = 0; row < lights.size(); ++row) pack(world, row, row);
+			stats.activeLights = static_cast<uint32_t>(lights.size());
+			return;
+		}
+
+		size_t slot = 0;
+		for (size_t row = 0; row < lights.size(); ++row) {
+			if (!lights.active[row]) continue;
+
+			// Directional lights and lights that never fade below the cutoff reach everything
+			const float range = lights.param1[row].x == DIRECTIONAL_LIGHT_TYPE ? -1.0f : lightInfluenceRange(lights.attenuation[row], cutoff);
+			if (range == 0.0f) continue;
+			if (range > 0.0f && frustum) {
+				const Math::Vec3<float> centre{ lights.position[row].x, lights.position[row].y, lights.position[row].z };
+				if (!frustum->intersectsSphere(centre, range)) continue;
+			}
+			pack(world, slot++, row);
+		}
+
+		packed.resize(slot);
+		packedVersions.resize(slot);
+		stats.activeLights = static_cast<uint32_t>(slot);
+		stats.culledLights = static_cast<uint32_t>(lights.size() - slot);
+	}
+
+	void LightRenderer::updateLightUniforms(const unsigned int program, const RenderWorld& world) {
+		const size_t count = packed.size();
+		ProgramLights& uploaded = programs[program];
+
+		const LightCache& cache = uniforms.getLightCache();
+		if (cache.getLightCountLocation() != -1 && uploaded.count != static_cast<int>(count)) {
+			glUniform1i(cache.getLightCountLocation(), static_cast<int>(count));
+			uploaded.count = static_cast<int>(count);
+			++stats.uniformUploads;
+		}
+
+		if (cache.getAmbientLightLocation() != -1 && (!uploaded.hasAmbient || !sameVec4(uploaded.ambient, world.ambient))) {
+			glUniform4fv(cache.getAmbientLightLocation(), 1, &world.ambient.x);
+			uploaded.ambient = world.ambient;
+			uploaded.hasAmbient = true;
+			++stats.uniformUploads;
+		}
+
+		if (ubo != 0 && cache.getLightBlockIndex() != LightCache::NO_BLOCK) {
+			if (!uploaded.blockBound) {
+				glUniformBlockBinding(program, cache.getLightBlockIndex(), uboBinding);
+				uploaded.blockBound = true;
+			}
+			uploadBuffer(count);
+			return;
+		}
+		uploadUniforms(uploaded, count);
+	}
+
+	void LightRenderer::uploadUniforms(ProgramLights& uploaded, const size_t count) {
+		const LightCache& cache = uniforms.getLightCache();
+		const size_t slots = std::min(count, cache.getLightSlots());
+		uploaded.versions.resize(slots, 0);
+
+		for (size_t i = 0; i < slots; ++i) {
+			if (uploaded.versions[i] == packedVersions[i]) continue;
+			uploaded.versions[i] = packedVersions[i];
+			++stats.lightsUploaded;
+
+			const LightUL& ul = cache.getLightUL(i);
+			const LightStd140& light = packed[i];
+			if (light.param2.x == 0.0f) {
+				if (ul.param2_UL != -1) {
+					glUniform4fv(ul.param2_UL, 1, &light.param2.x);
+					++stats.uniformUploads;
+				}
 				continue;
 			}
 
-			const Scene::TransformComponent& transform = scene.getComponent<Scene::TransformComponent>(entity);
-			const Scene::ColourComponent& colour = scene.getComponent<Scene::ColourComponent>(entity);
-			if (pos_UL != -1)    glUniform4f(pos_UL, transform.pos.x, transform.pos.y, transform.pos.z, 1.0f);
-			if (diff_UL != -1)   glUniform4fv(diff_UL, 1, &colour.colour.r);
-			if (atten_UL != -1)  glUniform4fv(atten_UL, 1, &light->attenuation.r);
-			if (dir_UL != -1)    glUniform4f(dir_UL, transform.rot.r, transform.rot.g, transform.rot.b, 1.0f);
-			if (param1_UL != -1) glUniform4f(param1_UL, static_cast<float>(light->type), light->param1.x, light->param1.y, 0.0f);
-			if (param2_UL != -1) glUniform4f(param2_UL, light->enabled ? 1.0f : 0.0f, 0.0f, 0.0f, 0.0f);
-			++lightIndex;
+			if (ul.position_UL != -1)    glUniform4fv(ul.position_UL, 1, &light.position.x);
+			if (ul.diffuse_UL != -1)     glUniform4fv(ul.diffuse_UL, 1, &light.diffuse.x);
+			if (ul.attenuation_UL != -1) glUniform4fv(ul.attenuation_UL, 1, &light.attenuation.x);
+			if (ul.direction_UL != -1)   glUniform4fv(ul.direction_UL, 1, &light.direction.x);
+			if (ul.param1_UL != -1)      glUniform4fv(ul.param1_UL, 1, &light.param1.x);
+			if (ul.param2_UL != -1)      glUniform4fv(ul.param2_UL, 1, &light.param2.x);
+			for (const int location : { ul.position_UL, ul.diffuse_UL, ul.attenuation_UL, ul.direction_UL, ul.param1_UL, ul.param2_UL })
+				if (location != -1) ++stats.uniformUploads;
 		}
 	}
 
-	void LightRenderer::updateLightCount(int count) const {
-		const unsigned int location = uniforms.getLightCache().getLightCountLocation();
-		if (location != -1) glUniform1i(location, count);
+	void LightRenderer::uploadBuffer(const size_t count) {
+		const size_t slots = std::min<size_t>(count, LightCache::MAX_LIGHTS);
+
+		// Runs of changed slots become one glBufferSubData each, already current slots end a run
+		size_t i = 0;
+		while (i < slots) {
+			if (uboVersions[i] == packedVersions[i]) {
+				++i;
+				continue;
+			}
+
+			const size_t first = i;
+			while (i < slots && uboVersions[i] != packedVersions[i]) {
+				uboVersions[i] = packedVersions[i];
+				++i;
+			}
+
+			state.bindBuffer(GL_UNIFORM_BUFFER, ubo);
+			glBufferSubData(GL_UNIFORM_BUFFER, first * sizeof(LightStd140), (i - first) * sizeof(LightStd140), &packed[first]);
+			stats.lightsUploaded += static_cast<uint32_t>(i - first);
+			++stats.uniformUploads;
+		}
 	}
 }
\ No newline at end of file
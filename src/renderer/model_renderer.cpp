@@ -3,169 +3,272 @@
 
 #include "starlet-graphics/uniform/uniform_cache.hpp"
 #include "starlet-graphics/manager/resource_manager.hpp"
-
-#include "starlet-scene/scene.hpp"
-#include "starlet-scene/component/model.hpp"
-#include "starlet-scene/component/transform.hpp"
-#include "starlet-scene/component/colour.hpp"
+#include "starlet-graphics/renderer/program_variants.hpp"
+#include "starlet-graphics/manager/gl_state_manager.hpp"
+#include "starlet-graphics/renderer/frame_stats.hpp"
+#include "starlet-graphics/jobs/job_system.hpp"
+#include "starlet-graphics/renderer/render_world.hpp"
+#include "starlet-graphics/renderer/camera_view.hpp"
+#include "starlet-graphics/culling/software_occlusion.hpp"
 
 #include "starlet-math/mat4.hpp"
 
 #include <glad/glad.h>
 
-namespace Starlet::Graphics {
-	void ModelRenderer::bindSkyboxTexture(unsigned int textureID) const {
-		glActiveTexture(GL_TEXTURE0 + SKYBOX_TU);
-		glBindTexture(GL_TEXTURE_CUBE_MAP, textureID);
-	}
-
-	void ModelRenderer::updateModelUniforms(const Scene::Model& instance, const MeshCPU& data, const Scene::TransformComponent& transform, const Scene::ColourComponent& colour) const {
-		const ModelUL& modelUL = uniforms.getModelCache().getModelUL();
-
-		const Math::Mat4 modelMat = Math::Mat4::modelMatrix({ { transform.pos, 0.0f }, transform.rot, transform.size });
-		glUniformMatrix4fv(modelUL.model, 1, GL_FALSE, modelMat.models);
-		glUniformMatrix4fv(modelUL.modelInverseTranspose, 1, GL_FALSE, modelMat.inverse().transpose().models);
+#include <algorithm>
+#include <cmath>
+#include <cstring>
 
-		glUniform4fv(modelUL.colourOverride, 1, &colour.colour.x);
-		glUniform4fv(modelUL.specular, 1, &colour.specular.x);
-
-		glUniform1i(modelUL.hasVertexColour, data.hasColours ? 1 : 0);
-		glUniform2f(modelUL.yMinMax, data.minY, data.maxY);
-
-		glUniform1i(modelUL.useTextures, instance.useTextures ? 1 : 0);
-		glUniform1i(modelUL.colourMode, static_cast<int>(instance.mode));
+namespace Starlet::Graphics {
+	namespace {
+		// Sort keys put the ordering value in the high half and the queue position in the low half,
+		// so a plain std::sort keeps equal values in submission order without stable_sort's scratch buffer
+		uint64_t sortKey(const uint32_t order, const size_t index) {
+			return static_cast<uint64_t>(order) << 32 | static_cast<uint32_t>(index);
+		}
+		uint32_t sortIndex(const uint64_t key) {
+			return static_cast<uint32_t>(key);
+		}
 
-		float r = 0.0f, g = 0.0f, b = 0.0f;
-		int i = 0;
-		for (unsigned char c : instance.name) {
-			if (i % 3 == 0) r += static_cast<float>(c);
-			else if (i % 3 == 1) g += static_cast<float>(c);
-			else b += static_cast<float>(c);
-			++i;
+		// Non-negative floats order like their bit patterns, inverted so the farthest sorts first
+		uint32_t farFirst(const float distanceSq) {
+			uint32_t bits;
+			std::memcpy(&bits, &distanceSq, sizeof(bits));
+			return ~bits;
 		}
-		r = std::fmod(r / 255.0f, 1.0f);
-		g = std::fmod(g / 255.0f, 1.0f);
-		b = std::fmod(b / 255.0f, 1.0f);
-		glUniform3f(modelUL.seed, r, g, b);
 	}
-	void ModelRenderer::setModelIsSkybox(bool isSkybox) const {
-		glUniform1i(uniforms.getModelCache().getModelUL().isSkybox, isSkybox ? 1 : 0);
-	}
-
-	bool ModelRenderer::drawModel(const Scene::Model& instance, const Scene::TransformComponent& transform, const Scene::ColourComponent& colour) const {
-		if (!instance.isVisible) return true;
 
-		const MeshCPU* cpuMesh = resourceManager.getMeshCPU(instance.meshHandle);
-		if (!cpuMesh) 
-			return Logger::error("ModelRenderer", "drawModel", "Invalid CPU mesh handle for: " + instance.meshPath);
+	uint32_t ModelRenderer::variantMask(const bool isLit, const bool useTextures, const bool hasVertexColour, const int colourMode) {
+		uint32_t mask = 0;
+		if (isLit) mask |= MODEL_VARIANT_LIT;
+		if (useTextures) mask |= MODEL_VARIANT_TEXTURED;
+		if (hasVertexColour) mask |= MODEL_VARIANT_VERTEX_COLOUR;
+		mask |= (static_cast<uint32_t>(colourMode) & ((1u << MODEL_VARIANT_COLOUR_MODE_BITS) - 1u)) << MODEL_VARIANT_COLOUR_MODE_SHIFT;
+		return mask;
+	}
 
-		const MeshGPU* gpuMesh = resourceManager.getMeshGPU(instance.meshHandle);
-		if (!gpuMesh) 
-			return Logger::error("ModelRenderer", "drawModel", "Invalid GPU mesh handle for: " + instance.meshPath);
+	bool ModelRenderer::skipDraw(const DrawError error, const std::string_view name) const {
+		errors.add(error, name);
+		++stats.invalidDraws;
+		return false;
+	}
 
-		updateModelUniforms(instance, *cpuMesh, transform, colour);
-		const ModelUL& modelUL = uniforms.getModelCache().getModelUL();
+	void ModelRenderer::setLodSelection(const bool enabled, const float threshold, const float hysteresis) {
+		lodEnabled = enabled;
+		lodThreshold = threshold;
+		lodHysteresis = hysteresis;
+	}
 
-		if (instance.useTextures) {
-			glUniform4f(modelUL.texMixRatios, instance.textureMixRatio[0], instance.textureMixRatio[1], instance.textureMixRatio[2], instance.textureMixRatio[3]);
+	uint8_t ModelRenderer::selectLod(const std::vector<MeshLod>& lods, const float screenScale, const uint8_t current) const {
+		auto coarsest = [&](const float threshold) {
+			uint8_t level = 0;
+			for (size_t i = 1; i < lods.size(); ++i)
+				if (lods[i].error * screenScale <= threshold) level = static_cast<uint8_t>(i);
+			return level;
+		};
+
+		const uint8_t coarser = coarsest(lodThreshold * (1.0f - lodHysteresis));
+		if (current < lods.size() && lods[current].error * screenScale <= lodThreshold * (1.0f + lodHysteresis))
+			return std::max(current, coarser);
+		return coarsest(lodThreshold);
+	}
 
-			for (size_t i = 0; i < instance.NUM_TEXTURES; ++i) {
-				const std::string& name = instance.textureNames[i];
-				if (name.empty()) continue;
+	void ModelRenderer::prepareModel(const RenderModels& models, const size_t row, const ViewFrustum& frustum, DrawPacketBuffer& out) {
+		const uint8_t flags = models.flags[row];
+		if (!(flags & RENDER_MODEL_VISIBLE)) {
+			++out.culled;
+			return;
+		}
 
-				unsigned int textureID = resourceManager.getTextureID(instance.textureHandles[i]);
-				if (textureID == 0) 
-					return Logger::error("ModelRenderer", "drawModel", "Invalid texture handle for slot " + std::to_string(i) + " in model: " + instance.name);
+		const MeshInfo* meshInfo = resourceManager.getMeshInfo(models.mesh[row]);
+		const MeshGPU* gpuMesh = resourceManager.getMeshGPU(models.mesh[row]);
+		if (!meshInfo || !gpuMesh) {
+			out.errors.add(DrawError::MissingMesh, models.name[row]);
+			return;
+		}
 
-				glActiveTexture(GL_TEXTURE0 + static_cast<unsigned int>(i));
-				glBindTexture(GL_TEXTURE_2D, textureID);
-			}
+		// boundingRadius is about the mesh origin, so the sphere stays at the model position under any rotation
+		const Math::Vec3<float>& pos = models.position[row];
+		const Math::Vec3<float>& scale = models.scale[row];
+		const float radius = meshInfo->boundingRadius * std::max({ std::fabs(scale.x), std::fabs(scale.y), std::fabs(scale.z) });
+		if (meshInfo->hasBounds && !frustum.intersectsSphere(pos, radius)) {
+			++out.culled;
+			return;
 		}
 
-		glUniform1i(modelUL.isLit, instance.isLighted ? 1 : 0);
+		const Math::Mat4 model = Math::Mat4::modelMatrix({ { pos, 0.0f }, models.rotation[row], scale });
+		if (occlusion && meshInfo->hasBounds && !occlusion->isVisible(meshInfo->boundsMin, meshInfo->boundsMax, model)) {
+			++out.occluded;
+			return;
+		}
 
-		if (colour.colour.w < 1.0f)	glDepthMask(GL_FALSE);
-		glBindVertexArray(gpuMesh->VAOID);
-		glDrawElements(GL_TRIANGLES, gpuMesh->numIndices, GL_UNSIGNED_INT, 0);
-		glBindVertexArray(0);
-		if (colour.colour.w < 1.0f) glDepthMask(GL_TRUE);
+		const Math::Vec4<float>& colour = models.colour[row];
+		const bool transparent = colour.w < 1.0f;
+		DrawPacket& packet = transparent ? out.transparent.emplace_back() : out.opaque.emplace_back();
+
+		packet.model = model;
+		packet.modelInverseTranspose = packet.model.inverse().transpose();
+		packet.colour = colour;
+		packet.specular = models.specular[row];
+		packet.yMin = meshInfo->minY;
+		packet.yMax = meshInfo->maxY;
+
+		const Math::Vec3<float>& eye = frustum.view.eye;
+		const float dx = pos.x - eye.x, dy = pos.y - eye.y, dz = pos.z - eye.z;
+		packet.distanceSq = dx * dx + dy * dy + dz * dz;
+		std::memcpy(packet.seed, models.seed[row].data(), sizeof(packet.seed));
+
+		packet.row = static_cast<uint32_t>(row);
+		packet.vao = gpuMesh->VAOID;
+		packet.depthVao = gpuMesh->DepthVAOID;
+		packet.numIndices = gpuMesh->numIndices;
+		packet.numVertices = gpuMesh->numVertices;
+
+		if (lodEnabled && !gpuMesh->lods.empty()) {
+			// Error is relative to the mesh radius, scaled by the largest axis and projected to a fraction of screen height
+			const float distance = std::max(std::sqrt(packet.distanceSq), frustum.nearPlane);
+			const float screenScale = radius / (2.0f * distance * frustum.tanHalfY);
+
+			const uint8_t level = selectLod(gpuMesh->lods, screenScale, lodLevels[row]);
+			lodLevels[row] = level;
+			packet.firstIndex = gpuMesh->lods[level].firstIndex;
+			packet.numIndices = gpuMesh->lods[level].numIndices;
+			out.lodTrianglesSaved += (gpuMesh->numIndices - packet.numIndices) / 3;
+		}
 
-		return true;
+		packet.colourMode = models.colourMode[row];
+		packet.hasVertexColour = meshInfo->hasColours;
+		packet.useTextures = (flags & RENDER_MODEL_TEXTURED) != 0;
+		packet.isLit = (flags & RENDER_MODEL_LIT) != 0;
+		packet.variantMask = variantMask(packet.isLit, packet.useTextures, packet.hasVertexColour, packet.colourMode);
+
+		if (!packet.useTextures) return;
+		for (unsigned int slot = 0; slot < DRAW_PACKET_TEXTURES; ++slot) {
+			packet.texMixRatios[slot] = models.textureMix[row][slot];
+			if (!models.textures[row][slot].isValid()) continue;
+
+			packet.textures[slot] = resourceManager.getTextureID(models.textures[row][slot]);
+			if (packet.textures[slot] == 0 && packet.valid) {
+				packet.valid = false;
+				out.errors.add(DrawError::MissingTexture, models.name[row]);
+			}
+		}
 	}
-	bool ModelRenderer::drawOpaqueModels(const Scene::Scene& scene, const Math::Vec3<float>& eye) const {
-		for (const auto& [entity, model] : scene.getEntitiesOfType<Scene::Model>()) {
-			if (model->name == "skybox") continue;
 
-			if (!scene.hasComponent<Scene::TransformComponent>(entity)) continue;
-			const Scene::TransformComponent& transform = scene.getComponent<Scene::TransformComponent>(entity);
+	void ModelRenderer::prepareModels(const RenderWorld& world, const ViewFrustum& frustum, JobSystem* jobs) {
+		frameModels = &world.models;
+
+		// One buffer per slice rather than per worker, so the merge below is in scene order whoever ran each slice
+		const uint32_t count = static_cast<uint32_t>(world.models.size());
+		const size_t slices = std::max<size_t>(1, (count + PREPARE_GRAIN - 1) / PREPARE_GRAIN);
+		if (buffers.size() < slices) buffers.resize(slices);
+		for (DrawPacketBuffer& buffer : buffers) buffer.clear();
+		lodLevels.resize(count, 0);
+
+		auto prepareRange = [&](const uint32_t begin, const uint32_t end) {
+			for (uint32_t first = begin; first < end; first += PREPARE_GRAIN) {
+				DrawPacketBuffer& out = buffers[first / PREPARE_GRAIN];
+				const uint32_t last = std::min(end, first + PREPARE_GRAIN);
+				for (uint32_t i = first; i < last; ++i) prepareModel(world.models, i, frustum, out);
+			}
+		};
 
-			if (scene.hasComponent<Scene::ColourComponent>(entity)) {
-				const Scene::ColourComponent& colour = scene.getComponent<Scene::ColourComponent>(entity);
+		if (jobs) jobs->parallelFor(count, PREPARE_GRAIN, prepareRange);
+		else prepareRange(0, count);
 
-				if (colour.colour.w < 1.0f) continue;
-				if (!drawModel(*model, transform, colour))
-					return Logger::error("Renderer", "drawModels", "Failed to draw opaque model");
-			}
-			else if (!drawModel(*model, transform, {}))
-				return Logger::error("Renderer", "drawModels", "Failed to draw opaque model");
+		opaqueQueue.clear();
+		transparentQueue.clear();
+		size_t opaqueCount = 0, transparentCount = 0;
+		for (const DrawPacketBuffer& buffer : buffers) {
+			opaqueCount += buffer.opaque.size();
+			transparentCount += buffer.transparent.size();
+		}
+		opaqueQueue.reserve(opaqueCount);
+		transparentQueue.reserve(transparentCount);
+
+		for (DrawPacketBuffer& buffer : buffers) {
+			opaqueQueue.insert(opaqueQueue.end(), buffer.opaque.begin(), buffer.opaque.end());
+			transparentQueue.insert(transparentQueue.end(), buffer.transparent.begin(), buffer.transparent.end());
+			stats.culledModels += buffer.culled;
+			stats.occludedModels += buffer.occluded;
+			stats.lodTrianglesSaved += buffer.lodTrianglesSaved;
+			stats.invalidDraws += buffer.errors.total();
+			errors.merge(buffer.errors);
 		}
 
-		return true;
-	}
-
-	bool ModelRenderer::drawTransparentModels(const Scene::Scene& scene, const Math::Vec3<float>& eye) const {
-		std::vector<std::tuple<const Scene::Model*, const Scene::TransformComponent*, const Scene::ColourComponent*>> transparentInstances;
+		// Group opaque draws by variant so each specialised program is bound once, packets stay put and only keys move
+		opaqueOrder.resize(opaqueQueue.size());
+		for (size_t i = 0; i < opaqueQueue.size(); ++i) opaqueOrder[i] = sortKey(variants.isEnabled() ? opaqueQueue[i].variantMask : 0u, i);
+		std::sort(opaqueOrder.begin(), opaqueOrder.end());
 
-		for (const auto& [entity, model] : scene.getEntitiesOfType<Scene::Model>()) {
-			if (model->name == "skybox") continue;
+		transparentOrder.resize(transparentQueue.size());
+		for (size_t i = 0; i < transparentQueue.size(); ++i) transparentOrder[i] = sortKey(farFirst(transparentQueue[i].distanceSq), i);
+		std::sort(transparentOrder.begin(), transparentOrder.end());
+	}
 
-			if (!scene.hasComponent<Scene::TransformComponent>(entity)) continue;
-			const Scene::TransformComponent& transform = scene.getComponent<Scene::TransformComponent>(entity);
+	void ModelRenderer::releaseFrame() {
+		// Swapping in empty vectors forgets the arena storage without touching it
+		std::pmr::vector<DrawPacket>(&frameMemory).swap(opaqueQueue);
+		std::pmr::vector<DrawPacket>(&frameMemory).swap(transparentQueue);
+		std::pmr::vector<uint64_t>(&frameMemory).swap(opaqueOrder);
+		std::pmr::vector<uint64_t>(&frameMemory).swap(transparentOrder);
+	}
 
-			if (scene.hasComponent<Scene::ColourComponent>(entity)) {
-				const Scene::ColourComponent& colour = scene.getComponent<Scene::ColourComponent>(entity);
+	bool ModelRenderer::submitPacket(const DrawPacket& packet, const bool writeDepth) {
+		// Invalid packets were counted when prepared
+		if (!packet.valid) return false;
+		if (variants.isEnabled() && !variants.select(packet.variantMask))
+			return skipDraw(DrawError::MissingVariant, frameModels ? std::string_view(frameModels->name[packet.row]) : std::string_view());
 
-				if (colour.colour.w < 1.0f)
-					transparentInstances.push_back({ model, &transform, &colour });
-			}
+		const ModelUL& modelUL = uniforms.getModelCache().getModelUL();
+		glUniformMatrix4fv(modelUL.model, 1, GL_FALSE, packet.model.models);
+		glUniformMatrix4fv(modelUL.modelInverseTranspose, 1, GL_FALSE, packet.modelInverseTranspose.models);
+		glUniform4fv(modelUL.colourOverride, 1, &packet.colour.x);
+		glUniform4fv(modelUL.specular, 1, &packet.specular.x);
+		glUniform2f(modelUL.yMinMax, packet.yMin, packet.yMax);
+		glUniform3f(modelUL.seed, packet.seed[0], packet.seed[1], packet.seed[2]);
+		stats.uniformUploads += 6;
+
+		// Specialised programs have these flags compiled in
+		if (!variants.isEnabled()) {
+			glUniform1i(modelUL.hasVertexColour, packet.hasVertexColour ? 1 : 0);
+			glUniform1i(modelUL.useTextures, packet.useTextures ? 1 : 0);
+			glUniform1i(modelUL.colourMode, packet.colourMode);
+			glUniform1i(modelUL.isLit, packet.isLit ? 1 : 0);
+			stats.uniformUploads += 4;
 		}
 
-		for (size_t i = 0; i < transparentInstances.size(); ++i) {
-			for (size_t j = 0; j < transparentInstances.size() - i - 1; ++j) {
-				const Math::Vec3<float>& a = std::get<1>(transparentInstances[j])->pos;
-				const Math::Vec3<float>& b = std::get<1>(transparentInstances[j + 1])->pos;
-				float distA = (a.x - eye.x) * (a.x - eye.x) + (a.y - eye.y) * (a.y - eye.y) + (a.z - eye.z) * (a.z - eye.z);
-				float distB = (b.x - eye.x) * (b.x - eye.x) + (b.y - eye.y) * (b.y - eye.y) + (b.z - eye.z) * (b.z - eye.z);
-				if (distA < distB) {
-					std::tuple<const Scene::Model*, const Scene::TransformComponent*, const Scene::ColourComponent*> temp = transparentInstances[j];
-					transparentInstances[j] = transparentInstances[j + 1];
-					transparentInstances[j + 1] = temp;
-				}
+		if (packet.useTextures) {
+			glUniform4fv(modelUL.texMixRatios, 1, packet.texMixRatios);
+			++stats.uniformUploads;
+
+			for (unsigned int slot = 0; slot < DRAW_PACKET_TEXTURES; ++slot) {
+				if (packet.textures[slot] == 0) continue;
+				resourceManager.markTextureUsed(packet.textures[slot]);
+				state.bindTexture(slot, GL_TEXTURE_2D, packet.textures[slot]);
 			}
 		}
 
-		for (const auto& [model, transform, colour] : transparentInstances)
-			if (!drawModel(*model, *transform, *colour))
-				return Logger::error("Renderer", "drawModels", "Failed to draw transparent model");
-
+		state.setDepthMask(writeDepth && packet.colour.w >= 1.0f);
+		state.setCulling(true);
+		state.setCullFace(GL_BACK);
+		state.bindVertexArray(packet.vao);
+		glDrawElements(GL_TRIANGLES, packet.numIndices, GL_UNSIGNED_INT, reinterpret_cast<const void*>(static_cast<uintptr_t>(packet.firstIndex) * sizeof(unsigned int)));
+		++stats.drawCalls;
+		stats.triangles += packet.numIndices / 3;
+		stats.vertices += packet.numVertices;
 		return true;
 	}
-	bool ModelRenderer::drawSkybox(const Scene::Model& skybox, const Math::Vec3<float>& skyboxSize, const Math::Vec3<float>& cameraPos) const {
-		glEnable(GL_CULL_FACE);
-		glCullFace(GL_FRONT);
-		glDepthMask(GL_FALSE);
-		Scene::Model tempSkybox = skybox;
-		tempSkybox.isVisible = true;
-		setModelIsSkybox(true);
-
-		if (skybox.textureHandles[0].isValid())
-			bindSkyboxTexture(resourceManager.getTextureID(skybox.textureHandles[0]));
-		else return Logger::error("ModelRenderer", "drawSkybox", "Skybox has no valid texture handle");
-
-		drawModel(tempSkybox, { cameraPos, { 0.0f, 0.0f, 0.0f }, skyboxSize }, {});
-		setModelIsSkybox(false);
-		glDepthMask(GL_TRUE);
-		glCullFace(GL_BACK);
-		return true;
+
+	bool ModelRenderer::submitOpaque(const bool depthPrepassed) {
+		bool ok = true;
+		for (const uint64_t key : opaqueOrder) ok = submitPacket(opaqueQueue[sortIndex(key)], !depthPrepassed) && ok;
+		return ok;
+	}
+
+	bool ModelRenderer::submitTransparent() {
+		bool ok = true;
+		for (const uint64_t key : transparentOrder) ok = submitPacket(transparentQueue[sortIndex(key)], false) && ok;
+		return ok;
 	}
 }
\ No newline at end of file
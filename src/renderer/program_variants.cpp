@@ -0,0 +1,70 @@
+#include "starlet-graphics/renderer/program_variants.hpp"
+#include "starlet-logger/logger.hpp"
+
+#include "starlet-graphics/manager/shader_manager.hpp"
+#include "starlet-graphics/uniform/uniform_cache.hpp"
+#include "starlet-graphics/manager/gl_state_manager.hpp"
+
+namespace Starlet::Graphics {
+	const std::vector<VariantDefine>& ProgramVariants::getModelDefines() {
+		static const std::vector<VariantDefine> defines{
+			{ "IS_LIT", 1 },
+			{ "USE_TEXTURES", 1 },
+			{ "HAS_VERTEX_COLOUR", 1 },
+			{ "COLOUR_MODE", MODEL_VARIANT_COLOUR_MODE_BITS },
+		};
+		return defines;
+	}
+
+	void ProgramVariants::enable(ShaderManager& sm, const std::string& programName, PrepareProgram prepareProgram) {
+		shaderManager = &sm;
+		name = programName;
+		prepare = std::move(prepareProgram);
+		currentProgram = 0;
+		maskToProgram.clear();
+		preparedFrame.clear();
+	}
+
+	void ProgramVariants::disable() {
+		shaderManager = nullptr;
+		prepare = nullptr;
+		currentProgram = 0;
+		maskToProgram.clear();
+		preparedFrame.clear();
+	}
+
+	void ProgramVariants::beginFrame() {
+		++frame;
+		currentProgram = 0;
+		switches = 0;
+	}
+
+	bool ProgramVariants::select(const uint32_t mask) {
+		if (!shaderManager) return false;
+
+		unsigned int program = 0;
+		std::unordered_map<uint32_t, unsigned int>::const_iterator it = maskToProgram.find(mask);
+		if (it != maskToProgram.end()) program = it->second;
+		else {
+			program = shaderManager->getVariantProgramID(name, mask);
+			maskToProgram[mask] = program;
+		}
+
+		if (program == 0) return false;
+		if (program == currentProgram) return true;
+
+		state.setProgram(program);
+		if (!uniforms.switchProgram(program, true))
+			Logger::error("ProgramVariants", "select", "Incomplete uniform locations for variant " + std::to_string(mask) + " of: " + name);
+
+		currentProgram = program;
+		++switches;
+
+		uint64_t& lastPrepared = preparedFrame[program];
+		if (lastPrepared != frame) {
+			lastPrepared = frame;
+			if (prepare) prepare(program);
+		}
+		return true;
+	}
+}
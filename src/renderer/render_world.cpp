@@ -0,0 +1,242 @@
+#include "starlet-graphics/renderer/render_world.hpp"
+
+#include "starlet-scene/component/light.hpp"
+#include "starlet-scene/component/camera.hpp"
+#include "starlet-scene/component/transform.hpp"
+#include "starlet-scene/component/colour.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace Starlet::Graphics {
+	namespace {
+		bool same(const Math::Vec3<float>& a, const Math::Vec3<float>& b) { return a.x == b.x && a.y == b.y && a.z == b.z; }
+		bool same(const Math::Vec4<float>& a, const Math::Vec4<float>& b) { return a.x == b.x && a.y == b.y && a.z == b.z && a.w == b.w; }
+
+		// Assigns and reports whether the value differed
+		template <typename T, typename Compare>
+		bool assign(T& dst, const T& src, Compare equal) {
+			if (equal(dst, src)) return false;
+			dst = src;
+			return true;
+		}
+		template <typename T>
+		bool assign(T& dst, const T& src) {
+			if (dst == src) return false;
+			dst = src;
+			return true;
+		}
+
+		const auto sameVec3 = [](const Math::Vec3<float>& a, const Math::Vec3<float>& b) { return same(a, b); };
+		const auto sameVec4 = [](const Math::Vec4<float>& a, const Math::Vec4<float>& b) { return same(a, b); };
+	}
+
+	void RenderModels::resize(const size_t count) {
+		entity.resize(count);
+		position.resize(count);
+		rotation.resize(count);
+		scale.resize(count);
+		colour.resize(count);
+		specular.resize(count);
+		mesh.resize(count);
+		textures.resize(count);
+		textureMix.resize(count);
+		seed.resize(count);
+		flags.resize(count, 0);
+		colourMode.resize(count, 0);
+		version.resize(count, 0);
+		name.resize(count);
+		nameVersion.resize(count, 0);
+	}
+
+	void RenderModels::copyRow(const RenderModels& other, const size_t row) {
+		entity[row] = other.entity[row];
+		position[row] = other.position[row];
+		rotation[row] = other.rotation[row];
+		scale[row] = other.scale[row];
+		colour[row] = other.colour[row];
+		specular[row] = other.specular[row];
+		mesh[row] = other.mesh[row];
+		textures[row] = other.textures[row];
+		textureMix[row] = other.textureMix[row];
+		seed[row] = other.seed[row];
+		flags[row] = other.flags[row];
+		colourMode[row] = other.colourMode[row];
+		version[row] = other.version[row];
+
+		if (nameVersion[row] != other.nameVersion[row]) {
+			name[row] = other.name[row];
+			nameVersion[row] = other.nameVersion[row];
+		}
+	}
+
+	void RenderLights::resize(const size_t count) {
+		position.resize(count);
+		direction.resize(count);
+		diffuse.resize(count);
+		attenuation.resize(count);
+		param1.resize(count);
+		active.resize(count, 0);
+		version.resize(count, 0);
+	}
+
+	void RenderLights::copyRow(const RenderLights& other, const size_t row) {
+		position[row] = other.position[row];
+		direction[row] = other.direction[row];
+		diffuse[row] = other.diffuse[row];
+		attenuation[row] = other.attenuation[row];
+		param1[row] = other.param1[row];
+		active[row] = other.active[row];
+		version[row] = other.version[row];
+	}
+
+	bool RenderWorldExtractor::extractModel(const size_t row, const Scene::Entity entity, const Scene::Model& model, const Scene::Scene& scene, const bool checkName) {
+		RenderModels& models = latest.models;
+		const Scene::TransformComponent& transform = scene.getComponent<Scene::TransformComponent>(entity);
+
+		const Scene::ColourComponent defaultColour{};
+		const Scene::ColourComponent& colour = scene.hasComponent<Scene::ColourComponent>(entity)
+			? scene.getComponent<Scene::ColourComponent>(entity) : defaultColour;
+
+		uint8_t flags = 0;
+		if (model.isVisible) flags |= RENDER_MODEL_VISIBLE;
+		if (model.isLighted) flags |= RENDER_MODEL_LIT;
+		if (model.useTextures) flags |= RENDER_MODEL_TEXTURED;
+
+		std::array<ResourceHandle, DRAW_PACKET_TEXTURES> textures{};
+		std::array<float, DRAW_PACKET_TEXTURES> textureMix{};
+		for (unsigned int slot = 0; slot < DRAW_PACKET_TEXTURES && slot < model.NUM_TEXTURES; ++slot) {
+			textureMix[slot] = model.textureMixRatio[slot];
+			if (!model.textureNames[slot].empty()) textures[slot] = model.textureHandles[slot];
+		}
+
+		const bool newEntity = assign(models.entity[row], entity);
+		bool changed = newEntity;
+		changed |= assign(models.position[row], transform.pos, sameVec3);
+		changed |= assign(models.rotation[row], transform.rot, sameVec3);
+		changed |= assign(models.scale[row], transform.size, sameVec3);
+		changed |= assign(models.colour[row], colour.colour, sameVec4);
+		changed |= assign(models.specular[row], colour.specular, sameVec4);
+		changed |= assign(models.flags[row], flags);
+		changed |= assign(models.colourMode[row], static_cast<uint8_t>(model.mode));
+		changed |= assign(models.mesh[row], model.meshHandle, [](const ResourceHandle& a, const ResourceHandle& b) { return a.id == b.id; });
+		changed |= assign(models.textures[row], textures, [](const auto& a, const auto& b) {
+			for (size_t i = 0; i < a.size(); ++i) if (a[i].id != b[i].id) return false;
+			return true;
+		});
+		changed |= assign(models.textureMix[row], textureMix);
+
+		// The seed is derived from the name, so it only needs recomputing when the name changes
+		bool renamed = false;
+		if ((checkName || newEntity) && models.name[row] != model.name) {
+			models.name[row] = model.name;
+			float seed[3]{ 0.0f, 0.0f, 0.0f };
+			int i = 0;
+			for (unsigned char c : model.name) seed[i++ % 3] += static_cast<float>(c);
+			for (int channel = 0; channel < 3; ++channel) models.seed[row][channel] = std::fmod(seed[channel] / 255.0f, 1.0f);
+			changed = renamed = true;
+		}
+
+		if (changed) models.version[row] = ++version;
+		if (renamed) models.nameVersion[row] = version;
+		return changed;
+	}
+
+	bool RenderWorldExtractor::extractLight(const size_t row, const Scene::Entity entity, const Scene::Scene& scene) {
+		RenderLights& lights = latest.lights;
+		const Scene::Light& light = scene.getComponent<Scene::Light>(entity);
+
+		const bool hasTransform = scene.hasComponent<Scene::TransformComponent>(entity);
+		const uint8_t active = (light.enabled && hasTransform) ? 1 : 0;
+
+		bool changed = assign(lights.active[row], active);
+		if (active) {
+			const Scene::TransformComponent& transform = scene.getComponent<Scene::TransformComponent>(entity);
+			const Scene::ColourComponent defaultColour{};
+			const Scene::ColourComponent& colour = scene.hasComponent<Scene::ColourComponent>(entity)
+				? scene.getComponent<Scene::ColourComponent>(entity) : defaultColour;
+
+			changed |= assign(lights.position[row], Math::Vec4<float>(transform.pos, 1.0f), sameVec4);
+			changed |= assign(lights.direction[row], Math::Vec4<float>(transform.rot, 1.0f), sameVec4);
+			changed |= assign(lights.diffuse[row], colour.colour, sameVec4);
+			changed |= assign(lights.attenuation[row], light.attenuation, sameVec4);
+			changed |= assign(lights.param1[row], Math::Vec4<float>(static_cast<float>(light.type), light.param1.x, light.param1.y, 0.0f), sameVec4);
+		}
+
+		if (changed) lights.version[row] = ++version;
+		return changed;
+	}
+
+	void RenderWorldExtractor::extract(const Scene::Scene& scene, RenderWorld& out) {
+		changedRows = 0;
+
+		// Rows new this frame always compare their name, the rest only inside the round-robin window
+		const size_t previousModels = latest.models.size();
+		const size_t nameChecks = std::min(NAME_CHECKS_PER_FRAME, previousModels);
+		const size_t nameStart = nameCursor < previousModels ? nameCursor : 0;
+
+		size_t row = 0;
+		latest.skybox.valid = false;
+		for (const auto& [entity, model] : scene.getEntitiesOfType<Scene::Model>()) {
+			if (!scene.hasComponent<Scene::TransformComponent>(entity)) continue;
+
+			if (model->name == "skybox") {
+				latest.skybox = { true, model->textureHandles[0] };
+				continue;
+			}
+
+			if (row >= latest.models.size()) latest.models.resize(row + 1);
+			const bool checkName = row >= previousModels || (row + previousModels - nameStart) % previousModels < nameChecks;
+			if (extractModel(row, entity, *model, scene, checkName)) ++changedRows;
+			++row;
+		}
+		latest.models.resize(row);
+		nameCursor = nameStart + nameChecks;
+
+		row = 0;
+		for (const auto& [entity, light] : scene.getEntitiesOfType<Scene::Light>()) {
+			if (row >= latest.lights.size()) latest.lights.resize(row + 1);
+			if (extractLight(row, entity, scene)) ++changedRows;
+			++row;
+		}
+		latest.lights.resize(row);
+
+		latest.camera.valid = false;
+		for (const auto& [entity, camera] : scene.getEntitiesOfType<Scene::Camera>()) {
+			if (!camera->enabled || !scene.hasComponent<Scene::TransformComponent>(entity)) continue;
+
+			const Scene::TransformComponent& transform = scene.getComponent<Scene::TransformComponent>(entity);
+			latest.camera = { true, transform.pos, transform.rot, camera->fov, camera->nearPlane, camera->farPlane };
+			break;
+		}
+		latest.ambient = scene.getAmbientLight();
+
+		// Rows the target already holds at the same version are skipped
+		out.models.resize(latest.models.size());
+		for (size_t i = 0; i < latest.models.size(); ++i)
+			if (out.models.version[i] != latest.models.version[i]) out.models.copyRow(latest.models, i);
+
+		out.lights.resize(latest.lights.size());
+		for (size_t i = 0; i < latest.lights.size(); ++i)
+			if (out.lights.version[i] != latest.lights.version[i]) out.lights.copyRow(latest.lights, i);
+
+		out.camera = latest.camera;
+		out.ambient = latest.ambient;
+		out.skybox = latest.skybox;
+	}
+
+	void RenderWorldBuffer::extract(const Scene::Scene& scene) {
+		RenderWorld& target = worlds[writeIndex];
+		extractor.extract(scene, target);
+		target.frame = ++frame;
+
+		writeIndex = ready.exchange(writeIndex | FRESH, std::memory_order_acq_rel) & ~FRESH;
+	}
+
+	const RenderWorld* RenderWorldBuffer::acquire() {
+		if (ready.load(std::memory_order_acquire) & FRESH)
+			readIndex = ready.exchange(readIndex, std::memory_order_acq_rel) & ~FRESH;
+
+		return worlds[readIndex].frame ? &worlds[readIndex] : nullptr;
+	}
+}
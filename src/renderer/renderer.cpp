@@ -2,6 +2,8 @@
 #include "starlet-graphics/manager/texture_manager.hpp"
 #include "starlet-graphics/manager/mesh_manager.hpp"
 #include "starlet-graphics/manager/shader_manager.hpp"
+#include "starlet-graphics/manager/resource_manager.hpp"
+#include "starlet-graphics/memory/heap_counter.hpp"
 #include "starlet-logger/logger.hpp"
 
 #include "starlet-scene/scene.hpp"
@@ -21,37 +23,208 @@ namespace Starlet::Graphics {
 		if (!uniforms.cacheAllLocations())
 			return Logger::error("Renderer", "init", "Failed to cache uniform locations");
 
+		if (!skyboxRenderer.init())
+			return Logger::error("Renderer", "init", "Failed to create skybox renderer");
+		state.setProgram(program);
+
+		return true;
+	}
+
+	bool Renderer::initVariants(ShaderManager& sm, const std::string& programName) {
+		if (!sm.hasVariantProgram(programName))
+			return Logger::error("Renderer", "initVariants", "No variant program registered as: " + programName);
+
+		variants.enable(sm, programName, [this](unsigned int variantProgram) {
+			// Runs inside the draw passes, so this time is also part of whichever pass selected the variant
+			const FrameStats::Clock::time_point start = FrameStats::Clock::now();
+			cameraRenderer.updateCameraUniforms(frame.eye, frame.view, frame.projection);
+			lightRenderer.updateLightUniforms(variantProgram, *frame.world);
+			stats.lightUpdateMs += FrameStats::msSince(start);
+		});
 		return true;
 	}
 
-	void Renderer::renderFrame(const unsigned int program, const Scene::Scene& scene, const float aspect) const {
+	bool Renderer::enableProfiling(const bool gpuTimers) {
+		profiler.setEnabled(true);
+		if (!gpuTimers) {
+			profiler.shutdownGpu();
+			return true;
+		}
+		return profiler.initGpu();
+	}
+
+	bool Renderer::enableLightClusters(const unsigned int bindingBase) {
+		clustersEnabled = clusters.enableUpload(state, bindingBase);
+		return clustersEnabled;
+	}
+
+	void Renderer::disableLightClusters() {
+		clusters.disableUpload();
+		clustersEnabled = false;
+	}
+
+	bool Renderer::enableDepthPrepass(ShaderManager& sm) {
+		sm.setInvariantPosition(true);
+		prepassShaders = &sm;
+		depthPrepassEnabled = depthPrepass.isReady() || depthPrepass.init(sm);
+		return depthPrepassEnabled;
+	}
+
+	void Renderer::enableOcclusionCulling(const uint32_t width, const uint32_t height) {
+		occlusion.setResolution(width, height);
+		modelRenderer.setOcclusion(&occlusion);
+		occlusionEnabled = true;
+	}
+
+	void Renderer::disableOcclusionCulling() {
+		modelRenderer.setOcclusion(nullptr);
+		occlusionEnabled = false;
+	}
+
+	void Renderer::renderFrame(const unsigned int program, const Scene::Scene& scene, const float aspect) {
+		extractor.extract(scene, sceneWorld);
+		renderFrame(program, sceneWorld, aspect);
+	}
+
+	void Renderer::renderFrame(const unsigned int program, const RenderWorld& world, const float aspect) {
+		const FrameStats::Clock::time_point frameStart = FrameStats::Clock::now();
+		const uint64_t heapBefore = getHeapAllocationCount();
+		stats = {};
+
+		// Last frame's queues point into the arena, drop them before rewinding it
+		modelRenderer.releaseFrame();
+		frameArena.reset();
+
+		resourceManager.flushUploads();
 		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
-		const Scene::Camera* activeCam{};
-		const Scene::TransformComponent* camTransform{};
-		for (auto& [entity, camera] : scene.getEntitiesOfType<Scene::Camera>()) {
-			if (camera->enabled) {
-				activeCam = camera;
-				camTransform = &scene.getComponent<Scene::TransformComponent>(entity);
-				break;
+		// Uploads and application code bind behind the shadow between frames
+		state.invalidate();
+		state.resetStats();
+		state.setProgram(program);
+
+		// Without a camera nothing is drawn, but the end-of-frame bookkeeping below still runs
+		if (world.camera.valid) drawPasses(program, world, aspect);
+
+		state.bindVertexArray(0);
+		state.setDepthMask(true);
+		state.setCullFace(GL_BACK);
+		if (variants.isEnabled() && variants.getCurrentProgram() != program) {
+			state.setProgram(program);
+			uniforms.switchProgram(program, false);
+		}
+		resourceManager.updateTextureStreaming(state);
+
+		stats.textureBinds = state.getStats().textureBinds;
+		stats.vaoBinds = state.getStats().vertexArrayBinds;
+		drawErrors.endFrame();
+		stats.frameArenaBytes = static_cast<uint32_t>(frameArena.getUsed());
+		stats.frameArenaOverflows = frameArena.getOverflowCount();
+		stats.heapAllocations = static_cast<uint32_t>(getHeapAllocationCount() - heapBefore);
+		if (allocationCheck && stats.heapAllocations != 0)
+			Logger::error("Renderer", "renderFrame", "Frame made " + std::to_string(stats.heapAllocations) + " heap allocations");
+
+		stats.frameMs = FrameStats::msSince(frameStart);
+		history.push(stats);
+	}
+
+	void Renderer::drawPasses(const unsigned int program, const RenderWorld& world, const float aspect) {
+		const RenderCamera& camera = world.camera;
+		const CameraView view = CameraView::fromTransform(camera.position, camera.rotation, WORLD_UP);
+		frame.world = &world;
+		frame.eye = view.eye;
+		frame.view = Math::Mat4::lookAt(view.eye, view.front, view.up);
+		frame.projection = Math::Mat4::perspective(camera.fov, aspect, camera.nearPlane, camera.farPlane);
+
+		profiler.beginFrame();
+
+		const ViewFrustum frustum = ViewFrustum::fromView(view, camera.fov, aspect, camera.nearPlane, camera.farPlane);
+		lightRenderer.prepareLights(world, &frustum);
+
+		// With variants each specialised program receives camera and lights when first selected
+		if (variants.isEnabled()) variants.beginFrame();
+		else {
+			ProfileScope scope(profiler, "lights");
+			const FrameStats::Clock::time_point start = FrameStats::Clock::now();
+			cameraRenderer.updateCameraUniforms(frame.eye, frame.view, frame.projection);
+			lightRenderer.updateLightUniforms(program, world);
+			stats.lightUpdateMs = FrameStats::msSince(start);
+		}
+
+		if (clustersEnabled) {
+			ProfileScope scope(profiler, "clusters");
+			const FrameStats::Clock::time_point start = FrameStats::Clock::now();
+			clusters.build(world, view, { camera.fov, aspect, camera.nearPlane, camera.farPlane }, jobs);
+			clusters.upload();
+			stats.lightUpdateMs += FrameStats::msSince(start);
+		}
+
+		if (occlusionEnabled) {
+			ProfileScope scope(profiler, "occlusion");
+			occlusion.beginFrame(frustum);
+			const RenderModels& models = world.models;
+			for (size_t row = 0; row < models.size(); ++row) {
+				if (!(models.flags[row] & RENDER_MODEL_VISIBLE) || !occlusion.hasOccluderMesh(models.mesh[row].id)) continue;
+				occlusion.addOccluder(models.mesh[row].id, Math::Mat4::modelMatrix({ { models.position[row], 0.0f }, models.rotation[row], models.scale[row] }));
 			}
+			occlusion.rasterize(jobs);
+			stats.occluderTriangles = occlusion.getStats().occluderTriangles;
+		}
+
+		{
+			ProfileScope scope(profiler, "prepare");
+			const FrameStats::Clock::time_point start = FrameStats::Clock::now();
+			modelRenderer.prepareModels(world, frustum, jobs);
+			stats.prepareMs = FrameStats::msSince(start);
 		}
 
-		if (!activeCam || !camTransform) return;
+		const bool prepassed = depthPrepassEnabled && !modelRenderer.getOpaqueQueue().empty();
+		if (prepassed) {
+			ProfileScope scope(profiler, "depth prepass");
+			const FrameStats::Clock::time_point start = FrameStats::Clock::now();
+			depthPrepass.draw(modelRenderer.getOpaqueQueue(), frame.view, frame.projection);
 
-		const CameraView view = CameraView::fromTransform(camTransform->pos, camTransform->rot, WORLD_UP);
-		cameraRenderer.updateCameraUniforms(view.eye, Math::Mat4::lookAt(view.eye, view.front, view.up), Math::Mat4::perspective(activeCam->fov, aspect, activeCam->nearPlane, activeCam->farPlane));
-		lightRenderer.updateLightUniforms(program, scene);
+			// Shaded programs were left bound before the pre-pass, rebind them for the opaque pass.
+			// GL_EQUAL needs the shaded program to reproduce the pre-pass depth exactly, which only invariance guarantees.
+			if (variants.isEnabled()) variants.resetCurrent();
+			else state.setProgram(program);
+			const bool invariant = variants.isEnabled()
+				? prepassShaders->hasInvariantVariants(variants.getProgramName())
+				: prepassShaders->hasInvariantPosition(program);
+			state.setDepthFunc(invariant ? GL_EQUAL : GL_LEQUAL);
+			stats.prepassMs = FrameStats::msSince(start);
+		}
 
-		modelRenderer.drawOpaqueModels(scene, view.eye);
-		const Scene::Model* skyBoxModel = scene.getComponentByName<Scene::Model>(std::string("skybox"));
-		const Scene::Entity skyboxEntity = scene.getEntityByName<Scene::Model>("skybox");
-		if (skyBoxModel && skyboxEntity != -1) {
-			const Scene::TransformComponent& skyBoxTransform = scene.getComponent<Scene::TransformComponent>(skyboxEntity);
-			modelRenderer.drawSkybox(*skyBoxModel, skyBoxTransform.size, view.eye);
+		{
+			ProfileScope scope(profiler, "opaque");
+			const FrameStats::Clock::time_point start = FrameStats::Clock::now();
+			modelRenderer.submitOpaque(prepassed);
+			if (prepassed) state.setDepthFunc(GL_LEQUAL);
+			stats.opaqueMs = FrameStats::msSince(start);
 		}
-		modelRenderer.drawTransparentModels(scene, view.eye);
 
-		glBindVertexArray(0);
+		{
+			ProfileScope scope(profiler, "skybox");
+			const FrameStats::Clock::time_point start = FrameStats::Clock::now();
+			if (world.skybox.valid) {
+				if (skyboxRenderer.draw(world.skybox, frame.view, frame.projection)) {
+					if (variants.isEnabled()) variants.resetCurrent();
+					else state.setProgram(program);
+				}
+				else {
+					drawErrors.add(DrawError::MissingTexture, "skybox");
+					++stats.invalidDraws;
+				}
+			}
+			stats.skyboxMs = FrameStats::msSince(start);
+		}
+
+		{
+			ProfileScope scope(profiler, "transparent");
+			const FrameStats::Clock::time_point start = FrameStats::Clock::now();
+			modelRenderer.submitTransparent();
+			stats.transparentMs = FrameStats::msSince(start);
+		}
+		profiler.endFrame();
 	}
 }
\ No newline at end of file
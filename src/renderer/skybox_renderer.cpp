@@ -0,0 +1,132 @@
+#include "starlet-graphics/renderer/skybox_renderer.hpp"
+#include "starlet-logger/logger.hpp"
+
+#include "starlet-graphics/resource/shader_cpu.hpp"
+#include "starlet-graphics/manager/resource_manager.hpp"
+#include "starlet-graphics/manager/gl_state_manager.hpp"
+#include "starlet-graphics/renderer/frame_stats.hpp"
+#include "starlet-graphics/renderer/render_world.hpp"
+#include "starlet-graphics/uniform/model_cache.hpp"
+
+#include "starlet-math/mat4.hpp"
+
+#include <glad/glad.h>
+
+namespace Starlet::Graphics {
+	namespace {
+		constexpr const char* SKYBOX_VERTEX_SOURCE{
+			"#version 330 core\n"
+			"layout(location = 0) in vec3 vPos;\n"
+			"uniform mat4 mView;\n"
+			"uniform mat4 mProj;\n"
+			"out vec3 direction;\n"
+			"void main() {\n"
+			"\tdirection = vPos;\n"
+			"\tvec4 clip = mProj * mat4(mat3(mView)) * vec4(vPos, 1.0);\n"
+			"\tgl_Position = clip.xyww;\n"
+			"}\n"
+		};
+
+		constexpr const char* SKYBOX_FRAGMENT_SOURCE{
+			"#version 330 core\n"
+			"in vec3 direction;\n"
+			"uniform samplerCube skyboxCubeTexture;\n"
+			"out vec4 outputColour;\n"
+			"void main() {\n"
+			"\toutputColour = vec4(texture(skyboxCubeTexture, direction).rgb, 1.0);\n"
+			"}\n"
+		};
+
+		// Corner i sits at (x, y, z) = bits 0, 1, 2 of i mapped to -1 / +1, faces wind counter-clockwise seen from inside
+		constexpr float CUBE_CORNERS[24]{
+			-1.0f, -1.0f, -1.0f,   1.0f, -1.0f, -1.0f,  -1.0f, 1.0f, -1.0f,   1.0f, 1.0f, -1.0f,
+			-1.0f, -1.0f,  1.0f,   1.0f, -1.0f,  1.0f,  -1.0f, 1.0f,  1.0f,   1.0f, 1.0f,  1.0f
+		};
+		constexpr unsigned int CUBE_INDICES[36]{
+			0, 2, 6, 0, 6, 4,
+			5, 7, 3, 5, 3, 1,
+			4, 5, 1, 4, 1, 0,
+			2, 3, 7, 2, 7, 6,
+			0, 1, 3, 0, 3, 2,
+			6, 7, 5, 6, 5, 4
+		};
+	}
+
+	bool SkyboxRenderer::init() {
+		if (isReady()) return true;
+
+		ShaderCPU cpu;
+		cpu.vertexSource = SKYBOX_VERTEX_SOURCE;
+		cpu.fragmentSource = SKYBOX_FRAGMENT_SOURCE;
+		cpu.valid = true;
+		if (!handler.upload(cpu, program))
+			return Logger::error("SkyboxRenderer", "init", "Failed to build skybox program");
+
+		viewLocation = glGetUniformLocation(program.programID, "mView");
+		projLocation = glGetUniformLocation(program.programID, "mProj");
+		state.setProgram(program.programID);
+		glUniform1i(glGetUniformLocation(program.programID, "skyboxCubeTexture"), SKYBOX_TU);
+
+		glGenVertexArrays(1, &vao);
+		glBindVertexArray(vao);
+
+		glGenBuffers(1, &vertexBuffer);
+		glBindBuffer(GL_ARRAY_BUFFER, vertexBuffer);
+		glBufferData(GL_ARRAY_BUFFER, sizeof(CUBE_CORNERS), CUBE_CORNERS, GL_STATIC_DRAW);
+
+		glGenBuffers(1, &indexBuffer);
+		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, indexBuffer);
+		glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(CUBE_INDICES), CUBE_INDICES, GL_STATIC_DRAW);
+
+		glEnableVertexAttribArray(0);
+		glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), (void*)0);
+
+		glBindBuffer(GL_ARRAY_BUFFER, 0);
+		glBindVertexArray(0);
+
+		// Created behind the shadow's back
+		state.invalidate();
+
+		const GLenum err = glGetError();
+		if (err != GL_NO_ERROR) {
+			shutdown();
+			return Logger::error("SkyboxRenderer", "init", "OpenGL error " + std::to_string(err));
+		}
+		return true;
+	}
+
+	void SkyboxRenderer::shutdown() {
+		if (vao) glDeleteVertexArrays(1, &vao);
+		if (vertexBuffer) glDeleteBuffers(1, &vertexBuffer);
+		if (indexBuffer) glDeleteBuffers(1, &indexBuffer);
+		vao = vertexBuffer = indexBuffer = 0;
+		if (program.programID) handler.unload(program);
+		program.programID = program.vertexID = program.fragmentID = 0;
+		program.linked = false;
+	}
+
+	bool SkyboxRenderer::draw(const RenderSkybox& skybox, const Math::Mat4& view, const Math::Mat4& projection) {
+		// Failures are reported by the caller, once per interval rather than every frame
+		const unsigned int texture = resourceManager.getTextureID(skybox.texture);
+		if (!isReady() || texture == 0) return false;
+
+		state.setProgram(program.programID);
+		glUniformMatrix4fv(viewLocation, 1, GL_FALSE, view.models);
+		glUniformMatrix4fv(projLocation, 1, GL_FALSE, projection.models);
+		stats.uniformUploads += 2;
+
+		state.bindTexture(SKYBOX_TU, GL_TEXTURE_CUBE_MAP, texture);
+		state.setDepthTest(true);
+		state.setDepthFunc(GL_LEQUAL);
+		state.setDepthMask(false);
+		state.setCulling(true);
+		state.setCullFace(GL_BACK);
+		state.bindVertexArray(vao);
+		glDrawElements(GL_TRIANGLES, 36, GL_UNSIGNED_INT, 0);
+
+		++stats.drawCalls;
+		stats.triangles += 12;
+		stats.vertices += 8;
+		return true;
+	}
+}
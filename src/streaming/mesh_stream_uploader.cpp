@@ -0,0 +1,101 @@
+#include "starlet-graphics/streaming/mesh_stream_uploader.hpp"
+#include "starlet-logger/logger.hpp"
+
+#include "starlet-graphics/handler/mesh_handler.hpp"
+#include "starlet-graphics/resource/mesh_cpu.hpp"
+#include "starlet-graphics/resource/mesh_gpu.hpp"
+
+#include <glad/glad.h>
+
+#include <chrono>
+#include <string>
+
+namespace Starlet::Graphics {
+	namespace {
+		using Clock = std::chrono::steady_clock;
+
+		// Written through the copy target so neither the array buffer nor a VAO's element binding is disturbed
+		void writeBuffer(const unsigned int bufferID, const uint64_t offset, const uint64_t bytes, const void* data) {
+			glBindBuffer(GL_COPY_WRITE_BUFFER, bufferID);
+			glBufferSubData(GL_COPY_WRITE_BUFFER, static_cast<GLintptr>(offset), static_cast<GLsizeiptr>(bytes), data);
+		}
+	}
+
+	bool MeshStreamUploader::begin(const MeshCPU& layout) {
+		const Clock::time_point start = Clock::now();
+		stats = {};
+		if (!handler.allocate(layout, gpu)) return Logger::error("MeshStreamUploader", "begin", "Could not allocate mesh buffers");
+		stats.milliseconds = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+		return true;
+	}
+
+	Math::Vertex* MeshStreamUploader::mapVertices(const uint32_t count) {
+		if (vertexScratch.size() < count) {
+			vertexScratch.resize(count);
+			updateScratchBytes();
+		}
+		return vertexScratch.data();
+	}
+
+	bool MeshStreamUploader::commitVertices(const uint32_t first, const uint32_t count) {
+		if (static_cast<uint64_t>(first) + count > gpu.numVertices || count > vertexScratch.size())
+			return Logger::error("MeshStreamUploader", "commitVertices", "Chunk runs past the vertex buffer");
+
+		const Clock::time_point start = Clock::now();
+		writeBuffer(gpu.VertexBufferID, sizeof(Math::Vertex) * static_cast<uint64_t>(first), sizeof(Math::Vertex) * static_cast<uint64_t>(count), vertexScratch.data());
+
+		stats.bytesUploaded += sizeof(Math::Vertex) * static_cast<uint64_t>(count);
+		++stats.chunks;
+		stats.milliseconds += std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+		return true;
+	}
+
+	unsigned int* MeshStreamUploader::mapIndices(const uint32_t count) {
+		if (indexScratch.size() < count) {
+			indexScratch.resize(count);
+			updateScratchBytes();
+		}
+		return indexScratch.data();
+	}
+
+	bool MeshStreamUploader::commitIndices(const uint64_t first, const uint32_t count) {
+		if (first + count > gpu.numIndices || count > indexScratch.size())
+			return Logger::error("MeshStreamUploader", "commitIndices", "Chunk runs past the index buffer");
+
+		const Clock::time_point start = Clock::now();
+		writeBuffer(gpu.IndexBufferID, sizeof(unsigned int) * first, sizeof(unsigned int) * static_cast<uint64_t>(count), indexScratch.data());
+
+		stats.bytesUploaded += sizeof(unsigned int) * static_cast<uint64_t>(count);
+		++stats.chunks;
+		stats.milliseconds += std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+		return true;
+	}
+
+	bool MeshStreamUploader::finish() {
+		glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+
+		// Scratch is only needed while chunks arrive
+		std::vector<Math::Vertex>().swap(vertexScratch);
+		std::vector<unsigned int>().swap(indexScratch);
+
+		const GLenum err = glGetError();
+		if (err != GL_NO_ERROR) {
+			handler.unload(gpu);
+			return Logger::error("MeshStreamUploader", "finish", "OpenGL error " + std::to_string(err));
+		}
+		return true;
+	}
+
+	void MeshStreamUploader::abort() {
+		glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+		std::vector<Math::Vertex>().swap(vertexScratch);
+		std::vector<unsigned int>().swap(indexScratch);
+		handler.unload(gpu);
+	}
+
+	void MeshStreamUploader::updateScratchBytes() {
+		const uint64_t bytes = vertexScratch.capacity() * sizeof(Math::Vertex)
+			+ indexScratch.capacity() * sizeof(unsigned int);
+		if (bytes > stats.scratchBytes) stats.scratchBytes = bytes;
+	}
+}
@@ -0,0 +1,118 @@
+#include "starlet-graphics/streaming/staging_ring.hpp"
+
+namespace Starlet::Graphics {
+	void StagingRing::reset(uint64_t newCapacity) {
+		std::lock_guard<std::mutex> lock(mutex);
+		for (const Region& region : regions)
+			fences.release(region.fence);
+
+		capacity = newCapacity;
+		head = tail = retired = 0;
+		frontSequence = nextSequence = 0;
+		pending.clear();
+		regions.clear();
+	}
+
+	bool StagingRing::allocateLocked(uint64_t size, uint64_t alignment, StagingAllocation& out) {
+		if (size == 0 || size > capacity) return false;
+		if (alignment == 0) alignment = 1;
+
+		// An idle ring restarts at the buffer start so a large request never pays wrap padding
+		if (head == tail && pending.empty() && regions.empty() && head % capacity != 0)
+			head = tail = retired = (head / capacity + 1) * capacity;
+
+		const uint64_t position = head % capacity;
+		uint64_t padding = (alignment - position % alignment) % alignment;
+
+		// Never split an allocation across the end of the buffer, skip to the start instead
+		if (position + padding + size > capacity) padding = capacity - position;
+		if (head + padding + size - tail > capacity) return false;
+
+		out.offset = (head + padding) % capacity;
+		out.size = size;
+		out.sequence = nextSequence++;
+
+		head += padding + size;
+		pending.push_back({ head, false });
+		return true;
+	}
+
+	bool StagingRing::tryAllocate(uint64_t size, uint64_t alignment, StagingAllocation& out) {
+		std::lock_guard<std::mutex> lock(mutex);
+		return allocateLocked(size, alignment, out);
+	}
+
+	bool StagingRing::allocate(uint64_t size, uint64_t alignment, StagingAllocation& out) {
+		for (;;) {
+			std::unique_lock<std::mutex> lock(mutex);
+			if (allocateLocked(size, alignment, out)) return true;
+			if (size == 0 || size > capacity) return false;
+
+			// Space is held by unsubmitted allocations, waiting on fences cannot free it
+			if (regions.empty()) return false;
+
+			const Region oldest = regions.front();
+			lock.unlock();
+
+			fences.wait(oldest.fence);
+			reclaim();
+		}
+	}
+
+	void StagingRing::markSubmitted(const StagingAllocation& allocation) {
+		std::lock_guard<std::mutex> lock(mutex);
+		if (allocation.sequence < frontSequence) return;
+
+		const uint64_t index = allocation.sequence - frontSequence;
+		if (index < pending.size()) pending[index].submitted = true;
+	}
+
+	void StagingRing::retire() {
+		std::lock_guard<std::mutex> lock(mutex);
+
+		// Only the submitted prefix can be fenced, later allocations may still be written by workers
+		uint64_t end = retired;
+		while (!pending.empty() && pending.front().submitted) {
+			end = pending.front().end;
+			pending.pop_front();
+			++frontSequence;
+		}
+		if (end == retired) return;
+
+		regions.push_back({ end, fences.insert() });
+		retired = end;
+	}
+
+	void StagingRing::reclaim() {
+		std::lock_guard<std::mutex> lock(mutex);
+		while (!regions.empty() && fences.isSignaled(regions.front().fence)) {
+			tail = regions.front().end;
+			fences.release(regions.front().fence);
+			regions.pop_front();
+		}
+	}
+
+	void StagingRing::waitIdle() {
+		retire();
+		for (;;) {
+			uint64_t fence = 0;
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+				if (regions.empty()) return;
+				fence = regions.front().fence;
+			}
+			fences.wait(fence);
+			reclaim();
+		}
+	}
+
+	uint64_t StagingRing::getUsed() const {
+		std::lock_guard<std::mutex> lock(mutex);
+		return head - tail;
+	}
+
+	size_t StagingRing::getFencesInFlight() const {
+		std::lock_guard<std::mutex> lock(mutex);
+		return regions.size();
+	}
+}
@@ -0,0 +1,163 @@
+#include "starlet-graphics/streaming/staging_uploader.hpp"
+#include "starlet-logger/logger.hpp"
+
+#include <glad/glad.h>
+
+#include <cstring>
+
+namespace Starlet::Graphics {
+	GLFenceSource::~GLFenceSource() {
+		for (std::unordered_map<uint64_t, void*>::iterator it = syncs.begin(); it != syncs.end(); ++it)
+			glDeleteSync(static_cast<GLsync>(it->second));
+	}
+
+	uint64_t GLFenceSource::insert() {
+		const uint64_t fence = nextFence++;
+		syncs[fence] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+		return fence;
+	}
+
+	bool GLFenceSource::isSignaled(uint64_t fence) {
+		std::unordered_map<uint64_t, void*>::iterator it = syncs.find(fence);
+		if (it == syncs.end()) return true;
+
+		const GLenum result = glClientWaitSync(static_cast<GLsync>(it->second), 0, 0);
+		return result == GL_ALREADY_SIGNALED || result == GL_CONDITION_SATISFIED;
+	}
+
+	void GLFenceSource::wait(uint64_t fence) {
+		std::unordered_map<uint64_t, void*>::iterator it = syncs.find(fence);
+		if (it == syncs.end()) return;
+
+		GLenum result = glClientWaitSync(static_cast<GLsync>(it->second), GL_SYNC_FLUSH_COMMANDS_BIT, 1000000);
+		while (result == GL_TIMEOUT_EXPIRED)
+			result = glClientWaitSync(static_cast<GLsync>(it->second), 0, 1000000);
+	}
+
+	void GLFenceSource::release(uint64_t fence) {
+		std::unordered_map<uint64_t, void*>::iterator it = syncs.find(fence);
+		if (it == syncs.end()) return;
+
+		glDeleteSync(static_cast<GLsync>(it->second));
+		syncs.erase(it);
+	}
+
+
+	StagingUploader::~StagingUploader() {
+		shutdown();
+	}
+
+	bool StagingUploader::init(const uint64_t capacity) {
+		if (isReady()) shutdown();
+		if (!glBufferStorage) return Logger::error("StagingUploader", "init", "glBufferStorage unavailable, staging disabled");
+
+		const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+		glGenBuffers(1, &bufferID);
+		glBindBuffer(GL_COPY_READ_BUFFER, bufferID);
+		glBufferStorage(GL_COPY_READ_BUFFER, static_cast<GLsizeiptr>(capacity), nullptr, flags);
+		mapped = static_cast<uint8_t*>(glMapBufferRange(GL_COPY_READ_BUFFER, 0, static_cast<GLsizeiptr>(capacity), flags));
+		glBindBuffer(GL_COPY_READ_BUFFER, 0);
+
+		if (!mapped) {
+			glDeleteBuffers(1, &bufferID);
+			bufferID = 0;
+			return Logger::error("StagingUploader", "init", "Failed to map staging buffer");
+		}
+
+		ring.reset(capacity);
+		return Logger::debug("StagingUploader", "init", "Staging ring of " + std::to_string(capacity) + " bytes");
+	}
+
+	void StagingUploader::shutdown() {
+		if (!bufferID) return;
+
+		flush();
+		ring.waitIdle();
+
+		glBindBuffer(GL_COPY_READ_BUFFER, bufferID);
+		glUnmapBuffer(GL_COPY_READ_BUFFER);
+		glBindBuffer(GL_COPY_READ_BUFFER, 0);
+		glDeleteBuffers(1, &bufferID);
+
+		bufferID = 0;
+		mapped = nullptr;
+		ring.reset(0);
+	}
+
+	void* StagingUploader::stage(const uint64_t size, StagingAllocation& out) {
+		if (!mapped || !ring.tryAllocate(size, 16, out)) return nullptr;
+		return mapped + out.offset;
+	}
+
+	void* StagingUploader::stage(const void* data, const uint64_t size, StagingAllocation& out) {
+		void* dst = stage(size, out);
+		if (dst) std::memcpy(dst, data, static_cast<size_t>(size));
+		return dst;
+	}
+
+	void StagingUploader::enqueueTextureCopy(const StagingAllocation& allocation, const unsigned int textureID, const unsigned int target, const int level, const int width, const int height, const unsigned int format, const bool generateMIPMap) {
+		CopyCommand command;
+		command.allocation = allocation;
+		command.objectID = textureID;
+		command.target = target;
+		command.level = level;
+		command.width = width;
+		command.height = height;
+		command.format = format;
+		command.generateMIPMap = generateMIPMap;
+
+		std::lock_guard<std::mutex> lock(queueMutex);
+		queue.push_back(command);
+	}
+
+	void StagingUploader::enqueueBufferCopy(const StagingAllocation& allocation, const unsigned int targetBufferID, const uint64_t dstOffset) {
+		CopyCommand command;
+		command.allocation = allocation;
+		command.objectID = targetBufferID;
+		command.dstOffset = dstOffset;
+
+		std::lock_guard<std::mutex> lock(queueMutex);
+		queue.push_back(command);
+	}
+
+	void StagingUploader::flush() {
+		if (!mapped) return;
+
+		{
+			std::lock_guard<std::mutex> lock(queueMutex);
+			submitting.swap(queue);
+		}
+
+		if (!submitting.empty()) {
+			glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+			glBindBuffer(GL_PIXEL_UNPACK_BUFFER, bufferID);
+			glBindBuffer(GL_COPY_READ_BUFFER, bufferID);
+
+			for (const CopyCommand& command : submitting) {
+				const void* offset = reinterpret_cast<const void*>(static_cast<uintptr_t>(command.allocation.offset));
+
+				if (command.target != 0) {
+					const GLenum bindTarget = (command.target == GL_TEXTURE_2D) ? GL_TEXTURE_2D : GL_TEXTURE_CUBE_MAP;
+					glBindTexture(bindTarget, command.objectID);
+					glTexSubImage2D(command.target, command.level, 0, 0, command.width, command.height, command.format, GL_UNSIGNED_BYTE, offset);
+					if (command.generateMIPMap) glGenerateMipmap(bindTarget);
+					glBindTexture(bindTarget, 0);
+				}
+				else {
+					glBindBuffer(GL_COPY_WRITE_BUFFER, command.objectID);
+					glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, static_cast<GLintptr>(command.allocation.offset), static_cast<GLintptr>(command.dstOffset), static_cast<GLsizeiptr>(command.allocation.size));
+				}
+
+				ring.markSubmitted(command.allocation);
+			}
+
+			glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+			glBindBuffer(GL_COPY_READ_BUFFER, 0);
+			glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+			submitting.clear();
+		}
+
+		ring.retire();
+		ring.reclaim();
+	}
+}
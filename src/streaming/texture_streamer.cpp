@@ -0,0 +1,323 @@
+#include "starlet-graphics/streaming/texture_streamer.hpp"
+#include "starlet-logger/logger.hpp"
+
+#include "starlet-graphics/resource/texture_cpu.hpp"
+#include "starlet-graphics/resource/texture_gpu.hpp"
+#include "starlet-graphics/manager/gl_state_manager.hpp"
+
+#include <glad/glad.h>
+
+#include <algorithm>
+
+namespace Starlet::Graphics {
+	namespace {
+		// Unit the streamer binds on during the frame, the state manager rebinds whatever draws need there next
+		constexpr unsigned int STREAM_UNIT{ 0 };
+
+		void releasePixels(std::vector<uint8_t>& pixels) {
+			std::vector<uint8_t>().swap(pixels);
+		}
+	}
+
+	void TextureStreamer::buildMipChain(const TextureCPU& cpu, std::vector<MipLevel>& levelsOut) {
+		levelsOut.clear();
+
+		MipLevel base;
+		base.width = cpu.width;
+		base.height = cpu.height;
+		base.pixels = cpu.pixels;
+		levelsOut.push_back(std::move(base));
+
+		const int channels = cpu.pixelSize;
+		while (levelsOut.back().width > 1 || levelsOut.back().height > 1) {
+			const MipLevel& src = levelsOut.back();
+
+			MipLevel dst;
+			dst.width = std::max(1, src.width / 2);
+			dst.height = std::max(1, src.height / 2);
+			dst.pixels.resize(static_cast<size_t>(dst.width) * dst.height * channels);
+
+			// 2x2 box filter, clamping the second sample on odd edges
+			for (int y = 0; y < dst.height; ++y) {
+				const int y0 = std::min(y * 2, src.height - 1);
+				const int y1 = std::min(y * 2 + 1, src.height - 1);
+				for (int x = 0; x < dst.width; ++x) {
+					const int x0 = std::min(x * 2, src.width - 1);
+					const int x1 = std::min(x * 2 + 1, src.width - 1);
+					for (int c = 0; c < channels; ++c) {
+						const unsigned int sum =
+							src.pixels[(static_cast<size_t>(y0) * src.width + x0) * channels + c] +
+							src.pixels[(static_cast<size_t>(y0) * src.width + x1) * channels + c] +
+							src.pixels[(static_cast<size_t>(y1) * src.width + x0) * channels + c] +
+							src.pixels[(static_cast<size_t>(y1) * src.width + x1) * channels + c];
+						dst.pixels[(static_cast<size_t>(y) * dst.width + x) * channels + c] = static_cast<uint8_t>((sum + 2) / 4);
+					}
+				}
+			}
+
+			levelsOut.push_back(std::move(dst));
+		}
+	}
+
+	size_t TextureStreamer::levelBytes(const Entry& entry, int level) {
+		const MipLevel& mip = entry.levels[static_cast<size_t>(level)];
+		return static_cast<size_t>(mip.width) * mip.height * entry.pixelSize;
+	}
+
+	bool TextureStreamer::add(TextureCPU& cpu, TextureGPU& gpu, TextureReload reload) {
+		if (cpu.empty())
+			return Logger::error("TextureStreamer", "add", "Attempting to stream empty Texture");
+
+		Entry entry;
+		entry.pixelSize = cpu.pixelSize;
+		entry.reload = std::move(reload);
+		buildMipChain(cpu, entry.levels);
+		cpu.freePixels();
+
+		const int levelCount = static_cast<int>(entry.levels.size());
+		entry.tailLevel = levelCount - 1;
+		for (int i = 0; i < levelCount; ++i) {
+			if (static_cast<uint32_t>(std::max(entry.levels[i].width, entry.levels[i].height)) <= budget.tailSize) {
+				entry.tailLevel = i;
+				break;
+			}
+		}
+		entry.residentLevel = entry.tailLevel;
+		entry.lastUsedFrame = frame;
+
+		// Only the tail goes up now, the handle is complete and drawable through GL_TEXTURE_BASE_LEVEL
+		glGenTextures(1, &gpu.id);
+		entry.id = gpu.id;
+		glBindTexture(GL_TEXTURE_2D, gpu.id);
+
+		for (int level = levelCount - 1; level >= entry.tailLevel; --level)
+			uploadLevel(entry, level);
+
+		// The tail is never evicted, so its pixels are not needed again
+		for (int level = entry.tailLevel; level < levelCount; ++level)
+			releasePixels(entry.levels[level].pixels);
+
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, levelCount - 1);
+		setResidentRange(entry);
+		glBindTexture(GL_TEXTURE_2D, 0);
+
+		GLenum err = glGetError();
+		if (err != GL_NO_ERROR) {
+			if (gpu.id) glDeleteTextures(1, &gpu.id);
+			gpu.id = 0;
+			return Logger::error("TextureStreamer", "add", "OpenGL error " + std::to_string(err));
+		}
+
+		for (int level = entry.tailLevel; level < levelCount; ++level)
+			stats.residentBytes += levelBytes(entry, level);
+
+		idToEntry[entry.id] = entries.size();
+		entries.push_back(std::move(entry));
+		return true;
+	}
+
+	TextureStreamer::~TextureStreamer() {
+		// Load jobs write into the pending reloads, none may be left running against freed entries
+		for (Entry& entry : entries)
+			if (entry.reloading && loadJobs) loadJobs->wait(entry.reloading->counter);
+	}
+
+	void TextureStreamer::remove(uint32_t textureID) {
+		std::unordered_map<uint32_t, size_t>::iterator it = idToEntry.find(textureID);
+		if (it == idToEntry.end()) return;
+
+		const size_t index = it->second;
+		if (entries[index].reloading && loadJobs) loadJobs->wait(entries[index].reloading->counter);
+		for (int level = entries[index].residentLevel; level < static_cast<int>(entries[index].levels.size()); ++level)
+			stats.residentBytes -= levelBytes(entries[index], level);
+
+		idToEntry.erase(it);
+		if (index != entries.size() - 1) {
+			entries[index] = std::move(entries.back());
+			idToEntry[entries[index].id] = index;
+		}
+		entries.pop_back();
+	}
+
+	void TextureStreamer::markUsed(uint32_t textureID) {
+		std::unordered_map<uint32_t, size_t>::iterator it = idToEntry.find(textureID);
+		if (it == idToEntry.end()) return;
+
+		Entry& entry = entries[it->second];
+		entry.lastUsedFrame = frame;
+		++entry.usesThisFrame;
+	}
+
+	void TextureStreamer::update(GLStateManager& state) {
+		stats.uploadedBytes = 0;
+		stats.uploadedLevels = 0;
+		stats.evictedLevels = 0;
+		stats.reloads = 0;
+
+		evictStale(state);
+		evictOverBudget(state);
+		streamPending(state);
+
+		// One error read per update rather than a pipeline stall after every level
+		if (stats.uploadedLevels != 0 || stats.evictedLevels != 0) {
+			const GLenum err = glGetError();
+			if (err != GL_NO_ERROR)
+				Logger::error("TextureStreamer", "update", "OpenGL error " + std::to_string(err) + " streaming " + std::to_string(stats.uploadedLevels) + " level(s)");
+		}
+
+		stats.pendingTextures = 0;
+		stats.cpuBytes = 0;
+		for (Entry& entry : entries) {
+			if (entry.residentLevel > 0) ++stats.pendingTextures;
+			for (const MipLevel& level : entry.levels) stats.cpuBytes += level.pixels.size();
+			entry.usesThisFrame = 0;
+		}
+		++frame;
+	}
+
+	void TextureStreamer::uploadLevel(Entry& entry, int level) {
+		MipLevel& mip = entry.levels[static_cast<size_t>(level)];
+		const GLenum src = (entry.pixelSize == 4) ? GL_RGBA : GL_RGB;
+		const GLint  internal = (entry.pixelSize == 4) ? GL_RGBA8 : GL_RGB8;
+
+		glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+		glTexImage2D(GL_TEXTURE_2D, level, internal, mip.width, mip.height, 0, src, GL_UNSIGNED_BYTE, mip.pixels.data());
+
+		if (entry.reload) releasePixels(mip.pixels);
+	}
+
+	void TextureStreamer::setResidentRange(const Entry& entry) {
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, entry.residentLevel);
+	}
+
+	void TextureStreamer::decodeReload(const Job& job) {
+		PendingReload& pending = *static_cast<PendingReload*>(const_cast<void*>(job.data));
+
+		TextureCPU cpu;
+		if (!pending.reload(cpu) || cpu.empty()) return;
+		if (cpu.width != pending.width || cpu.height != pending.height || cpu.pixelSize != pending.pixelSize) return;
+
+		buildMipChain(cpu, pending.levels);
+		pending.ok = true;
+	}
+
+	bool TextureStreamer::reloadLevels(Entry& entry) {
+		if (!entry.reloading) {
+			if (!entry.reload) {
+				entry.failed = true;
+				return Logger::error("TextureStreamer", "reloadLevels", "No source to reload texture " + std::to_string(entry.id));
+			}
+
+			entry.reloading = std::make_unique<PendingReload>();
+			PendingReload& pending = *entry.reloading;
+			pending.reload = entry.reload;
+			pending.width = entry.levels.front().width;
+			pending.height = entry.levels.front().height;
+			pending.pixelSize = entry.pixelSize;
+			++stats.reloads;
+
+			// Without load jobs the decode runs here, inside the frame
+			if (loadJobs) loadJobs->run(decodeReload, &pending, 0, 1, pending.counter);
+			else decodeReload(Job{ decodeReload, &pending, 0, 1, &pending.counter });
+		}
+
+		if (!entry.reloading->counter.isDone()) return false;
+		finishReload(entry);
+		return !entry.failed;
+	}
+
+	void TextureStreamer::finishReload(Entry& entry) {
+		const std::unique_ptr<PendingReload> done = std::move(entry.reloading);
+		if (!done->ok) {
+			entry.failed = true;
+			Logger::error("TextureStreamer", "reloadLevels", "Could not reload texture " + std::to_string(entry.id) + ", or its source changed size");
+			return;
+		}
+
+		for (int level = 0; level < entry.residentLevel; ++level)
+			if (entry.levels[level].pixels.empty()) entry.levels[level].pixels = std::move(done->levels[level].pixels);
+	}
+
+	void TextureStreamer::evictLevel(GLStateManager& state, Entry& entry) {
+		const int level = entry.residentLevel++;
+		state.bindTexture(STREAM_UNIT, GL_TEXTURE_2D, entry.id);
+		setResidentRange(entry);
+
+		// Respecifying the level as 0x0 releases its storage, it sits outside [BASE_LEVEL, MAX_LEVEL] so completeness is unaffected
+		const GLenum src = (entry.pixelSize == 4) ? GL_RGBA : GL_RGB;
+		const GLint  internal = (entry.pixelSize == 4) ? GL_RGBA8 : GL_RGB8;
+		glTexImage2D(GL_TEXTURE_2D, level, internal, 0, 0, 0, src, GL_UNSIGNED_BYTE, nullptr);
+
+		stats.residentBytes -= levelBytes(entry, level);
+		++stats.evictedLevels;
+	}
+
+	void TextureStreamer::evictStale(GLStateManager& state) {
+		for (Entry& entry : entries) {
+			if (frame - entry.lastUsedFrame <= budget.evictAfterFrames) continue;
+			while (entry.residentLevel < entry.tailLevel) evictLevel(state, entry);
+		}
+	}
+
+	void TextureStreamer::evictOverBudget(GLStateManager& state) {
+		while (stats.residentBytes > budget.residentBytes) {
+			Entry* victim = nullptr;
+			for (Entry& entry : entries) {
+				if (entry.residentLevel >= entry.tailLevel || entry.lastUsedFrame == frame) continue;
+				if (!victim || entry.lastUsedFrame < victim->lastUsedFrame) victim = &entry;
+			}
+			if (!victim) break;
+
+			evictLevel(state, *victim);
+		}
+	}
+
+	void TextureStreamer::streamPending(GLStateManager& state) {
+		queue.clear();
+		for (Entry& entry : entries) {
+			if (entry.residentLevel == 0 || entry.failed) continue;
+			if (frame - entry.lastUsedFrame > budget.evictAfterFrames) continue;
+			queue.push_back(&entry);
+		}
+
+		// Most recently drawn first, then by how many draws referenced it this frame
+		std::sort(queue.begin(), queue.end(), [](const Entry* a, const Entry* b) {
+			if (a->lastUsedFrame != b->lastUsedFrame) return a->lastUsedFrame > b->lastUsedFrame;
+			if (a->usesThisFrame != b->usesThisFrame) return a->usesThisFrame > b->usesThisFrame;
+			return a->residentLevel > b->residentLevel;
+		});
+
+		// One level per texture per round so every visible texture sharpens together
+		bool progressed = true;
+		while (progressed) {
+			progressed = false;
+
+			for (Entry* entry : queue) {
+				if (entry->residentLevel == 0 || entry->failed) continue;
+
+				const int level = entry->residentLevel - 1;
+				const size_t bytes = levelBytes(*entry, level);
+				if (stats.residentBytes + bytes > budget.residentBytes) continue;
+				if (stats.uploadedBytes + bytes > budget.uploadBytesPerFrame && stats.uploadedBytes != 0) return;
+
+				// Levels freed after an earlier upload come back from the source once, all of them together, and the texture
+				// waits at its current level while the load jobs decode it
+				if (entry->levels[level].pixels.empty() && !reloadLevels(*entry)) continue;
+
+				state.bindTexture(STREAM_UNIT, GL_TEXTURE_2D, entry->id);
+				uploadLevel(*entry, level);
+				entry->residentLevel = level;
+				setResidentRange(*entry);
+
+				stats.residentBytes += bytes;
+				stats.uploadedBytes += bytes;
+				++stats.uploadedLevels;
+				progressed = true;
+			}
+		}
+	}
+}
\ No newline at end of file
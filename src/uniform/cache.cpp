@@ -6,7 +6,7 @@
 namespace Starlet::Graphics {
 	bool Cache::getUniformLocation(int& location, const char* name) const {
 		location = glGetUniformLocation(program, name);
-		if (location < 0) return Logger::error("UniformCache", "getUniformLocation", std::string("Could not find uniform: ") + name);
+		if (location < 0 && !specialised) return Logger::error("UniformCache", "getUniformLocation", std::string("Could not find uniform: ") + name);
 		return true;
 	}
 }
\ No newline at end of file
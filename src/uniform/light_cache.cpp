@@ -1,10 +1,32 @@
 #include "starlet-graphics/uniform/uniform_cache.hpp"
 
+#include <glad/glad.h>
+
+#include <string>
+
 namespace Starlet::Graphics {
 	bool LightCache::cacheLocations() {
 		bool ok = true;
 		ok &= getUniformLocation(lightCountLocation, "lightCount");
 		ok &= getUniformLocation(ambientLightLocation, "ambientLight");
+
+		// Array entries the shader does not declare are not errors, the loop just stops there
+		lights.clear();
+		for (unsigned int i = 0; i < MAX_LIGHTS; ++i) {
+			const std::string prefix = "theLights[" + std::to_string(i) + "].";
+			LightUL light;
+			light.position_UL = glGetUniformLocation(program, (prefix + "position").c_str());
+			if (light.position_UL < 0) break;
+
+			light.diffuse_UL = glGetUniformLocation(program, (prefix + "diffuse").c_str());
+			light.attenuation_UL = glGetUniformLocation(program, (prefix + "attenuation").c_str());
+			light.direction_UL = glGetUniformLocation(program, (prefix + "direction").c_str());
+			light.param1_UL = glGetUniformLocation(program, (prefix + "param1").c_str());
+			light.param2_UL = glGetUniformLocation(program, (prefix + "param2").c_str());
+			lights.push_back(light);
+		}
+
+		lightBlockIndex = glGetUniformBlockIndex(program, "LightBlock");
 		return ok;
 	}
 }
\ No newline at end of file
@@ -11,6 +11,11 @@ namespace Starlet::Graphics {
 		cameraCache.setProgram(programID);
 		return true;
 	}
+	void UniformCache::setSpecialised(bool specialised) {
+		modelCache.setSpecialised(specialised);
+		lightCache.setSpecialised(specialised);
+		cameraCache.setSpecialised(specialised);
+	}
 	bool UniformCache::cacheAllLocations() {
 		if (program == 0) return Logger::error("UniformCache", "cacheAllLocations", "Program ID is 0");
 
@@ -20,4 +25,25 @@ namespace Starlet::Graphics {
 		ok &= lightCache.cacheLocations();
 		return ok;
 	}
+
+	bool UniformCache::switchProgram(unsigned int programID, bool specialised) {
+		if (programID == program) return true;
+
+		// Locations are looked up once per program and restored on later switches, the program must be bound
+		std::unordered_map<unsigned int, ProgramLocations>::const_iterator it = programLocations.find(programID);
+		if (it != programLocations.end()) {
+			program = programID;
+			modelCache = it->second.model;
+			lightCache = it->second.light;
+			cameraCache = it->second.camera;
+			return true;
+		}
+
+		setSpecialised(specialised);
+		if (!setProgram(programID)) return false;
+
+		const bool ok = cacheAllLocations();
+		programLocations[programID] = { modelCache, lightCache, cameraCache };
+		return ok;
+	}
 }
\ No newline at end of file
@@ -0,0 +1,175 @@
+#include "test_check.hpp"
+
+#include "starlet-graphics/backend/recording_gl.hpp"
+#include "starlet-graphics/jobs/job_system.hpp"
+#include "starlet-graphics/manager/resource_manager.hpp"
+#include "starlet-graphics/manager/shader_manager.hpp"
+#include "starlet-graphics/memory/heap_counter.hpp"
+#include "starlet-graphics/renderer/renderer.hpp"
+#include "starlet-graphics/renderer/render_world.hpp"
+
+#include "starlet-scene/component/model.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <string>
+#include <vector>
+
+// Every global allocation in the process goes through here and is counted, as heap_counter.hpp describes
+namespace {
+	void* allocate(const std::size_t size) {
+		Starlet::Graphics::recordHeapAllocation();
+		return std::malloc(size ? size : 1);
+	}
+	void* allocateAligned(const std::size_t size, const std::align_val_t align) {
+		Starlet::Graphics::recordHeapAllocation();
+		const std::size_t alignment = static_cast<std::size_t>(align);
+		return std::aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment);
+	}
+}
+
+void* operator new(const std::size_t size) {
+	if (void* p = allocate(size)) return p;
+	throw std::bad_alloc();
+}
+void* operator new[](const std::size_t size) {
+	if (void* p = allocate(size)) return p;
+	throw std::bad_alloc();
+}
+void* operator new(const std::size_t size, const std::nothrow_t&) noexcept { return allocate(size); }
+void* operator new[](const std::size_t size, const std::nothrow_t&) noexcept { return allocate(size); }
+void* operator new(const std::size_t size, const std::align_val_t align) {
+	if (void* p = allocateAligned(size, align)) return p;
+	throw std::bad_alloc();
+}
+void* operator new[](const std::size_t size, const std::align_val_t align) {
+	if (void* p = allocateAligned(size, align)) return p;
+	throw std::bad_alloc();
+}
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t) noexcept { std::free(p); }
+void operator delete(void* p, std::align_val_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::align_val_t) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t, std::align_val_t) noexcept { std::free(p); }
+
+using namespace Starlet;
+using namespace Starlet::Graphics;
+
+namespace {
+	constexpr int WARM_UP_FRAMES{ 4 };
+	constexpr int MEASURED_FRAMES{ 8 };
+
+	void addModel(RenderWorld& world, const char* name, const ResourceHandle mesh, const Math::Vec3<float>& position, const Math::Vec4<float>& colour) {
+		RenderModels& models = world.models;
+		const size_t row = models.size();
+		models.resize(row + 1);
+		models.name[row] = name;
+		models.position[row] = position;
+		models.rotation[row] = { 0.0f, 30.0f, 0.0f };
+		models.scale[row] = { 1.0f, 1.0f, 1.0f };
+		models.colour[row] = colour;
+		models.specular[row] = { 1.0f, 1.0f, 1.0f, 32.0f };
+		models.mesh[row] = mesh;
+		models.flags[row] = RENDER_MODEL_VISIBLE | RENDER_MODEL_LIT;
+		models.version[row] = row + 1;
+	}
+
+	void buildWorld(RenderWorld& world, const ResourceHandle cube) {
+		world.camera.valid = true;
+		world.camera.rotation = { 0.0f, -90.0f, 0.0f };
+		world.camera.fov = 60.0f;
+		world.camera.nearPlane = 0.1f;
+		world.camera.farPlane = 100.0f;
+		world.ambient = { 0.2f, 0.2f, 0.2f, 1.0f };
+
+		addModel(world, "front", cube, { 0.0f, 0.0f, -4.0f }, { 1.0f, 0.0f, 0.0f, 1.0f });
+		addModel(world, "behind front", cube, { 0.0f, 0.0f, -12.0f }, { 0.0f, 1.0f, 0.0f, 1.0f });
+		addModel(world, "side", cube, { 3.0f, 0.0f, -6.0f }, { 0.0f, 0.0f, 1.0f, 1.0f });
+		addModel(world, "glass", cube, { -2.0f, 0.0f, -5.0f }, { 1.0f, 1.0f, 1.0f, 0.5f });
+
+		RenderLights& lights = world.lights;
+		lights.resize(2);
+		for (size_t i = 0; i < 2; ++i) {
+			lights.position[i] = { i ? -3.0f : 3.0f, 2.0f, -5.0f, 1.0f };
+			lights.direction[i] = { 0.0f, -1.0f, 0.0f, 0.0f };
+			lights.diffuse[i] = { 1.0f, 1.0f, 1.0f, 1.0f };
+			lights.attenuation[i] = { 1.0f, 0.09f, 0.032f, 0.0f };
+			lights.active[i] = 1;
+			lights.version[i] = i + 1;
+		}
+	}
+}
+
+// A steady frame with the optional passes on must not touch the heap: after warm-up frames have grown every
+// scratch buffer, renderFrame is run again with the allocation counter watching.
+int main() {
+	RecordingGL gl;
+	CHECK(gl.install());
+
+	ResourceManager resources;
+	resources.setBasePath(STARLET_GRAPHICS_TEST_DIR "assets");
+	resources.setFastPlyParsing(true);
+
+	Scene::Model cubeModel;
+	cubeModel.meshPath = "cube.ply";
+	CHECK(resources.loadMeshes({ &cubeModel }));
+
+	JobSystem jobs;
+	CHECK(jobs.init(3));
+
+	ShaderManager shaders;
+	shaders.setBasePath(STARLET_GRAPHICS_TEST_DIR "assets/");
+
+	Renderer renderer(resources);
+	CHECK(renderer.enableDepthPrepass(shaders));
+	CHECK(shaders.createProgramFromPaths("model", "shaders/basic.vert", "shaders/basic.frag"));
+	const unsigned int program = shaders.getProgramID("model");
+	CHECK(renderer.init(program));
+
+	renderer.setJobSystem(&jobs);
+	renderer.setStatsHistory(16);
+	renderer.setLightCulling(true);
+	CHECK(renderer.enableLightClusters(4));
+	CHECK(renderer.enableProfiling(true));
+
+	// The cube is its own occluder, so the one straight behind "front" is culled on the CPU
+	const std::vector<Math::Vec3<float>> corners{
+		{ -0.5f, -0.5f, -0.5f }, { 0.5f, -0.5f, -0.5f }, { 0.5f, 0.5f, -0.5f }, { -0.5f, 0.5f, -0.5f },
+		{ -0.5f, -0.5f, 0.5f }, { 0.5f, -0.5f, 0.5f }, { 0.5f, 0.5f, 0.5f }, { -0.5f, 0.5f, 0.5f }
+	};
+	const std::vector<uint32_t> faces{
+		0, 1, 2, 0, 2, 3, 4, 6, 5, 4, 7, 6, 0, 4, 5, 0, 5, 1, 3, 2, 6, 3, 6, 7, 0, 3, 7, 0, 7, 4, 1, 5, 6, 1, 6, 2
+	};
+	renderer.enableOcclusionCulling(64, 32);
+	renderer.getOcclusion().setOccluderMesh(cubeModel.meshHandle.id, corners, faces);
+
+	RenderWorld world;
+	buildWorld(world, cubeModel.meshHandle);
+
+	// The recorder's command log grows by design, as a null backend it only counts
+	gl.setRecording(false);
+	for (int frame = 0; frame < WARM_UP_FRAMES; ++frame) renderer.renderFrame(program, world, 16.0f / 9.0f);
+
+	renderer.setAllocationCheck(true);
+	const uint64_t before = getHeapAllocationCount();
+	for (int frame = 0; frame < MEASURED_FRAMES; ++frame) {
+		renderer.renderFrame(program, world, 16.0f / 9.0f);
+		if (renderer.getFrameStats().heapAllocations != 0)
+			std::fprintf(stderr, "frame %d: %u allocations\n", frame, renderer.getFrameStats().heapAllocations);
+		CHECK(renderer.getFrameStats().heapAllocations == 0);
+		// Read by a HUD every frame
+		CHECK(renderer.getStatsHistory().p95() >= 0.0);
+	}
+	CHECK(getHeapAllocationCount() == before);
+
+	// The passes really ran
+	CHECK(renderer.getFrameStats().drawCalls > 0);
+	CHECK(renderer.getFrameStats().prepassDrawCalls > 0);
+	CHECK(renderer.getFrameStats().occludedModels == 1);
+	CHECK(renderer.getProfiler().getEventCount() > 0);
+	return 0;
+}
@@ -0,0 +1,6 @@
+#version 460 core
+out vec4 fragColour;
+
+void main() {
+	fragColour = vec4(1.0);
+}
@@ -0,0 +1,70 @@
+#include "test_check.hpp"
+
+#include "starlet-graphics/backend/recording_gl.hpp"
+#include "starlet-graphics/manager/gl_state_manager.hpp"
+
+#include <glad/glad.h>
+
+using namespace Starlet::Graphics;
+
+namespace {
+	// glBindBufferBase also sets the generic binding, the shadow must follow it
+	void indexedBindings() {
+		RecordingGL gl;
+		CHECK(gl.install());
+		GLStateManager state;
+
+		state.bindBufferBase(GL_SHADER_STORAGE_BUFFER, 3, 7);
+		state.bindBufferBase(GL_SHADER_STORAGE_BUFFER, 3, 7);
+		state.bindBuffer(GL_SHADER_STORAGE_BUFFER, 7);
+		CHECK(gl.getCallCount("glBindBufferBase") == 1);
+		CHECK(gl.getCallCount("glBindBuffer") == 0);
+
+		state.bindBuffer(GL_SHADER_STORAGE_BUFFER, 8);
+		state.bindBufferBase(GL_SHADER_STORAGE_BUFFER, 3, 7);
+		CHECK(gl.getCallCount("glBindBuffer") == 1);
+		CHECK(gl.getCallCount("glBindBufferBase") == 1);
+
+		// Uniform binding points are tracked apart from storage ones
+		state.bindBufferBase(GL_UNIFORM_BUFFER, 3, 7);
+		CHECK(gl.getCallCount("glBindBufferBase") == 2);
+
+		// Binding points past the shadow are always issued
+		state.bindBufferBase(GL_SHADER_STORAGE_BUFFER, GLStateManager::MAX_BUFFER_BINDINGS, 7);
+		state.bindBufferBase(GL_SHADER_STORAGE_BUFFER, GLStateManager::MAX_BUFFER_BINDINGS, 7);
+		CHECK(gl.getCallCount("glBindBufferBase") == 4);
+
+		state.invalidate();
+		state.bindBufferBase(GL_SHADER_STORAGE_BUFFER, 3, 7);
+		CHECK(gl.getCallCount("glBindBufferBase") == 5);
+	}
+
+	void genericBindings() {
+		RecordingGL gl;
+		CHECK(gl.install());
+		GLStateManager state;
+
+		state.bindBuffer(GL_ARRAY_BUFFER, 1);
+		state.bindBuffer(GL_ARRAY_BUFFER, 1);
+		CHECK(gl.getCallCount("glBindBuffer") == 1);
+
+		// A new VAO brings its own element buffer, the array buffer binding survives it
+		state.bindBuffer(GL_ELEMENT_ARRAY_BUFFER, 5);
+		state.bindVertexArray(2);
+		state.bindBuffer(GL_ELEMENT_ARRAY_BUFFER, 5);
+		state.bindBuffer(GL_ARRAY_BUFFER, 1);
+		CHECK(gl.getCallCount("glBindBuffer") == 3);
+
+		// Untracked targets are passed straight through
+		state.bindBuffer(GL_TEXTURE_BUFFER, 1);
+		state.bindBuffer(GL_TEXTURE_BUFFER, 1);
+		CHECK(gl.getCallCount("glBindBuffer") == 5);
+		CHECK(state.getStats().skipped == 2);
+	}
+}
+
+int main() {
+	indexedBindings();
+	genericBindings();
+	return 0;
+}
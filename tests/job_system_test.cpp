@@ -0,0 +1,137 @@
+#include "test_check.hpp"
+
+#include "starlet-graphics/jobs/job_system.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace Starlet::Graphics;
+
+namespace {
+	// Several times a worker deque's capacity, so the owner keeps refilling slots that thieves are reading
+	constexpr uint32_t STRESS_JOBS{ static_cast<uint32_t>(JobSystem::MAX_JOBS_PER_WORKER) * 4 + 123 };
+
+	struct StressState {
+		JobSystem* jobs{ nullptr };
+		std::vector<std::atomic<uint32_t>> hits;
+
+		explicit StressState(const uint32_t count) : hits(count) {}
+	};
+
+	void hit(const Job& job) {
+		StressState& state = *static_cast<StressState*>(const_cast<void*>(job.data));
+		for (uint32_t i = job.begin; i < job.end; ++i) state.hits[i].fetch_add(1, std::memory_order_relaxed);
+
+		// A little work so the other workers get to steal while the submitter is still pushing
+		volatile uint32_t spin = 0;
+		for (int i = 0; i < 200; ++i) spin = spin + 1;
+	}
+
+	// Runs on a worker and submits every job from there, then waits on them
+	void submitAll(const Job& job) {
+		StressState& state = *static_cast<StressState*>(const_cast<void*>(job.data));
+		JobCounter counter;
+		for (uint32_t i = job.begin; i < job.end; ++i) state.jobs->run(hit, &state, i, i + 1, counter);
+		state.jobs->wait(counter);
+	}
+
+	void checkAllRanOnce(const StressState& state) {
+		for (const std::atomic<uint32_t>& count : state.hits) CHECK(count.load() == 1);
+	}
+
+	// More jobs than a deque holds, pushed from a worker while the others steal: each must run exactly once
+	void workerSubmission() {
+		JobSystem jobs;
+		CHECK(jobs.init(4));
+
+		StressState state(STRESS_JOBS);
+		state.jobs = &jobs;
+
+		JobCounter counter;
+		jobs.run(submitAll, &state, 0, STRESS_JOBS, counter);
+		jobs.wait(counter);
+
+		checkAllRanOnce(state);
+	}
+
+	// Threads outside the system submit through the injected ring at the same time
+	void externalSubmission() {
+		JobSystem jobs;
+		CHECK(jobs.init(3));
+
+		constexpr uint32_t THREADS{ 4 };
+		StressState state(STRESS_JOBS);
+		state.jobs = &jobs;
+
+		std::vector<std::thread> submitters;
+		for (uint32_t t = 0; t < THREADS; ++t) {
+			submitters.emplace_back([&jobs, &state, t]() {
+				JobCounter counter;
+				for (uint32_t i = t; i < STRESS_JOBS; i += THREADS) jobs.run(hit, &state, i, i + 1, counter);
+				jobs.wait(counter);
+			});
+		}
+		for (std::thread& submitter : submitters) submitter.join();
+
+		checkAllRanOnce(state);
+	}
+
+	// Jobs left queued at shutdown still run, and without init() they run inline
+	void inlineAndShutdown() {
+		StressState state(64);
+		JobSystem jobs;
+
+		JobCounter inlineCounter;
+		jobs.run(hit, &state, 0, 32, inlineCounter);
+		CHECK(inlineCounter.isDone());
+
+		CHECK(jobs.init(2));
+		JobCounter counter;
+		for (uint32_t i = 32; i < 64; ++i) jobs.run(hit, &state, i, i + 1, counter);
+		jobs.shutdown();
+		CHECK(counter.isDone());
+		checkAllRanOnce(state);
+	}
+
+	void parallelForCoversRange() {
+		JobSystem jobs;
+		CHECK(jobs.init(4));
+
+		std::vector<std::atomic<uint32_t>> hits(10007);
+		jobs.parallelFor(static_cast<uint32_t>(hits.size()), 13, [&hits](const uint32_t begin, const uint32_t end) {
+			for (uint32_t i = begin; i < end; ++i) hits[i].fetch_add(1, std::memory_order_relaxed);
+		});
+		for (const std::atomic<uint32_t>& count : hits) CHECK(count.load() == 1);
+	}
+
+	// Scaling of parallelFor against a serial loop for growing worker counts
+	void benchmark() {
+		const unsigned int hardware = std::max(1u, std::thread::hardware_concurrency());
+		for (unsigned int workers = 1; workers <= hardware; workers *= 2) {
+			JobSystem jobs;
+			CHECK(jobs.init(workers));
+			const JobBenchResult result = jobs.benchmark(20000, 5);
+			std::printf("%2u workers: serial %.2f ms, parallel %.2f ms, speedup %.2fx, %.0f jobs/s\n",
+				result.workers, result.serialMs, result.parallelMs, result.speedup, result.jobsPerSecond);
+		}
+	}
+}
+
+// Build with -fsanitize=thread to check the scheduler for races, pass --bench to print scaling numbers
+int main(int argc, char** argv) {
+	const bool bench = argc > 1 && std::string(argv[1]) == "--bench";
+
+	for (int round = 0; round < 4; ++round) {
+		workerSubmission();
+		externalSubmission();
+	}
+	inlineAndShutdown();
+	parallelForCoversRange();
+
+	if (bench) benchmark();
+	return 0;
+}
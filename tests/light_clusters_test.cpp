@@ -0,0 +1,202 @@
+#include "test_check.hpp"
+
+#include "starlet-graphics/jobs/job_system.hpp"
+#include "starlet-graphics/renderer/camera_view.hpp"
+#include "starlet-graphics/renderer/light_clusters.hpp"
+#include "starlet-graphics/renderer/render_world.hpp"
+
+#include "starlet-math/constants.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+using namespace Starlet;
+using namespace Starlet::Graphics;
+
+namespace {
+	constexpr uint32_t GRID_X{ 8 }, GRID_Y{ 5 }, GRID_Z{ 12 };
+	constexpr float CUTOFF{ 0.01f };
+
+	// xorshift, so the light set is the same on every platform
+	class Random {
+	public:
+		explicit Random(const uint32_t seed) : state(seed) {}
+		float range(const float low, const float high) {
+			state ^= state << 13;
+			state ^= state >> 17;
+			state ^= state << 5;
+			return low + (high - low) * static_cast<float>(state & 0xFFFFFF) / static_cast<float>(0xFFFFFF);
+		}
+
+	private:
+		uint32_t state;
+	};
+
+	Math::Vec3<float> fromView(const CameraView& view, const float x, const float y, const float z) {
+		return {
+			view.eye.x + view.right.x * x + view.up.x * y + view.front.x * z,
+			view.eye.y + view.right.y * x + view.up.y * y + view.front.y * z,
+			view.eye.z + view.right.z * x + view.up.z * y + view.front.z * z
+		};
+	}
+
+	void addLight(RenderLights& lights, const Math::Vec3<float>& position, const Math::Vec4<float>& attenuation, const float type, const bool active) {
+		const size_t row = lights.size();
+		lights.resize(row + 1);
+		lights.position[row] = { position.x, position.y, position.z, 1.0f };
+		lights.direction[row] = { 0.0f, -1.0f, 0.0f, 0.0f };
+		lights.diffuse[row] = { 1.0f, 1.0f, 1.0f, 1.0f };
+		lights.attenuation[row] = attenuation;
+		lights.param1[row] = { type, 0.0f, 0.0f, 0.0f };
+		lights.active[row] = active ? 1 : 0;
+		lights.version[row] = row + 1;
+	}
+
+	// Attenuation with 1 / (1 + q*d^2) = cutoff at d = radius
+	Math::Vec4<float> attenuationFor(const float radius) {
+		return { 1.0f, 0.0f, (1.0f / CUTOFF - 1.0f) / (radius * radius), 0.0f };
+	}
+
+	// Random point lights all through the frustum and beyond its planes, plus lights centred just outside the near
+	// and far planes whose spheres reach into the first and last slices
+	void buildLights(RenderWorld& world, const CameraView& view, const ClusterProjection& projection) {
+		Random random(7);
+		const float tanHalfY = std::tan(radians(projection.fov) * 0.5f);
+		const float tanHalfX = tanHalfY * projection.aspect;
+
+		for (int i = 0; i < 200; ++i) {
+			const float z = random.range(-2.0f, projection.farPlane + 5.0f);
+			const float reach = std::max(1.0f, z);
+			const Math::Vec3<float> position = fromView(view, random.range(-1.2f, 1.2f) * tanHalfX * reach, random.range(-1.2f, 1.2f) * tanHalfY * reach, z);
+			const Math::Vec4<float> attenuation{ 1.0f, random.range(0.0f, 0.5f), random.range(0.01f, 0.5f), 0.0f };
+			addLight(world.lights, position, attenuation, 0.0f, i % 17 != 0);
+		}
+
+		for (int i = 0; i < 8; ++i) {
+			const float x = random.range(-0.5f, 0.5f), y = random.range(-0.3f, 0.3f);
+			addLight(world.lights, fromView(view, x, y, projection.nearPlane - 0.1f), attenuationFor(0.3f), 0.0f, true);
+			addLight(world.lights, fromView(view, x, y, projection.nearPlane - 0.5f), attenuationFor(0.3f), 0.0f, true);
+			addLight(world.lights, fromView(view, x * 20.0f, y * 20.0f, projection.farPlane + 0.5f), attenuationFor(1.0f), 0.0f, true);
+			addLight(world.lights, fromView(view, x * 20.0f, y * 20.0f, projection.farPlane + 2.0f), attenuationFor(1.0f), 0.0f, true);
+		}
+
+		// Listed everywhere, and never listed since it is never brighter than the cutoff
+		addLight(world.lights, fromView(view, 0.0f, 50.0f, 0.0f), { 1.0f, 0.0f, 0.0f, 0.0f }, DIRECTIONAL_LIGHT_TYPE, true);
+		addLight(world.lights, fromView(view, 0.0f, 0.0f, 5.0f), { 2.0f / CUTOFF, 0.0f, 0.0f, 0.0f }, 0.0f, true);
+	}
+
+	// The cluster's box from its own frustum corners, independent of LightClusters::buildBounds
+	ClusterBounds bruteBounds(const ClusterProjection& projection, const uint32_t x, const uint32_t y, const uint32_t z) {
+		const float tanHalfY = std::tan(radians(projection.fov) * 0.5f);
+		const float tanHalfX = tanHalfY * projection.aspect;
+		const float depthRatio = projection.farPlane / projection.nearPlane;
+		const float depths[2] = {
+			projection.nearPlane * std::pow(depthRatio, static_cast<float>(z) / GRID_Z),
+			projection.nearPlane * std::pow(depthRatio, static_cast<float>(z + 1) / GRID_Z)
+		};
+		const float xs[2] = { (-1.0f + 2.0f * x / GRID_X) * tanHalfX, (-1.0f + 2.0f * (x + 1) / GRID_X) * tanHalfX };
+		const float ys[2] = { (-1.0f + 2.0f * y / GRID_Y) * tanHalfY, (-1.0f + 2.0f * (y + 1) / GRID_Y) * tanHalfY };
+
+		ClusterBounds bounds{ { xs[0] * depths[0], ys[0] * depths[0], depths[0] }, { xs[0] * depths[0], ys[0] * depths[0], depths[0] } };
+		for (const float depth : depths)
+			for (const float tileX : xs)
+				for (const float tileY : ys) {
+					bounds.min = { std::min(bounds.min.x, tileX * depth), std::min(bounds.min.y, tileY * depth), std::min(bounds.min.z, depth) };
+					bounds.max = { std::max(bounds.max.x, tileX * depth), std::max(bounds.max.y, tileY * depth), std::max(bounds.max.z, depth) };
+				}
+		return bounds;
+	}
+
+	// Every compacted light against every cluster box
+	std::vector<std::vector<uint32_t>> bruteForce(const RenderWorld& world, const CameraView& view, const ClusterProjection& projection) {
+		std::vector<std::vector<uint32_t>> expected(static_cast<size_t>(GRID_X) * GRID_Y * GRID_Z);
+		const RenderLights& lights = world.lights;
+
+		uint32_t compact = 0;
+		for (size_t i = 0; i < lights.size(); ++i) {
+			if (!lights.active[i]) continue;
+
+			const bool directional = lights.param1[i].x == DIRECTIONAL_LIGHT_TYPE;
+			const float radius = directional ? -1.0f : lightInfluenceRange(lights.attenuation[i], CUTOFF);
+			if (radius == 0.0f) continue;
+
+			const Math::Vec3<float> offset{ lights.position[i].x - view.eye.x, lights.position[i].y - view.eye.y, lights.position[i].z - view.eye.z };
+			const Math::Vec3<float> centre{ offset.dot(view.right), offset.dot(view.up), offset.dot(view.front) };
+
+			for (uint32_t z = 0; z < GRID_Z; ++z)
+				for (uint32_t y = 0; y < GRID_Y; ++y)
+					for (uint32_t x = 0; x < GRID_X; ++x) {
+						const ClusterBounds bounds = bruteBounds(projection, x, y, z);
+						const float dx = centre.x - std::clamp(centre.x, bounds.min.x, bounds.max.x);
+						const float dy = centre.y - std::clamp(centre.y, bounds.min.y, bounds.max.y);
+						const float dz = centre.z - std::clamp(centre.z, bounds.min.z, bounds.max.z);
+						if (radius < 0.0f || dx * dx + dy * dy + dz * dz <= radius * radius)
+							expected[(z * GRID_Y + y) * GRID_X + x].push_back(compact);
+					}
+			++compact;
+		}
+		return expected;
+	}
+
+	std::vector<uint32_t> clusterLights(const LightClusters& clusters, const size_t cluster) {
+		uint32_t count = 0;
+		const uint32_t* lights = clusters.getClusterLights(cluster, count);
+		std::vector<uint32_t> sorted(lights, lights + count);
+		std::sort(sorted.begin(), sorted.end());
+		return sorted;
+	}
+
+	// Returns the number of lights whose sphere crosses the near or far plane and that were found in a cluster
+	size_t checkAgainstBruteForce(const RenderWorld& world, const CameraView& view, const ClusterProjection& projection, JobSystem* jobs) {
+		LightClusters clusters;
+		clusters.setGrid(GRID_X, GRID_Y, GRID_Z);
+		clusters.setCutoff(CUTOFF);
+		clusters.build(world, view, projection, jobs);
+		CHECK(clusters.getClusterCount() == static_cast<size_t>(GRID_X) * GRID_Y * GRID_Z);
+
+		const std::vector<std::vector<uint32_t>> expected = bruteForce(world, view, projection);
+		size_t indexCount = 0;
+		std::vector<uint8_t> listed(clusters.getLights().size(), 0);
+		for (size_t cluster = 0; cluster < expected.size(); ++cluster) {
+			const std::vector<uint32_t> actual = clusterLights(clusters, cluster);
+			CHECK(actual == expected[cluster]);
+			for (const uint32_t light : actual) listed[light] = 1;
+			indexCount += actual.size();
+		}
+		CHECK(clusters.getIndexCount() == indexCount);
+
+		size_t straddling = 0;
+		const std::vector<Math::Vec4<float>>& spheres = clusters.getLightSpheres();
+		for (size_t light = 0; light < spheres.size(); ++light) {
+			const Math::Vec4<float>& sphere = spheres[light];
+			if (sphere.w < 0.0f) continue;
+			const bool crossesNear = sphere.z < projection.nearPlane && sphere.z + sphere.w > projection.nearPlane;
+			const bool crossesFar = sphere.z > projection.farPlane && sphere.z - sphere.w < projection.farPlane;
+			if ((crossesNear || crossesFar) && listed[light]) ++straddling;
+		}
+		return straddling;
+	}
+}
+
+int main() {
+	const CameraView view = CameraView::fromTransform({ 1.0f, 2.0f, 3.0f }, { 10.0f, -70.0f, 0.0f }, { 0.0f, 1.0f, 0.0f });
+	ClusterProjection projection;
+	projection.fov = 60.0f;
+	projection.aspect = 16.0f / 9.0f;
+	projection.nearPlane = 0.5f;
+	projection.farPlane = 40.0f;
+
+	RenderWorld world;
+	buildLights(world, view, projection);
+
+	// Lights centred outside the depth range still reach the first and last slices
+	const size_t straddling = checkAgainstBruteForce(world, view, projection, nullptr);
+	CHECK(straddling >= 16);
+
+	JobSystem jobs;
+	CHECK(jobs.init(3));
+	CHECK(checkAgainstBruteForce(world, view, projection, &jobs) == straddling);
+	return 0;
+}
@@ -0,0 +1,304 @@
+#include "test_check.hpp"
+
+#include "starlet-graphics/backend/recording_gl.hpp"
+#include "starlet-graphics/jobs/job_system.hpp"
+#include "starlet-graphics/manager/resource_manager.hpp"
+#include "starlet-graphics/picking/mesh_bvh.hpp"
+#include "starlet-graphics/picking/ray_picker.hpp"
+#include "starlet-graphics/renderer/render_world.hpp"
+#include "starlet-graphics/resource/mesh_cpu.hpp"
+
+#include "starlet-math/mat4.hpp"
+#include "starlet-scene/component/model.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+using namespace Starlet;
+using namespace Starlet::Graphics;
+
+namespace {
+	using Vec3 = Math::Vec3<float>;
+
+	constexpr float NO_LIMIT{ std::numeric_limits<float>::max() };
+
+	// xorshift, so the meshes and rays are the same on every platform
+	class Random {
+	public:
+		explicit Random(const uint32_t seed) : state(seed) {}
+		float range(const float low, const float high) {
+			state ^= state << 13;
+			state ^= state >> 17;
+			state ^= state << 5;
+			return low + (high - low) * static_cast<float>(state & 0xFFFFFF) / static_cast<float>(0xFFFFFF);
+		}
+		Vec3 point(const float extent) { return { range(-extent, extent), range(-extent, extent), range(-extent, extent) }; }
+
+	private:
+		uint32_t state;
+	};
+
+	struct Ray {
+		Vec3 origin, direction;
+		float maxDistance;
+	};
+
+	struct Triangle {
+		Vec3 a, b, c;
+	};
+
+	// Möller-Trumbore, two-sided, the reference every traversal is held to
+	bool hitTriangle(const Triangle& triangle, const Vec3& origin, const Vec3& direction, float& t) {
+		const Vec3 e1 = triangle.b - triangle.a, e2 = triangle.c - triangle.a;
+		const Vec3 p = direction.cross(e2);
+		const float det = e1.dot(p);
+		if (std::fabs(det) < 1e-20f) return false;
+
+		const float invDet = 1.0f / det;
+		const Vec3 s = origin - triangle.a;
+		const float u = s.dot(p) * invDet;
+		if (u < 0.0f || u > 1.0f) return false;
+
+		const Vec3 q = s.cross(e1);
+		const float v = direction.dot(q) * invDet;
+		if (v < 0.0f || u + v > 1.0f) return false;
+
+		t = e2.dot(q) * invDet;
+		return t >= 0.0f;
+	}
+
+	// Nearest triangle in [0, maxDistance], -1 when none
+	int bruteNearest(const std::vector<Triangle>& triangles, const Ray& ray, float& nearest) {
+		int found = -1;
+		nearest = ray.maxDistance;
+		for (size_t i = 0; i < triangles.size(); ++i) {
+			float t;
+			if (hitTriangle(triangles[i], ray.origin, ray.direction, t) && t <= nearest) {
+				nearest = t;
+				found = static_cast<int>(i);
+			}
+		}
+		return found;
+	}
+
+	bool near(const float a, const float b) { return std::fabs(a - b) <= 1e-4f * std::max(1.0f, std::fabs(b)); }
+
+	// Small random triangles through a box with a few large ones across it, as an indexed mesh
+	void buildSoup(MeshCPU& mesh, std::vector<Triangle>& triangles) {
+		Random random(11);
+		for (uint32_t i = 0; i < 3000; ++i) {
+			const Vec3 centre = random.point(1.0f);
+			const float size = (i % 500 == 0) ? 1.5f : 0.08f;
+			triangles.push_back({ centre + random.point(size), centre + random.point(size), centre + random.point(size) });
+		}
+
+		for (const Triangle& triangle : triangles) {
+			for (const Vec3& corner : { triangle.a, triangle.b, triangle.c }) {
+				mesh.indices.push_back(static_cast<unsigned int>(mesh.vertices.size()));
+				Math::Vertex vertex{};
+				vertex.pos = corner;
+				mesh.vertices.push_back(vertex);
+			}
+		}
+		mesh.numVertices = static_cast<unsigned int>(mesh.vertices.size());
+		mesh.numIndices = static_cast<unsigned int>(mesh.indices.size());
+		mesh.numTriangles = mesh.numIndices / 3;
+	}
+
+	// Rays from outside and inside the box, axis-aligned ones with zero direction components, unnormalised lengths
+	// and finite limits that cut some hits off
+	std::vector<Ray> buildRays() {
+		Random random(5);
+		std::vector<Ray> rays;
+		for (uint32_t i = 0; i < 1500; ++i) {
+			Ray ray;
+			ray.origin = (i % 3 == 0) ? random.point(0.8f) : random.point(1.0f).normalized() * 3.0f;
+			ray.direction = (random.point(1.0f) - ray.origin) * random.range(0.25f, 4.0f);
+			ray.maxDistance = (i % 4 == 0) ? random.range(0.05f, 1.0f) : NO_LIMIT;
+			rays.push_back(ray);
+		}
+		const Vec3 axes[] = { { 1.0f, 0.0f, 0.0f }, { 0.0f, -1.0f, 0.0f }, { 0.0f, 0.0f, 1.0f }, { 0.0f, 0.0f, -2.0f } };
+		for (uint32_t i = 0; i < 200; ++i) {
+			const Vec3& axis = axes[i % 4];
+			rays.push_back({ random.point(1.0f) - axis * 3.0f, axis, NO_LIMIT });
+		}
+		return rays;
+	}
+
+	// Returns the number of rays that hit, so callers can check the case is not trivially empty
+	uint32_t checkBvh(const MeshBvh& bvh, const std::vector<Triangle>& triangles, const std::vector<Ray>& rays) {
+		uint32_t hits = 0;
+		for (const Ray& ray : rays) {
+			float expected;
+			const int nearest = bruteNearest(triangles, ray, expected);
+
+			BvhHit hit;
+			const bool found = bvh.intersect(ray.origin, ray.direction, ray.maxDistance, hit);
+			CHECK(found == (nearest >= 0));
+			CHECK(bvh.occluded(ray.origin, ray.direction, ray.maxDistance) == (nearest >= 0));
+			if (!found || nearest < 0) continue;
+			++hits;
+
+			// Ties may pick either triangle, the one reported must be hit at the reported distance
+			CHECK(near(hit.distance, expected));
+			CHECK(hit.triangle < triangles.size());
+			float t;
+			CHECK(hitTriangle(triangles[hit.triangle], ray.origin, ray.direction, t) && near(t, hit.distance));
+			CHECK(hit.u >= 0.0f && hit.v >= 0.0f && hit.u + hit.v <= 1.0f + 1e-5f);
+
+			const Triangle& triangle = triangles[hit.triangle];
+			const Vec3 normal = (triangle.b - triangle.a).cross(triangle.c - triangle.a);
+			CHECK(near(hit.normal.x, normal.x) && near(hit.normal.y, normal.y) && near(hit.normal.z, normal.z));
+		}
+		return hits;
+	}
+
+	// Serial and job-system builds, each traced with the SSE slab test and the scalar one (both scalar without SSE)
+	void bvhMatchesBruteForce() {
+		MeshCPU mesh;
+		std::vector<Triangle> triangles;
+		buildSoup(mesh, triangles);
+		const std::vector<Ray> rays = buildRays();
+
+		JobSystem jobs;
+		CHECK(jobs.init(3));
+		BvhSettings settings;
+		settings.parallelThreshold = 64;
+
+		MeshBvh serial, parallel;
+		CHECK(serial.build(mesh, nullptr, settings));
+		CHECK(parallel.build(mesh, &jobs, settings));
+		CHECK(serial.getTriangleCount() == triangles.size() && parallel.getTriangleCount() == triangles.size());
+
+		for (MeshBvh* bvh : { &serial, &parallel }) {
+			const uint32_t hits = checkBvh(*bvh, triangles, rays);
+			CHECK(hits > rays.size() / 4 && hits < rays.size());
+
+			bvh->setScalarSlabs(true);
+			CHECK(checkBvh(*bvh, triangles, rays) == hits);
+			bvh->setScalarSlabs(false);
+		}
+	}
+
+	/* RayPicker */
+
+	// tests/assets/models/cube.ply with its quads fanned
+	const std::vector<Vec3> CUBE_CORNERS{
+		{ -0.5f, -0.5f, -0.5f }, { 0.5f, -0.5f, -0.5f }, { 0.5f, 0.5f, -0.5f }, { -0.5f, 0.5f, -0.5f },
+		{ -0.5f, -0.5f, 0.5f }, { 0.5f, -0.5f, 0.5f }, { 0.5f, 0.5f, 0.5f }, { -0.5f, 0.5f, 0.5f }
+	};
+	const uint32_t CUBE_FACES[6][4]{ { 0, 3, 2, 1 }, { 4, 5, 6, 7 }, { 0, 1, 5, 4 }, { 2, 3, 7, 6 }, { 1, 2, 6, 5 }, { 0, 4, 7, 3 } };
+
+	struct Instance {
+		Vec3 position, rotation, scale;
+		bool visible;
+	};
+
+	Vec3 transformPoint(const Math::Mat4& matrix, const Vec3& p) {
+		const float* m = matrix.models;
+		return { m[0] * p.x + m[4] * p.y + m[8] * p.z + m[12], m[1] * p.x + m[5] * p.y + m[9] * p.z + m[13], m[2] * p.x + m[6] * p.y + m[10] * p.z + m[14] };
+	}
+
+	// Every visible instance's cube in world space, with the row each triangle came from
+	void worldTriangles(const std::vector<Instance>& instances, std::vector<Triangle>& triangles, std::vector<size_t>& rows) {
+		for (size_t row = 0; row < instances.size(); ++row) {
+			if (!instances[row].visible) continue;
+			const Instance& instance = instances[row];
+			const Math::Mat4 model = Math::Mat4::modelMatrix({ { instance.position, 0.0f }, instance.rotation, instance.scale });
+			for (const auto& face : CUBE_FACES)
+				for (uint32_t corner = 1; corner < 3; ++corner) {
+					triangles.push_back({ transformPoint(model, CUBE_CORNERS[face[0]]), transformPoint(model, CUBE_CORNERS[face[corner]]), transformPoint(model, CUBE_CORNERS[face[corner + 1]]) });
+					rows.push_back(row);
+				}
+		}
+	}
+
+	// Scaled and rotated instances sharing one BVH, traced in model space and compared with world-space triangles
+	void pickerMatchesBruteForce() {
+		RecordingGL gl;
+		CHECK(gl.install());
+		gl.setRecording(false);
+
+		ResourceManager resources;
+		resources.setBasePath(STARLET_GRAPHICS_TEST_DIR "assets");
+		resources.setMeshBvhBuild(true);
+		Scene::Model cubeModel;
+		cubeModel.meshPath = "cube.ply";
+		CHECK(resources.loadMeshes({ &cubeModel }));
+		CHECK(resources.getMeshBvh(cubeModel.meshHandle) != nullptr);
+
+		const std::vector<Instance> instances{
+			{ { 0.0f, 0.0f, -5.0f }, { 0.0f, 0.0f, 0.0f }, { 1.0f, 1.0f, 1.0f }, true },
+			{ { 3.0f, 0.5f, -6.0f }, { 0.0f, 45.0f, 0.0f }, { 2.0f, 0.5f, 1.0f }, true },
+			{ { -3.0f, -1.0f, -7.0f }, { 30.0f, 60.0f, 15.0f }, { 1.5f, 1.5f, 1.5f }, true },
+			{ { 0.5f, 2.0f, -9.0f }, { -20.0f, 10.0f, 70.0f }, { 0.5f, 3.0f, 2.0f }, true },
+			{ { 0.0f, 0.0f, -3.0f }, { 0.0f, 0.0f, 0.0f }, { 1.0f, 1.0f, 1.0f }, false }, // Hidden in front of the first
+		};
+
+		RenderWorld world;
+		RenderModels& models = world.models;
+		models.resize(instances.size());
+		for (size_t row = 0; row < instances.size(); ++row) {
+			models.position[row] = instances[row].position;
+			models.rotation[row] = instances[row].rotation;
+			models.scale[row] = instances[row].scale;
+			models.mesh[row] = cubeModel.meshHandle;
+			models.flags[row] = instances[row].visible ? RENDER_MODEL_VISIBLE : 0;
+			models.version[row] = row + 1;
+		}
+
+		std::vector<Triangle> triangles;
+		std::vector<size_t> rows;
+		worldTriangles(instances, triangles, rows);
+
+		const RayPicker picker(resources);
+		Random random(9);
+		uint32_t hits = 0;
+		for (uint32_t i = 0; i < 2000; ++i) {
+			const Vec3 origin = (i % 2) ? Vec3{ 0.0f, 0.0f, 0.0f } : random.point(2.0f) + Vec3{ 0.0f, 0.0f, 2.0f };
+			const Vec3 target = random.point(4.0f) + Vec3{ 0.0f, 0.0f, -7.0f };
+			const Vec3 direction = (target - origin) * random.range(0.5f, 3.0f);
+			const Vec3 unit = direction.normalized();
+			const float maxDistance = (i % 5 == 0) ? random.range(2.0f, 8.0f) : NO_LIMIT;
+
+			float expected;
+			const int nearest = bruteNearest(triangles, { origin, unit, maxDistance }, expected);
+
+			RayHit hit;
+			const bool found = picker.raycast(world, origin, direction, hit, maxDistance);
+			CHECK(found == (nearest >= 0));
+			if (!found || nearest < 0) continue;
+			++hits;
+
+			CHECK(near(hit.distance, expected));
+			CHECK(near(hit.position.x, origin.x + unit.x * expected) && near(hit.position.y, origin.y + unit.y * expected) && near(hit.position.z, origin.z + unit.z * expected));
+
+			// Unit length, facing the ray and perpendicular to a world-space face of the reported row at that distance,
+			// ties along shared edges may report either face
+			CHECK(std::fabs(hit.normal.length() - 1.0f) < 1e-4f);
+			CHECK(hit.normal.dot(unit) <= 0.0f);
+			bool matched = false;
+			for (size_t triangle = 0; triangle < triangles.size() && !matched; ++triangle) {
+				float t;
+				if (rows[triangle] != hit.row || !hitTriangle(triangles[triangle], origin, unit, t) || !near(t, hit.distance)) continue;
+				const Triangle& face = triangles[triangle];
+				matched = std::fabs(hit.normal.dot((face.b - face.a).cross(face.c - face.a).normalized())) > 1.0f - 1e-3f;
+			}
+			CHECK(matched);
+
+			// A point short of the hit is visible from the origin, one past it is not
+			CHECK(picker.lineOfSight(world, origin, origin + unit * (expected * 0.9f)));
+			CHECK(!picker.lineOfSight(world, origin, origin + unit * (expected + 0.5f)));
+		}
+		CHECK(hits > 200 && hits < 2000);
+	}
+}
+
+int main() {
+	bvhMatchesBruteForce();
+	pickerMatchesBruteForce();
+	return 0;
+}
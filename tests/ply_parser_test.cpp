@@ -0,0 +1,113 @@
+#include "test_check.hpp"
+
+#include "starlet-graphics/jobs/job_system.hpp"
+#include "starlet-graphics/parser/ply_parser.hpp"
+#include "starlet-graphics/resource/mesh_cpu.hpp"
+
+#include "starlet-serializer/data/mesh_data.hpp"
+#include "starlet-serializer/parser/mesh_parser.hpp"
+
+#include <cmath>
+#include <string>
+#include <vector>
+
+using namespace Starlet;
+using namespace Starlet::Graphics;
+
+namespace {
+	const std::string MODELS{ STARLET_GRAPHICS_TEST_DIR "assets/models/" };
+
+	// Small enough that almost every row starts a chunk and most cuts land mid-row, then the default single chunk
+	constexpr size_t CHUNK_SIZES[] = { 1, 7, 29, PlyParser::DEFAULT_CHUNK_BYTES };
+
+	bool near(const float a, const float b) { return std::fabs(a - b) <= 1e-5f; }
+
+	bool sameVertex(const Math::Vertex& a, const Math::Vertex& b, const bool colours) {
+		return near(a.pos.x, b.pos.x) && near(a.pos.y, b.pos.y) && near(a.pos.z, b.pos.z)
+			&& near(a.norm.x, b.norm.x) && near(a.norm.y, b.norm.y) && near(a.norm.z, b.norm.z)
+			&& near(a.texCoord.x, b.texCoord.x) && near(a.texCoord.y, b.texCoord.y)
+			&& (!colours || (near(a.col.x, b.col.x) && near(a.col.y, b.col.y) && near(a.col.z, b.col.z) && near(a.col.w, b.col.w)));
+	}
+
+	void checkSameMesh(const MeshCPU& mesh, const std::vector<Math::Vertex>& vertices, const std::vector<unsigned int>& indices, const bool colours) {
+		CHECK(mesh.vertices.size() == vertices.size());
+		CHECK(mesh.indices == indices);
+		for (size_t i = 0; i < vertices.size() && i < mesh.vertices.size(); ++i) CHECK(sameVertex(mesh.vertices[i], vertices[i], colours));
+	}
+
+	// Every chunk size, inline and as jobs, gives what Serializer::MeshParser reads from the same file
+	void matchesSerializer(const std::string& file, const bool binary, JobSystem& jobs) {
+		Serializer::MeshParser serializer;
+		Serializer::MeshData expected;
+		CHECK(serializer.parse(MODELS + file, expected));
+
+		for (const size_t chunkBytes : CHUNK_SIZES) {
+			for (JobSystem* scheduler : { static_cast<JobSystem*>(nullptr), &jobs }) {
+				PlyParser parser;
+				parser.setChunkBytes(chunkBytes);
+				MeshCPU mesh;
+				CHECK(parser.parse(MODELS + file, mesh, scheduler));
+
+				CHECK(mesh.numVertices == expected.numVertices);
+				CHECK(mesh.numIndices == expected.numIndices);
+				CHECK(mesh.numTriangles == expected.numTriangles);
+				CHECK(mesh.hasNormals == expected.hasNormals);
+				CHECK(mesh.hasColours == expected.hasColours);
+				CHECK(mesh.hasTexCoords == expected.hasTexCoords);
+				CHECK(near(mesh.minY, expected.minY) && near(mesh.maxY, expected.maxY));
+				checkSameMesh(mesh, expected.vertices, expected.indices, expected.hasColours);
+
+				const PlyParseStats& stats = parser.getLastStats();
+				CHECK(stats.binary == binary);
+				CHECK(stats.vertices == expected.numVertices);
+				if (!binary && chunkBytes == 1) CHECK(stats.chunks >= stats.vertices + stats.faces);
+			}
+		}
+	}
+
+	// Blank, whitespace-only and carriage-return lines between rows are not rows
+	void blankLinesAreSkipped(JobSystem& jobs) {
+		PlyParser clean;
+		MeshCPU expected;
+		CHECK(clean.parse(MODELS + "ply_ascii.ply", expected));
+
+		for (const size_t chunkBytes : CHUNK_SIZES) {
+			for (JobSystem* scheduler : { static_cast<JobSystem*>(nullptr), &jobs }) {
+				PlyParser parser;
+				parser.setChunkBytes(chunkBytes);
+				MeshCPU mesh;
+				CHECK(parser.parse(MODELS + "ply_ascii_blank.ply", mesh, scheduler));
+				CHECK(mesh.numVertices == expected.numVertices && mesh.numIndices == expected.numIndices);
+				checkSameMesh(mesh, expected.vertices, expected.indices, true);
+			}
+		}
+	}
+
+	// Quads take the sequential fan pass, which has to find the first face row from whichever chunk holds it
+	void polygonsAreFanned(JobSystem& jobs) {
+		for (const size_t chunkBytes : CHUNK_SIZES) {
+			PlyParser parser;
+			parser.setChunkBytes(chunkBytes);
+			MeshCPU mesh;
+			CHECK(parser.parse(MODELS + "cube.ply", mesh, &jobs));
+			CHECK(mesh.numVertices == 8);
+			CHECK(mesh.numTriangles == 12 && mesh.indices.size() == 36);
+
+			const std::vector<unsigned int> firstFace{ 0, 3, 2, 0, 2, 1 };
+			CHECK(std::vector<unsigned int>(mesh.indices.begin(), mesh.indices.begin() + 6) == firstFace);
+			const std::vector<unsigned int> lastFace{ 0, 4, 7, 0, 7, 3 };
+			CHECK(std::vector<unsigned int>(mesh.indices.end() - 6, mesh.indices.end()) == lastFace);
+		}
+	}
+}
+
+int main() {
+	JobSystem jobs;
+	CHECK(jobs.init(3));
+
+	matchesSerializer("ply_ascii.ply", false, jobs);
+	matchesSerializer("ply_binary.ply", true, jobs);
+	blankLinesAreSkipped(jobs);
+	polygonsAreFanned(jobs);
+	return 0;
+}
@@ -0,0 +1,246 @@
+#include "test_check.hpp"
+
+#include "starlet-graphics/profiler/profiler.hpp"
+
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace Starlet::Graphics;
+
+namespace {
+	// Just enough JSON to read the trace back: objects, arrays, strings, numbers
+	struct Json {
+		enum class Type { Null, Number, String, Array, Object } type{ Type::Null };
+		double number{ 0.0 };
+		std::string string;
+		std::vector<Json> array;
+		std::map<std::string, Json> object;
+
+		const Json& operator[](const char* key) const {
+			static const Json missing;
+			const std::map<std::string, Json>::const_iterator it = object.find(key);
+			return it == object.end() ? missing : it->second;
+		}
+	};
+
+	class JsonParser {
+	public:
+		explicit JsonParser(const std::string& text) : text(text) {}
+
+		bool parse(Json& out) {
+			if (!value(out)) return false;
+			skipSpace();
+			return pos == text.size();
+		}
+
+	private:
+		const std::string& text;
+		size_t pos{ 0 };
+
+		void skipSpace() {
+			while (pos < text.size() && (text[pos] == ' ' || text[pos] == '\n' || text[pos] == '\t' || text[pos] == '\r')) ++pos;
+		}
+		bool expect(const char c) {
+			skipSpace();
+			if (pos >= text.size() || text[pos] != c) return false;
+			++pos;
+			return true;
+		}
+
+		bool value(Json& out) {
+			skipSpace();
+			if (pos >= text.size()) return false;
+			if (text[pos] == '{') return object(out);
+			if (text[pos] == '[') return array(out);
+			if (text[pos] == '"') {
+				out.type = Json::Type::String;
+				return string(out.string);
+			}
+			return number(out);
+		}
+
+		bool object(Json& out) {
+			out.type = Json::Type::Object;
+			++pos;
+			if (expect('}')) return true;
+			do {
+				std::string key;
+				skipSpace();
+				if (!string(key) || !expect(':') || !value(out.object[key])) return false;
+			} while (expect(','));
+			return expect('}');
+		}
+
+		bool array(Json& out) {
+			out.type = Json::Type::Array;
+			++pos;
+			if (expect(']')) return true;
+			do {
+				out.array.emplace_back();
+				if (!value(out.array.back())) return false;
+			} while (expect(','));
+			return expect(']');
+		}
+
+		bool string(std::string& out) {
+			if (pos >= text.size() || text[pos] != '"') return false;
+			for (++pos; pos < text.size(); ++pos) {
+				char c = text[pos];
+				if (c == '"') {
+					++pos;
+					return true;
+				}
+				if (static_cast<unsigned char>(c) < 0x20) return false;
+				if (c == '\\') {
+					if (++pos >= text.size()) return false;
+					switch (text[pos]) {
+					case '"': case '\\': case '/': c = text[pos]; break;
+					case 'n': c = '\n'; break;
+					case 't': c = '\t'; break;
+					case 'r': c = '\r'; break;
+					case 'u':
+						if (pos + 4 >= text.size()) return false;
+						c = static_cast<char>(std::stoi(text.substr(pos + 1, 4), nullptr, 16));
+						pos += 4;
+						break;
+					default: return false;
+					}
+				}
+				out += c;
+			}
+			return false;
+		}
+
+		bool number(Json& out) {
+			const char* begin = text.c_str() + pos;
+			char* end = nullptr;
+			out.number = std::strtod(begin, &end);
+			if (end == begin) return false;
+			out.type = Json::Type::Number;
+			pos += static_cast<size_t>(end - begin);
+			return true;
+		}
+	};
+
+	void spin() {
+		std::this_thread::sleep_for(std::chrono::microseconds(200));
+	}
+
+	// Nested scopes without a GL context, read back through the Chrome trace
+	void nestedScopes() {
+		Profiler profiler;
+		profiler.setEnabled(true);
+
+		// Outside a frame scopes are not recorded
+		{ ProfileScope ignored(profiler, "ignored"); }
+		CHECK(profiler.getEventCount() == 0);
+
+		profiler.beginFrame();
+		{
+			ProfileScope frame(profiler, "frame");
+			spin();
+			{
+				ProfileScope inner(profiler, "inner \"quoted\"");
+				spin();
+				{
+					ProfileScope leaf(profiler, "leaf");
+					spin();
+				}
+				spin();
+			}
+			{
+				ProfileScope second(profiler, "second");
+				spin();
+			}
+		}
+		profiler.endFrame();
+
+		CHECK(profiler.getEventCount() == 4);
+		CHECK(profiler.getCpuMs("leaf") > 0.0);
+		CHECK(profiler.getCpuMs("frame") >= profiler.getCpuMs("leaf"));
+		CHECK(profiler.getCpuMs("missing") == 0.0);
+		CHECK(profiler.getGpuMs("leaf") == 0.0);
+
+		Json trace;
+		CHECK(JsonParser(Profiler::toChromeTrace(profiler.getEvents())).parse(trace));
+		CHECK(trace.type == Json::Type::Object);
+		CHECK(trace["displayTimeUnit"].string == "ms");
+
+		const Json& events = trace["traceEvents"];
+		CHECK(events.type == Json::Type::Array);
+
+		std::vector<const Json*> scopes;
+		for (const Json& event : events.array) {
+			if (event["ph"].string == "M") continue;
+			CHECK(event["ph"].string == "X");
+			CHECK(event["tid"].number == 1.0);
+			CHECK(event["dur"].number >= 0.0);
+			CHECK(event["args"]["frame"].number == 1.0);
+			scopes.push_back(&event);
+		}
+		CHECK(scopes.size() == 4);
+
+		// Events are recorded in open order
+		const char* names[] = { "frame", "inner \"quoted\"", "leaf", "second" };
+		const double depths[] = { 0.0, 1.0, 2.0, 1.0 };
+		const int parents[] = { -1, 0, 1, 0 };
+		for (size_t i = 0; i < scopes.size(); ++i) {
+			const Json& scope = *scopes[i];
+			CHECK(scope["name"].string == names[i]);
+			CHECK(scope["args"]["depth"].number == depths[i]);
+			if (parents[i] < 0) continue;
+
+			const Json& parent = *scopes[parents[i]];
+			CHECK(scope["ts"].number >= parent["ts"].number);
+			CHECK(scope["ts"].number + scope["dur"].number <= parent["ts"].number + parent["dur"].number);
+		}
+
+		// Siblings do not overlap
+		const Json& inner = *scopes[1];
+		CHECK((*scopes[3])["ts"].number >= inner["ts"].number + inner["dur"].number);
+	}
+
+	// The event ring keeps the newest events once full
+	void eventRing() {
+		Profiler profiler;
+		profiler.setEnabled(true);
+		profiler.setMaxEvents(3);
+
+		for (int i = 0; i < 5; ++i) {
+			profiler.beginFrame();
+			{ ProfileScope scope(profiler, "pass"); }
+			profiler.endFrame();
+		}
+		CHECK(profiler.getEventCount() == 3);
+		CHECK(profiler.getEvent(0).frame == 3);
+		CHECK(profiler.getEvent(2).frame == 5);
+
+		profiler.setMaxEvents(2);
+		CHECK(profiler.getEventCount() == 2);
+		CHECK(profiler.getEvent(0).frame == 4);
+		CHECK(profiler.getEvent(1).frame == 5);
+
+		// Unclosed scopes are closed at the end of the frame
+		profiler.beginFrame();
+		profiler.beginScope("open");
+		profiler.endFrame();
+		CHECK(profiler.getEventCount() == 2);
+		CHECK(std::strcmp(profiler.getEvent(1).name, "open") == 0);
+		CHECK(profiler.getEvent(1).cpuEndUs >= profiler.getEvent(1).cpuBeginUs);
+
+		profiler.clearEvents();
+		CHECK(profiler.getEventCount() == 0);
+		CHECK(Profiler::toChromeTrace(profiler.getEvents()).find("\"ph\":\"X\"") == std::string::npos);
+	}
+}
+
+int main() {
+	nestedScopes();
+	eventRing();
+	return 0;
+}
@@ -0,0 +1,133 @@
+#include "test_check.hpp"
+
+#include "starlet-graphics/backend/recording_gl.hpp"
+#include "starlet-graphics/backend/synthetic_scene.hpp"
+#include "starlet-graphics/jobs/job_system.hpp"
+#include "starlet-graphics/manager/resource_manager.hpp"
+#include "starlet-graphics/manager/shader_manager.hpp"
+#include "starlet-graphics/renderer/renderer.hpp"
+#include "starlet-graphics/renderer/render_world.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <string>
+#include <thread>
+
+using namespace Starlet::Graphics;
+
+namespace {
+	struct BenchCase {
+		uint32_t models, lights, textures;
+	};
+
+	// Renders a synthetic scene with RecordingGL as a null backend, so the numbers are the CPU cost of a frame
+	FrameBenchResult run(const BenchCase& sceneCase, const uint32_t frames, JobSystem* jobs) {
+		RecordingGL gl;
+		CHECK(gl.install());
+		gl.setRecording(false);
+
+		ResourceManager resources;
+		ShaderManager shaders;
+		shaders.setBasePath(STARLET_GRAPHICS_TEST_DIR "assets/");
+		CHECK(shaders.createProgramFromPaths("model", "shaders/basic.vert", "shaders/basic.frag"));
+		const unsigned int program = shaders.getProgramID("model");
+
+		SyntheticSceneSettings settings;
+		settings.models = sceneCase.models;
+		settings.lights = sceneCase.lights;
+		settings.textures = sceneCase.textures;
+		RenderWorld world;
+		CHECK(buildSyntheticScene(resources, settings, world));
+		CHECK(world.models.size() == sceneCase.models);
+		CHECK(world.lights.size() == sceneCase.lights);
+
+		Renderer renderer(resources);
+		CHECK(renderer.init(program));
+		renderer.setJobSystem(jobs);
+		renderer.setLightCulling(true);
+
+		// Warm the caches so the timed frames are steady state
+		renderer.renderFrame(program, world, 16.0f / 9.0f);
+		const FrameBenchResult result = gl.benchmark([&]() { renderer.renderFrame(program, world, 16.0f / 9.0f); }, frames);
+
+		// Every model lies inside the frustum, so each one is drawn
+		CHECK(renderer.getFrameStats().drawCalls == sceneCase.models);
+		CHECK(result.drawsPerFrame == static_cast<double>(sceneCase.models));
+		return result;
+	}
+
+	// Best FrameStats::prepareMs over the frames, the parallel prepare phase alone
+	double prepareMs(const uint32_t models, const uint32_t frames, JobSystem* jobs) {
+		RecordingGL gl;
+		CHECK(gl.install());
+		gl.setRecording(false);
+
+		ResourceManager resources;
+		ShaderManager shaders;
+		shaders.setBasePath(STARLET_GRAPHICS_TEST_DIR "assets/");
+		CHECK(shaders.createProgramFromPaths("model", "shaders/basic.vert", "shaders/basic.frag"));
+		const unsigned int program = shaders.getProgramID("model");
+
+		SyntheticSceneSettings settings;
+		settings.models = models;
+		settings.lights = 8;
+		settings.textures = 4;
+		RenderWorld world;
+		CHECK(buildSyntheticScene(resources, settings, world));
+
+		Renderer renderer(resources);
+		CHECK(renderer.init(program));
+		renderer.setJobSystem(jobs);
+
+		renderer.renderFrame(program, world, 16.0f / 9.0f);
+		double best = 0.0;
+		for (uint32_t i = 0; i < frames; ++i) {
+			renderer.renderFrame(program, world, 16.0f / 9.0f);
+			best = (i == 0) ? renderer.getFrameStats().prepareMs : std::min(best, renderer.getFrameStats().prepareMs);
+		}
+		return best;
+	}
+
+	// Prepare time against worker count, from the inline path up to at least four workers
+	void benchPrepare() {
+		const unsigned int hardware = std::max(1u, std::thread::hardware_concurrency());
+		const unsigned int maxWorkers = std::max(4u, hardware);
+		for (const uint32_t models : { 10000u, 50000u }) {
+			const double serial = prepareMs(models, 30, nullptr);
+			std::printf("%6u models prepare: inline %.3f ms\n", models, serial);
+			for (unsigned int workers = 1; workers <= maxWorkers; workers *= 2) {
+				JobSystem jobs;
+				CHECK(jobs.init(workers));
+				const double parallel = prepareMs(models, 30, &jobs);
+				std::printf("%6u models prepare: %2u workers %.3f ms, speedup %.2fx\n", models, workers, parallel, parallel > 0.0 ? serial / parallel : 0.0);
+			}
+		}
+	}
+
+	void print(const BenchCase& sceneCase, const unsigned int workers, const FrameBenchResult& result) {
+		std::printf("%6u models %4u lights %3u textures %2u workers: mean %.3f ms, min %.3f ms, max %.3f ms, %.0f GL calls, %.0f draws\n",
+			sceneCase.models, sceneCase.lights, sceneCase.textures, workers, result.meanMs, result.minMs, result.maxMs, result.callsPerFrame, result.drawsPerFrame);
+	}
+}
+
+// Pass --bench to time a range of synthetic scenes with and without the job system, then the prepare phase per worker count
+int main(int argc, char** argv) {
+	const bool bench = argc > 1 && std::string(argv[1]) == "--bench";
+
+	if (!bench) {
+		// Small enough to run with every test, still checks the builder and the driver end to end
+		run({ 64, 8, 4 }, 3, nullptr);
+		return 0;
+	}
+
+	const BenchCase cases[] = { { 100, 8, 4 }, { 1000, 32, 16 }, { 10000, 128, 64 } };
+	for (const BenchCase& sceneCase : cases) print(sceneCase, 1, run(sceneCase, 30, nullptr));
+
+	JobSystem jobs;
+	CHECK(jobs.init());
+	for (const BenchCase& sceneCase : cases) print(sceneCase, jobs.getWorkerCount(), run(sceneCase, 30, &jobs));
+	jobs.shutdown();
+
+	benchPrepare();
+	return 0;
+}
@@ -0,0 +1,144 @@
+#include "test_check.hpp"
+
+#include "starlet-graphics/backend/recording_gl.hpp"
+#include "starlet-graphics/manager/resource_manager.hpp"
+#include "starlet-graphics/manager/shader_manager.hpp"
+#include "starlet-graphics/renderer/renderer.hpp"
+#include "starlet-graphics/renderer/render_world.hpp"
+
+#include "starlet-scene/component/model.hpp"
+
+#include <glad/glad.h>
+
+#include <string>
+
+using namespace Starlet;
+using namespace Starlet::Graphics;
+
+namespace {
+	constexpr const char* GOLDEN{ STARLET_GRAPHICS_TEST_DIR "golden/render_frame.txt" };
+
+	void addModel(RenderWorld& world, const std::string& name, const ResourceHandle mesh, const Math::Vec3<float>& position, const Math::Vec4<float>& colour, const uint8_t flags) {
+		RenderModels& models = world.models;
+		const size_t row = models.size();
+		models.resize(row + 1);
+
+		models.entity[row] = static_cast<Scene::Entity>(row);
+		models.name[row] = name;
+		models.position[row] = position;
+		models.rotation[row] = { 0.0f, 45.0f, 0.0f };
+		models.scale[row] = { 1.0f, 1.0f, 1.0f };
+		models.colour[row] = colour;
+		models.specular[row] = { 1.0f, 1.0f, 1.0f, 32.0f };
+		models.mesh[row] = mesh;
+		models.seed[row] = { 0.25f, 0.5f, 0.75f };
+		models.flags[row] = flags;
+		models.colourMode[row] = 0;
+		models.version[row] = row + 1;
+	}
+
+	size_t countDepthFuncs(const RecordingGL& gl, const GLenum func) {
+		size_t count = 0;
+		for (const GLCommand& command : gl.getCommands())
+			if (command.name == "glDepthFunc" && !command.args.empty() && command.args[0] == static_cast<int64_t>(func)) ++count;
+		return count;
+	}
+
+	// Camera at the origin looking down -z at an opaque cube, a transparent one, a hidden one and one behind the camera
+	void buildWorld(RenderWorld& world, const ResourceHandle cube) {
+		world.camera.valid = true;
+		world.camera.position = { 0.0f, 0.0f, 0.0f };
+		world.camera.rotation = { 0.0f, -90.0f, 0.0f };
+		world.camera.fov = 60.0f;
+		world.camera.nearPlane = 0.1f;
+		world.camera.farPlane = 100.0f;
+		world.ambient = { 0.2f, 0.2f, 0.2f, 1.0f };
+
+		addModel(world, "opaque", cube, { 0.0f, 0.0f, -5.0f }, { 1.0f, 0.0f, 0.0f, 1.0f }, RENDER_MODEL_VISIBLE | RENDER_MODEL_LIT);
+		addModel(world, "glass", cube, { 1.0f, 0.0f, -3.0f }, { 0.0f, 0.0f, 1.0f, 0.5f }, RENDER_MODEL_VISIBLE | RENDER_MODEL_LIT);
+		addModel(world, "hidden", cube, { -1.0f, 0.0f, -4.0f }, { 0.0f, 1.0f, 0.0f, 1.0f }, 0);
+		addModel(world, "behind", cube, { 0.0f, 0.0f, 5.0f }, { 1.0f, 1.0f, 0.0f, 1.0f }, RENDER_MODEL_VISIBLE);
+
+		RenderLights& lights = world.lights;
+		lights.resize(1);
+		lights.position[0] = { 0.0f, 4.0f, -4.0f, 1.0f };
+		lights.direction[0] = { 0.0f, -1.0f, 0.0f, 0.0f };
+		lights.diffuse[0] = { 1.0f, 1.0f, 1.0f, 1.0f };
+		lights.attenuation[0] = { 1.0f, 0.09f, 0.032f, 0.0f };
+		lights.param1[0] = { 0.0f, 0.0f, 0.0f, 0.0f };
+		lights.active[0] = 1;
+		lights.version[0] = 1;
+	}
+}
+
+// Renders a fixed world under RecordingGL and compares the second frame's command stream with the checked in golden.
+// Pass --update to rewrite the golden after an intended change to the draw path.
+int main(int argc, char** argv) {
+	const bool update = argc > 1 && std::string(argv[1]) == "--update";
+
+	RecordingGL gl;
+	CHECK(gl.install());
+	// Uniform payloads come from starlet-math, the golden pins call order, enums, object names and counts
+	gl.setCaptureValues(false);
+
+	ResourceManager resources;
+	resources.setBasePath(STARLET_GRAPHICS_TEST_DIR "assets");
+	resources.setFastPlyParsing(true);
+
+	Scene::Model cubeModel;
+	cubeModel.meshPath = "cube.ply";
+	CHECK(resources.loadMeshes({ &cubeModel }));
+	CHECK(cubeModel.meshHandle.isValid());
+
+	ShaderManager shaders;
+	shaders.setBasePath(STARLET_GRAPHICS_TEST_DIR "assets/");
+	CHECK(shaders.createProgramFromPaths("model", "shaders/basic.vert", "shaders/basic.frag"));
+	const unsigned int program = shaders.getProgramID("model");
+	CHECK(program != 0);
+
+	Renderer renderer(resources);
+	CHECK(renderer.init(program));
+	renderer.setStatsHistory(8);
+
+	RenderWorld world;
+	buildWorld(world, cubeModel.meshHandle);
+
+	// The first frame fills the uniform and state caches, the second is the steady state
+	renderer.renderFrame(program, world, 16.0f / 9.0f);
+	gl.clear();
+	renderer.renderFrame(program, world, 16.0f / 9.0f);
+
+	// The cube behind the camera fails the frustum test, the hidden one is dropped by its flags
+	CHECK(gl.getDrawCount() == renderer.getFrameStats().drawCalls);
+	CHECK(renderer.getFrameStats().drawCalls == 2);
+	CHECK(renderer.getFrameStats().culledModels == 2);
+	CHECK(gl.matchesGolden(GOLDEN, update));
+
+	// Without a camera nothing is drawn, the frame still restores state and lands in the history
+	world.camera.valid = false;
+	gl.clear();
+	renderer.renderFrame(program, world, 16.0f / 9.0f);
+	CHECK(gl.getDrawCount() == 0);
+	CHECK(gl.getCallCount("glDepthMask") == 1);
+	CHECK(renderer.getFrameStats().drawCalls == 0);
+	CHECK(renderer.getStatsHistory().size() == 3);
+
+	// With the pre-pass on, a model program built before it is shaded with GL_LEQUAL, one built after gets
+	// invariant gl_Position injected and the exact GL_EQUAL test
+	world.camera.valid = true;
+	CHECK(renderer.enableDepthPrepass(shaders));
+	CHECK(!shaders.hasInvariantPosition(program));
+	gl.clear();
+	renderer.renderFrame(program, world, 16.0f / 9.0f);
+	CHECK(countDepthFuncs(gl, GL_EQUAL) == 0);
+	CHECK(countDepthFuncs(gl, GL_LEQUAL) > 0);
+
+	CHECK(shaders.createProgramFromPaths("model", "shaders/basic.vert", "shaders/basic.frag"));
+	const unsigned int invariantProgram = shaders.getProgramID("model");
+	CHECK(shaders.hasInvariantPosition(invariantProgram));
+	CHECK(renderer.init(invariantProgram));
+	gl.clear();
+	renderer.renderFrame(invariantProgram, world, 16.0f / 9.0f);
+	CHECK(countDepthFuncs(gl, GL_EQUAL) == 1);
+	return 0;
+}
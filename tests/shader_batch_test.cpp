@@ -0,0 +1,119 @@
+#include "test_check.hpp"
+
+#include "starlet-graphics/backend/recording_gl.hpp"
+#include "starlet-graphics/manager/shader_manager.hpp"
+
+#include <glad/glad.h>
+
+using namespace Starlet::Graphics;
+
+namespace {
+	constexpr const char* VERT{ "shaders/basic.vert" };
+	constexpr const char* FRAG{ "shaders/basic.frag" };
+
+	size_t countProgramQueries(const RecordingGL& gl, const GLenum pname) {
+		size_t count = 0;
+		for (const GLCommand& command : gl.getCommands())
+			if (command.name == "glGetProgramiv" && command.args.size() == 2 && command.args[1] == pname) ++count;
+		return count;
+	}
+
+	// Without the extension every program is complete as soon as it is polled
+	void serialFallback() {
+		RecordingGL gl;
+		CHECK(gl.install());
+
+		ShaderManager shaders;
+		shaders.setBasePath(STARLET_GRAPHICS_TEST_DIR "assets/");
+		CHECK(!shaders.enableParallelCompile());
+
+		CHECK(shaders.pollProgram("basic") == ProgramState::Missing);
+		CHECK(shaders.submitProgramFromPaths("basic", VERT, FRAG));
+		CHECK(shaders.getPendingCount() == 1);
+		CHECK(shaders.getProgramID("basic") == 0);
+
+		CHECK(shaders.pollProgram("basic") == ProgramState::Ready);
+		CHECK(shaders.getPendingCount() == 0);
+		CHECK(shaders.getProgramID("basic") != 0);
+		CHECK(countProgramQueries(gl, GL_COMPLETION_STATUS_KHR) == 0);
+	}
+
+	// Programs stay Pending while the driver reports them incomplete and link status is only read once they finish
+	void pendingUntilComplete() {
+		RecordingGL gl;
+		CHECK(gl.install());
+		gl.addExtension("GL_KHR_parallel_shader_compile");
+
+		ShaderManager shaders;
+		shaders.setBasePath(STARLET_GRAPHICS_TEST_DIR "assets/");
+		CHECK(shaders.enableParallelCompile());
+
+		gl.setBuildStatus(true, true, false);
+		CHECK(shaders.submitProgramFromPaths("a", VERT, FRAG));
+		CHECK(shaders.submitProgramFromPaths("b", VERT, FRAG));
+		CHECK(shaders.getPendingCount() == 2);
+
+		gl.clear();
+		CHECK(shaders.pollProgram("a") == ProgramState::Pending);
+		CHECK(shaders.pollPendingPrograms() == 2);
+		CHECK(shaders.getProgramID("a") == 0 && shaders.getProgramID("b") == 0);
+		CHECK(countProgramQueries(gl, GL_COMPLETION_STATUS_KHR) == 3);
+		CHECK(countProgramQueries(gl, GL_LINK_STATUS) == 0);
+		CHECK(gl.getCallCount("glGetShaderiv") == 0);
+
+		gl.setBuildStatus(true, true, true);
+		CHECK(shaders.pollProgram("a") == ProgramState::Ready);
+		CHECK(shaders.getPendingCount() == 1);
+		CHECK(shaders.pollPendingPrograms() == 0);
+		CHECK(shaders.pollProgram("b") == ProgramState::Ready);
+		CHECK(shaders.getProgramID("a") != 0 && shaders.getProgramID("b") != 0);
+		CHECK(shaders.getProgramID("a") != shaders.getProgramID("b"));
+		CHECK(countProgramQueries(gl, GL_LINK_STATUS) == 2);
+	}
+
+	// A link failure surfaces as Failed once the program completes, finishPendingPrograms reports it
+	void failedLink() {
+		RecordingGL gl;
+		CHECK(gl.install());
+		gl.addExtension("GL_KHR_parallel_shader_compile");
+
+		ShaderManager shaders;
+		shaders.setBasePath(STARLET_GRAPHICS_TEST_DIR "assets/");
+		CHECK(shaders.enableParallelCompile());
+
+		gl.setBuildStatus(true, false, false);
+		CHECK(shaders.submitProgramFromPaths("good", VERT, FRAG));
+		CHECK(shaders.pollProgram("good") == ProgramState::Pending);
+
+		CHECK(!shaders.finishPendingPrograms());
+		CHECK(shaders.getPendingCount() == 0);
+		CHECK(shaders.pollProgram("good") == ProgramState::Failed);
+		CHECK(shaders.getProgramID("good") == 0);
+		CHECK(gl.getCallCount("glDeleteProgram") == 1);
+
+		// Resubmitting clears the failure
+		gl.setBuildStatus(true, true, true);
+		CHECK(shaders.submitProgramFromPaths("good", VERT, FRAG));
+		CHECK(shaders.pollProgram("good") == ProgramState::Ready);
+	}
+
+	// A missing source file fails at submit without reaching GL
+	void missingSource() {
+		RecordingGL gl;
+		CHECK(gl.install());
+
+		ShaderManager shaders;
+		shaders.setBasePath(STARLET_GRAPHICS_TEST_DIR "assets/");
+		CHECK(!shaders.submitProgramFromPaths("missing", "shaders/none.vert", FRAG));
+		CHECK(shaders.pollProgram("missing") == ProgramState::Failed);
+		CHECK(gl.getCallCount("glCreateShader") == 0);
+	}
+}
+
+int main() {
+	serialFallback();
+	pendingUntilComplete();
+	failedLink();
+	missingSource();
+	return 0;
+}
@@ -0,0 +1,110 @@
+#include "test_check.hpp"
+
+#include "starlet-graphics/culling/software_occlusion.hpp"
+
+#include "starlet-math/mat4.hpp"
+
+#include <cmath>
+#include <vector>
+
+using namespace Starlet::Graphics;
+
+namespace {
+	constexpr uint32_t SIZE{ 64 };
+
+	// Camera at the origin looking down -z with a 90 degree square frustum, so screen x = (x / -z * 0.5 + 0.5) * SIZE
+	ViewFrustum makeFrustum() {
+		ViewFrustum frustum;
+		frustum.view.eye = { 0.0f, 0.0f, 0.0f };
+		frustum.view.front = { 0.0f, 0.0f, -1.0f };
+		frustum.view.right = { 1.0f, 0.0f, 0.0f };
+		frustum.view.up = { 0.0f, 1.0f, 0.0f };
+		frustum.tanHalfX = frustum.tanHalfY = 1.0f;
+		frustum.nearPlane = 0.1f;
+		frustum.farPlane = 100.0f;
+		return frustum;
+	}
+
+	Starlet::Math::Mat4 identity() {
+		Starlet::Math::Mat4 matrix;
+		for (int i = 0; i < 16; ++i) matrix.models[i] = (i % 5 == 0) ? 1.0f : 0.0f;
+		return matrix;
+	}
+
+	// World x at the given depth that projects to screen column x
+	float worldX(const float screenX, const float distance) {
+		return (screenX / SIZE - 0.5f) * 2.0f * distance;
+	}
+
+	// A quad at distance 5 whose left edge lands at screen x 25.3, inside pixel 25 but left of its centre
+	void setup(SoftwareOcclusion& occlusion) {
+		occlusion.setResolution(SIZE, SIZE);
+		const std::vector<Starlet::Math::Vec3<float>> quad{
+			{ worldX(25.3f, 5.0f), -1.5f, -5.0f }, { 2.0f, -1.5f, -5.0f }, { 2.0f, 1.5f, -5.0f }, { worldX(25.3f, 5.0f), 1.5f, -5.0f }
+		};
+		occlusion.setOccluderMesh(1, quad, { 0, 1, 2, 0, 2, 3 });
+
+		occlusion.beginFrame(makeFrustum());
+		occlusion.addOccluder(1, identity());
+		occlusion.rasterize(nullptr);
+	}
+
+	bool boxVisible(const SoftwareOcclusion& occlusion, const float screenLeft, const float screenRight, const float distance) {
+		return occlusion.isVisible({ worldX(screenLeft, distance), -1.0f, -distance - 0.5f }, { worldX(screenRight, distance), 1.0f, -distance }, identity());
+	}
+
+	// Pixel 25's centre is covered but most of the pixel is not, so it must stay empty
+	void partialPixelsAreNotOccluding() {
+		SoftwareOcclusion occlusion;
+		setup(occlusion);
+
+		const std::vector<float>& depth = occlusion.getDepth();
+		const size_t row = static_cast<size_t>(SIZE / 2) * SIZE;
+		CHECK(depth[row + 25] == 0.0f);
+		CHECK(depth[row + 26] > 0.0f);
+		CHECK(occlusion.getStats().occluderTriangles == 2);
+
+		// Peeks out from behind the left edge within pixel 25
+		CHECK(boxVisible(occlusion, 25.1f, 30.0f, 10.0f));
+		// Entirely behind fully covered pixels
+		CHECK(!boxVisible(occlusion, 26.5f, 30.0f, 10.0f));
+		// In front of the occluder
+		CHECK(boxVisible(occlusion, 26.5f, 30.0f, 3.0f));
+	}
+
+	// Stored depth is the farthest over each pixel, not the value at its centre
+	void tiltedOccluderUsesFarthestDepth() {
+		SoftwareOcclusion occlusion;
+		occlusion.setResolution(SIZE, SIZE);
+
+		// Distance d = 6 + x / 2, so across the screen 1/d = (1 - ndcX / 2) / 6 and the far side of a pixel is its right edge
+		const std::vector<Starlet::Math::Vec3<float>> slope{
+			{ -4.0f, -4.0f, -4.0f }, { 4.0f, -4.0f, -8.0f }, { 4.0f, 4.0f, -8.0f }, { -4.0f, 4.0f, -4.0f }
+		};
+		occlusion.setOccluderMesh(2, slope, { 0, 1, 2, 0, 2, 3 });
+		occlusion.beginFrame(makeFrustum());
+		occlusion.addOccluder(2, identity());
+		occlusion.rasterize(nullptr);
+
+		const std::vector<float>& depth = occlusion.getDepth();
+		const size_t row = static_cast<size_t>(SIZE / 2) * SIZE;
+		uint32_t written = 0;
+		for (uint32_t x = 0; x < SIZE; ++x) {
+			const float stored = depth[row + x];
+			if (stored == 0.0f) continue;
+			++written;
+
+			const float rightNdc = (static_cast<float>(x + 1) / SIZE - 0.5f) * 2.0f;
+			const float centreNdc = (static_cast<float>(x) + 0.5f) / SIZE * 2.0f - 1.0f;
+			CHECK(std::fabs(stored - (1.0f - rightNdc * 0.5f) / 6.0f) < 1e-5f);
+			CHECK(stored < (1.0f - centreNdc * 0.5f) / 6.0f);
+		}
+		CHECK(written > SIZE / 2);
+	}
+}
+
+int main() {
+	partialPixelsAreNotOccluding();
+	tiltedOccluderUsesFarthestDepth();
+	return 0;
+}
@@ -0,0 +1,176 @@
+#include "test_check.hpp"
+
+#include "starlet-graphics/backend/recording_gl.hpp"
+#include "starlet-graphics/streaming/staging_ring.hpp"
+#include "starlet-graphics/streaming/staging_uploader.hpp"
+
+#include <set>
+#include <vector>
+
+using namespace Starlet::Graphics;
+
+namespace {
+	constexpr uint64_t CAPACITY{ 1024 };
+
+	// Fences signal in insertion order, either when the test says so or when the ring waits on one
+	class FakeFences : public FenceSource {
+	public:
+		uint64_t insert() override {
+			live.insert(next);
+			return next++;
+		}
+		bool isSignaled(uint64_t fence) override { return fence <= signaled; }
+		void wait(uint64_t fence) override {
+			waits.push_back(fence);
+			if (fence > signaled) signaled = fence;
+		}
+		void release(uint64_t fence) override {
+			CHECK(live.erase(fence) == 1);
+		}
+
+		void signalAll() { signaled = next - 1; }
+
+		uint64_t next{ 1 };
+		uint64_t signaled{ 0 };
+		std::vector<uint64_t> waits;
+		std::set<uint64_t> live;
+	};
+
+	StagingAllocation submitted(StagingRing& ring, const uint64_t size) {
+		StagingAllocation allocation;
+		CHECK(ring.tryAllocate(size, 16, allocation));
+		ring.markSubmitted(allocation);
+		ring.retire();
+		return allocation;
+	}
+
+	void offsetsRespectAlignment() {
+		FakeFences fences;
+		StagingRing ring(fences);
+		ring.reset(CAPACITY);
+
+		const uint64_t alignments[] = { 1, 4, 16, 64, 256, 3 };
+		uint64_t previousEnd = 0;
+		for (const uint64_t alignment : alignments) {
+			StagingAllocation allocation;
+			CHECK(ring.tryAllocate(10, alignment, allocation));
+			CHECK(allocation.offset % alignment == 0);
+			CHECK(allocation.offset >= previousEnd);
+			CHECK(allocation.size == 10);
+			previousEnd = allocation.offset + allocation.size;
+		}
+
+		StagingAllocation tooLarge, empty;
+		CHECK(!ring.tryAllocate(CAPACITY + 1, 16, tooLarge));
+		CHECK(!ring.tryAllocate(0, 16, empty));
+	}
+
+	// An allocation that does not fit before the end skips to the start and waits for exactly the fences covering it
+	void wrapWaitsForTheRightFence() {
+		FakeFences fences;
+		StagingRing ring(fences);
+		ring.reset(CAPACITY);
+
+		const StagingAllocation a = submitted(ring, 400);
+		const StagingAllocation b = submitted(ring, 400);
+		CHECK(a.offset == 0 && b.offset == 400);
+		CHECK(ring.getFencesInFlight() == 2);
+
+		// 224 bytes of padding to the end plus 300 needs a's 400 bytes back, not b's
+		StagingAllocation c;
+		CHECK(!ring.tryAllocate(300, 16, c));
+		CHECK(ring.allocate(300, 16, c));
+		CHECK(c.offset == 0);
+		CHECK(fences.waits.size() == 1 && fences.waits[0] == 1);
+		CHECK(ring.getFencesInFlight() == 1);
+		ring.markSubmitted(c);
+		ring.retire();
+
+		// The next one wraps within the buffer and now needs b and c's fences as well
+		StagingAllocation d;
+		CHECK(ring.allocate(900, 16, d));
+		CHECK(d.offset == 0);
+		CHECK(fences.waits.size() == 3 && fences.waits[1] == 2 && fences.waits[2] == 3);
+		CHECK(ring.getUsed() <= CAPACITY);
+	}
+
+	// Unsubmitted space cannot be fenced, so a cancelled allocation must unblock the ones after it
+	void cancelReturnsSpace() {
+		FakeFences fences;
+		StagingRing ring(fences);
+		ring.reset(CAPACITY);
+
+		StagingAllocation abandoned;
+		CHECK(ring.tryAllocate(600, 16, abandoned));
+		submitted(ring, 300);
+		CHECK(ring.getFencesInFlight() == 0);
+
+		StagingAllocation blocked;
+		CHECK(!ring.allocate(200, 16, blocked));
+
+		ring.markSubmitted(abandoned);
+		ring.retire();
+		CHECK(ring.getFencesInFlight() == 1);
+		fences.signalAll();
+		ring.reclaim();
+		CHECK(ring.getUsed() == 0);
+
+		// An idle ring restarts at the buffer start, so almost the whole capacity fits again
+		StagingAllocation large;
+		CHECK(ring.tryAllocate(CAPACITY - 16, 16, large));
+		CHECK(large.offset == 0);
+	}
+
+	// Every fence inserted is released once, by reclaim or by reset
+	void fencesAreReleased() {
+		FakeFences fences;
+		StagingRing ring(fences);
+		ring.reset(CAPACITY);
+
+		for (int i = 0; i < 20; ++i) {
+			submitted(ring, 200);
+			fences.signalAll();
+			ring.reclaim();
+		}
+		CHECK(fences.live.empty());
+		CHECK(fences.next == 21);
+
+		submitted(ring, 200);
+		submitted(ring, 200);
+		CHECK(fences.live.size() == 2);
+		ring.reset(CAPACITY);
+		CHECK(fences.live.empty());
+		CHECK(ring.getUsed() == 0);
+	}
+
+	// The uploader's cancel on staged data that is never copied
+	void uploaderCancel() {
+		RecordingGL gl;
+		CHECK(gl.install());
+
+		StagingUploader uploader;
+		CHECK(uploader.init(CAPACITY));
+
+		StagingAllocation allocation;
+		CHECK(uploader.stage(600, allocation) != nullptr);
+		CHECK(allocation.offset % 16 == 0);
+		CHECK(uploader.getRing().getUsed() >= 600);
+
+		uploader.cancel(allocation);
+		uploader.flush();
+		CHECK(uploader.getRing().getUsed() == 0);
+		CHECK(gl.getCallCount("glCopyBufferSubData") == 0);
+
+		CHECK(uploader.stage(CAPACITY - 16, allocation) != nullptr);
+		uploader.shutdown();
+	}
+}
+
+int main() {
+	offsetsRespectAlignment();
+	wrapWaitsForTheRightFence();
+	cancelReturnsSpace();
+	fencesAreReleased();
+	uploaderCancel();
+	return 0;
+}